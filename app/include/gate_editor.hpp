@@ -8,6 +8,7 @@
 #include <graphics/grid.hpp>
 #include <graphics/window.hpp>
 #include <systems/layout_system.hpp>
+#include <systems/preview_router.hpp>
 #include <systems/render_system.hpp>
 
 #include <imgui.h>
@@ -31,6 +32,8 @@ private:
     graphics::Grid m_grid;
     EditorState m_editor_state;
     LayoutSystem m_layout_system;
+    // Routes the wiring preview off the UI thread.
+    PreviewRouter m_preview_router;
     RenderSystem m_render_system;
     select_mode::SelectModeHandler m_select_handler;
 
@@ -43,12 +46,26 @@ private:
     float m_palette_width = 220.f;
     bool m_canvas_hovered = false;
 
+    // Result of the last File > Open, Save or Export, shown in the menu bar.
+    std::string m_file_status;
+
+    // Register the relations the editor queries on m_world.
+    void index_relations();
+
+    // Write / replace the design with io::save_binary / io::load_binary.
+    void save_design(const std::string& path);
+    void open_design(const std::string& path);
+
     // Create a primitive gate module with ports
     Entity create_gate(const std::string& type, GridCoord grid_pos);
 
     // Delete entity and its children (ports)
     void delete_entity(Entity entity);
 
+    // Write the design with io::export_verilog / io::export_blif.
+    template <typename ExportFunc>
+    void export_netlist(const std::string& path, ExportFunc&& export_func);
+
     // Snap pixel position to nearest grid
     GridCoord snap_to_grid(glm::vec2 pixel_pos) const;
 
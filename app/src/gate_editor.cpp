@@ -2,6 +2,9 @@
 #include <components/components.hpp>
 #include <components/render_components.hpp>
 
+#include <io/design_binary.hpp>
+#include <io/netlist_export.hpp>
+
 #include <imgui.h>
 #include <glm/glm.hpp>
 #include <optional>
@@ -54,13 +57,25 @@ static const GateTemplate* find_template(const std::string& name) {
     return nullptr;
 }
 
-static void begin_top_menu_bar() {
-    if (!ImGui::BeginMainMenuBar()) return;
+enum class MenuAction {
+    None,
+    Open,
+    Save,
+    ExportVerilog,
+    ExportBlif,
+};
+
+static MenuAction begin_top_menu_bar(const std::string& status) {
+    MenuAction action = MenuAction::None;
+    if (!ImGui::BeginMainMenuBar()) return action;
 
     if (ImGui::BeginMenu("File")) {
         ImGui::MenuItem("New");
-        ImGui::MenuItem("Open...");
-        ImGui::MenuItem("Save");
+        if (ImGui::MenuItem("Open (design.netra)")) action = MenuAction::Open;
+        if (ImGui::MenuItem("Save (design.netra)")) action = MenuAction::Save;
+        ImGui::Separator();
+        if (ImGui::MenuItem("Export Verilog (design.v)")) action = MenuAction::ExportVerilog;
+        if (ImGui::MenuItem("Export BLIF (design.blif)")) action = MenuAction::ExportBlif;
         ImGui::EndMenu();
     }
 
@@ -75,15 +90,62 @@ static void begin_top_menu_bar() {
         ImGui::EndMenu();
     }
 
+    if (!status.empty()) {
+        ImGui::Separator();
+        ImGui::TextUnformatted(status.c_str());
+    }
+
     ImGui::EndMainMenuBar();
+    return action;
 }
 
 GateEditor::GateEditor()
     : m_grid(10)
     , m_layout_system(m_world, m_grid)
-    , m_render_system(m_world, m_grid, m_editor_state)
+    , m_render_system(m_world, m_grid, m_editor_state, m_layout_system)
     , m_select_handler(m_world, m_grid,m_layout_system, m_canvas_mouse_pos)
-    {}
+    {
+        index_relations();
+    }
+
+void GateEditor::index_relations() {
+    // Reverse indices used by wire deletion and module deletion.
+    m_world.index_relation<&Port::connected_signal>();
+    m_world.index_relation<&Wire::from_endpoint>();
+    m_world.index_relation<&Wire::to_endpoint>();
+}
+
+void GateEditor::save_design(const std::string& path) {
+    auto result = io::save_binary(m_world, path);
+    m_file_status = result ? "Saved " + path : std::string("Save failed: ") + io::to_string(result.error());
+}
+
+void GateEditor::open_design(const std::string& path) {
+    auto loaded = io::load_binary(path);
+    if (!loaded) {
+        m_file_status = std::string("Open failed: ") + io::to_string(loaded.error());
+        return;
+    }
+    // Nothing may refer to the old design's entities past this point.
+    cancel_wire();
+    m_editor_state.mode = EditorMode::Select;
+    m_selected_entity = Entity{};
+    m_dragging_entity = Entity{};
+
+    // Systems hold m_world by reference, so replace its contents in place
+    // and let them pick up the new ones.
+    m_world = std::move(*loaded);
+    index_relations();
+    m_layout_system.rebuild_spatial_index();
+    m_render_system.rebind_shader_keys();
+    m_file_status = "Opened " + path;
+}
+
+template <typename ExportFunc>
+void GateEditor::export_netlist(const std::string& path, ExportFunc&& export_func) {
+    auto result = export_func(m_world, path, "top");
+    m_file_status = result ? "Exported " + path : "Export failed: " + result.error().message;
+}
 
 void GateEditor::init(const std::string& shader_dir) {
     m_render_system.init(shader_dir);
@@ -95,13 +157,13 @@ Entity GateEditor::create_gate(const std::string& type, GridCoord grid_pos) {
 
     // Create module definition entity (reusable, but for simplicity create one per instance)
     Entity def_entity = m_world.create();
-    m_world.emplace<ModuleDef>(def_entity, type, true);
+    m_world.emplace<ModuleDef>(def_entity, m_world.intern(type), true);
 
     // Create module instance entity
     Entity inst_entity = m_world.create();
-    m_world.emplace<ModuleInst>(inst_entity, type + "_inst", def_entity);
+    m_world.emplace<ModuleInst>(inst_entity, m_world.intern(type + "_inst"), def_entity);
     m_world.emplace<ModuleExtent>(inst_entity, tmpl->width, tmpl->height);
-    m_world.emplace<ShaderKey>(inst_entity, type);
+    m_world.emplace<ShaderKey>(inst_entity, m_world.intern(type));
 
     // Compute pixel position from grid
     float px = static_cast<float>(grid_pos.x * m_grid.unit_px());
@@ -112,7 +174,7 @@ Entity GateEditor::create_gate(const std::string& type, GridCoord grid_pos) {
     Hierarchy hier{Entity{}, {}};
     for (const auto& port_def : tmpl->ports) {
         Entity port_entity = m_world.create();
-        m_world.emplace<Port>(port_entity, port_def.name, port_def.dir, 1u, inst_entity, Entity{});
+        m_world.emplace<Port>(port_entity, m_world.intern(port_def.name), port_def.dir, 1u, inst_entity, Entity{});
         m_world.emplace<PortOffset>(port_entity, port_def.offset_x, port_def.offset_y);
         m_world.emplace<PortVisual>(port_entity, port_def.side);
         m_world.emplace<PortGridPosition>(port_entity, GridCoord{
@@ -122,6 +184,7 @@ Entity GateEditor::create_gate(const std::string& type, GridCoord grid_pos) {
         hier.children.push_back(port_entity);
     }
     m_world.emplace<Hierarchy>(inst_entity, Entity{}, std::move(hier.children));
+    m_layout_system.index_entity(inst_entity);
 
     return inst_entity;
 }
@@ -129,8 +192,22 @@ Entity GateEditor::create_gate(const std::string& type, GridCoord grid_pos) {
 void GateEditor::delete_entity(Entity entity) {
     if (!m_world.alive(entity)) return;
 
-    // Delete children (ports)
+    // Free its cells (and its ports') while the ports still point at it
+    m_layout_system.unindex_entity(entity);
+
+    // Delete children (ports) and the wires attached to them, otherwise the
+    // wires would keep dangling endpoint references.
     if (auto* hier = m_world.get<Hierarchy>(entity)) {
+        std::vector<Entity> attached_wires;
+        for (Entity child : hier->children) {
+            auto from = m_world.related<&Wire::from_endpoint>(child);
+            auto to = m_world.related<&Wire::to_endpoint>(child);
+            attached_wires.insert(attached_wires.end(), from.begin(), from.end());
+            attached_wires.insert(attached_wires.end(), to.begin(), to.end());
+        }
+        for (Entity wire : attached_wires) {
+            delete_wire(wire);
+        }
         for (Entity child : hier->children) {
             m_world.destroy(child);
         }
@@ -165,7 +242,22 @@ Entity GateEditor::get_port_on_side(Entity module, PortSide side) {
 }
 
 void GateEditor::draw(graphics::Window& window) {
-    begin_top_menu_bar();
+    switch (begin_top_menu_bar(m_file_status)) {
+    case MenuAction::Open:
+        open_design("design.netra");
+        break;
+    case MenuAction::Save:
+        save_design("design.netra");
+        break;
+    case MenuAction::ExportVerilog:
+        export_netlist("design.v", io::export_verilog);
+        break;
+    case MenuAction::ExportBlif:
+        export_netlist("design.blif", io::export_blif);
+        break;
+    case MenuAction::None:
+        break;
+    }
 
     const ImGuiViewport* vp = ImGui::GetMainViewport();
     const float menu_h = ImGui::GetFrameHeight();
@@ -262,17 +354,32 @@ void GateEditor::draw(graphics::Window& window) {
             case EditorMode::Wiring: {
                 m_editor_state.wiring.mouse_grid_pos = snap_to_grid(m_canvas_mouse_pos);
 
-                if (m_editor_state.wiring.active) {
-                    GridCoord start_pos{};
-                    if (!m_editor_state.wiring.points.empty()) {
-                        start_pos = m_editor_state.wiring.points.back();
-                        m_editor_state.wiring.current_path = m_layout_system.route_wire(start_pos, m_editor_state.wiring.mouse_grid_pos);
+                auto& wiring = m_editor_state.wiring;
+                if (wiring.active && !wiring.points.empty()) {
+                    // Routed in the background; show the newest finished
+                    // route from this start, even if the mouse moved since.
+                    const GridCoord start_pos = wiring.points.back();
+                    m_preview_router.request(start_pos, wiring.mouse_grid_pos,
+                                             m_layout_system.occupancy_snapshot(),
+                                             m_layout_system.index_version());
+                    if (auto result = m_preview_router.latest();
+                        result && result->start == start_pos &&
+                        result->version == m_layout_system.index_version()) {
+                        wiring.current_path = std::move(result->path);
+                    } else {
+                        wiring.current_path.clear();
                     }
                 }
 
                 if (ImGui::IsMouseClicked(ImGuiMouseButton_Left) && m_canvas_hovered) {
                     //We should commit the currently previewed wire segment
-                    GridCoord grid_pos = m_editor_state.wiring.mouse_grid_pos;
+                    GridCoord grid_pos = wiring.mouse_grid_pos;
+                    // The preview may trail the mouse; commit a route that
+                    // ends where the click landed.
+                    if (wiring.active && !wiring.points.empty() &&
+                        (wiring.current_path.empty() || !(wiring.current_path.back() == grid_pos))) {
+                        wiring.current_path = m_layout_system.preview_route(wiring.points.back(), grid_pos);
+                    }
                     handle_wiring_click(grid_pos);
                 }
                 break;
@@ -393,7 +500,7 @@ void GateEditor::handle_wiring_click(GridCoord grid_pos) {
 
             // Create or find signal for this wire
             Entity signal_entity = m_world.create();
-            m_world.emplace<Signal>(signal_entity, "wire_signal", 1u, Entity{}, std::vector<Entity>{});
+            m_world.emplace<Signal>(signal_entity, m_world.intern("wire_signal"), 1u, Entity{}, std::vector<Entity>{});
 
             Wire wire_comp{};
             wire_comp.signal = signal_entity;
@@ -408,20 +515,20 @@ void GateEditor::handle_wiring_click(GridCoord grid_pos) {
             if (sig) {
                 if (wiring.start_endpoint.valid() && m_world.has<Port>(wiring.start_endpoint)) {
                     sig->connected_ports.push_back(wiring.start_endpoint);
-                    if (auto* p = m_world.get<Port>(wiring.start_endpoint)) {
-                        p->connected_signal = signal_entity;
-                    }
+                    m_world.patch<Port>(wiring.start_endpoint, [&](Port& p) {
+                        p.connected_signal = signal_entity;
+                    });
                 }
                 if (endpoint.valid() && m_world.has<Port>(endpoint)) {
                     sig->connected_ports.push_back(endpoint);
-                    if (auto* p = m_world.get<Port>(endpoint)) {
-                        p->connected_signal = signal_entity;
-                    }
+                    m_world.patch<Port>(endpoint, [&](Port& p) {
+                        p.connected_signal = signal_entity;
+                    });
                 }
             }
 
-            // Explicitly update spatial index with new wire so we can't route through it immediately
-            m_layout_system.rebuild_spatial_index();
+            // Index the new wire so we can't route through it immediately
+            m_layout_system.index_entity(wire_entity);
 
             cancel_wire();
         }
@@ -442,10 +549,7 @@ void GateEditor::handle_wiring_escape() {
 
 
 Entity GateEditor::find_port_at(GridCoord grid_pos) {
-    std::optional<Entity> found = m_world.view<Port, PortGridPosition>().find_first(
-            [&grid_pos](Port&, PortGridPosition& pos){ return pos.position == grid_pos; }
-            );
-    return found.has_value() ? found.value() : Entity{};
+    return m_layout_system.port_at(grid_pos);
 }
 
 Entity GateEditor::find_wire_point_at(GridCoord grid_pos) {
@@ -461,16 +565,9 @@ Entity GateEditor::find_wire_point_at(GridCoord grid_pos) {
     // That's complex. Let's stick to Ports for now as per "strict validation".
     // But handle_wiring_click calls it. Let's implement basics.
 
-    Entity found = Entity{};
-    m_world.view<Wire>().each([&](Entity e, Wire& wire) {
-        for (const auto& pt : wire.points) {
-            if (pt == grid_pos) {
-                found = e; // Return the wire entity
-                return;
-            }
-        }
-    });
-    return found;
+    // Return the wire entity; the spatial index knows every wire through the cell
+    const std::vector<Entity> wires = m_layout_system.wires_at(grid_pos);
+    return wires.empty() ? Entity{} : wires.front();
 }
 
 bool GateEditor::is_valid_wire_endpoint(Entity endpoint) const {
@@ -503,22 +600,19 @@ void GateEditor::delete_wire(Entity wire) {
         Entity sig_entity = w->signal;
         if (m_world.alive(sig_entity)) {
              m_world.destroy(sig_entity);
-             // Note: ports connected to this signal need update?
-             // Since signal is destroyed, port->connected_signal becomes invalid or should be cleared.
-             // We should iterate ports? Or rely on weak ref?
-             // System cleanup would be better, but here:
-             m_world.view<Port>().each([&](Entity, Port& p) {
-                 if (p.connected_signal == sig_entity) {
-                     p.connected_signal = Entity{};
-                 }
-             });
+             // Clear the ports still pointing at the destroyed signal. Copy
+             // first: patch() edits the index the span points into.
+             auto connected = m_world.related<&Port::connected_signal>(sig_entity);
+             std::vector<Entity> ports(connected.begin(), connected.end());
+             for (Entity port : ports) {
+                 m_world.patch<Port>(port, [](Port& p) { p.connected_signal = Entity{}; });
+             }
         }
     }
+    // Free the wire's cells in the spatial index
+    m_layout_system.unindex_entity(wire);
     m_world.destroy(wire);
 
-    // Refresh spatial index
-    m_layout_system.rebuild_spatial_index();
-
     if (m_selected_entity == wire) m_selected_entity = Entity{};
 }
 
@@ -1,20 +1,20 @@
 #include <components/components.hpp>
 #include <components/render_components.hpp>
+#include <cmath>
 #include <optional>
 #include <select_mode.hpp>
 
 
 namespace netra::app::select_mode {
 std::optional<Entity> SelectModeHandler::handleMouseClick(){
-    std::optional<Entity> selected_entity = m_world.view<ModulePixelPosition, ModuleExtent>()
-        .find_first(
-            [this](Entity e, const ModulePixelPosition& pos, const ModuleExtent& ext) {
-                float w = static_cast<float>(ext.width * m_grid.unit_px());
-                float h = static_cast<float>(ext.height * m_grid.unit_px());
-                return (m_canvas_mouse_pos.x >= pos.x && m_canvas_mouse_pos.x <= pos.x + w &&
-                        m_canvas_mouse_pos.y >= pos.y && m_canvas_mouse_pos.y <= pos.y + h);
-            }
-    );
+    // The module whose body covers the grid cell under the mouse
+    const float unit = static_cast<float>(m_grid.unit_px());
+    const Entity hit = m_layout_system.module_at(GridCoord{
+        static_cast<std::int32_t>(std::floor(m_canvas_mouse_pos.x / unit)),
+        static_cast<std::int32_t>(std::floor(m_canvas_mouse_pos.y / unit))
+    });
+    std::optional<Entity> selected_entity;
+    if (hit.valid()) selected_entity = hit;
     if(selected_entity.has_value()) {
         info = DragInfo{.entity = selected_entity.value()};
         if(auto const* pos = m_world.get<ModulePixelPosition>(selected_entity.value())) {
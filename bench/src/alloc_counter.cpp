@@ -0,0 +1,63 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Each block carries its size in a max_align_t-sized prefix so operator
+// delete can subtract it again. Over-aligned allocations keep the default
+// implementation and are not counted.
+
+namespace {
+
+std::atomic<std::size_t> g_live_bytes{0};
+
+constexpr std::size_t k_prefix = alignof(std::max_align_t);
+
+void* allocate(std::size_t size) {
+    void* block = std::malloc(size + k_prefix);
+    if (!block)
+        throw std::bad_alloc();
+    std::memcpy(block, &size, sizeof(size));
+    g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+    return static_cast<std::byte*>(block) + k_prefix;
+}
+
+void deallocate(void* pointer) noexcept {
+    if (!pointer)
+        return;
+    std::byte* block = static_cast<std::byte*>(pointer) - k_prefix;
+    std::size_t size = 0;
+    std::memcpy(&size, block, sizeof(size));
+    g_live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void* allocate_nothrow(std::size_t size) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+} // namespace
+
+namespace bench {
+
+std::size_t live_bytes() { return g_live_bytes.load(std::memory_order_relaxed); }
+
+} // namespace bench
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate_nothrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate_nothrow(size); }
+
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer); }
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bench {
+
+// Bytes currently allocated through global operator new in this process.
+// alloc_counter.cpp replaces the global allocation functions to keep the
+// count, so only the benchmark binary links it.
+std::size_t live_bytes();
+
+} // namespace bench
@@ -0,0 +1,213 @@
+#include "alloc_counter.hpp"
+#include "bench_framework.hpp"
+
+#include <core/component_storage.hpp>
+#include <core/world.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace netra;
+
+namespace {
+
+// Four distinct 8-byte components, like the editor's position/extent types.
+template <int I>
+struct Comp {
+    float a = 0.0f;
+    float b = 0.0f;
+};
+using C1 = Comp<1>;
+using C2 = Comp<2>;
+using C3 = Comp<3>;
+using C4 = Comp<4>;
+
+// Random-access batches are capped so large worlds measure access cost,
+// not the cost of walking a huge index array.
+constexpr std::size_t k_max_batch = 1 << 16;
+
+std::vector<EntityID> random_ids(std::size_t n, std::size_t count, std::uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<EntityID> ids(std::min(count, k_max_batch));
+    for (auto& id : ids)
+        id = static_cast<EntityID>(rng() % n);
+    return ids;
+}
+
+std::string sized(const std::string& name, std::size_t n) {
+    return "ecs/" + name + "/n=" + std::to_string(n);
+}
+
+// n entities; C1 on all of them, C2..C4 on the first `overlap` fraction of
+// a shuffled order, so views see interleaved hits and misses.
+struct Population {
+    World world;
+    std::vector<Entity> entities;
+    double bytes_per_entity = 0.0;
+
+    Population(std::size_t n, double overlap) {
+        const std::size_t before = bench::live_bytes();
+        entities = world.create_many(n);
+        world.emplace_many<C1>(entities, C1{1.0f, 2.0f});
+        std::vector<Entity> shuffled = entities;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+        shuffled.resize(static_cast<std::size_t>(static_cast<double>(n) * overlap));
+        std::sort(shuffled.begin(), shuffled.end(),
+                  [](Entity x, Entity y) { return x.id() < y.id(); });
+        world.emplace_many<C2>(shuffled, C2{});
+        world.emplace_many<C3>(shuffled, C3{});
+        world.emplace_many<C4>(shuffled, C4{});
+        bytes_per_entity = static_cast<double>(bench::live_bytes() - before) / static_cast<double>(n);
+    }
+};
+
+void storage_benchmarks(bench::Context& ctx, std::size_t n) {
+    if (ctx.enabled(sized("storage/insert", n))) {
+        std::size_t bytes = 0;
+        auto& result = ctx.measure(sized("storage/insert", n), n, [&] {
+            const std::size_t before = bench::live_bytes();
+            ComponentStorage<C1> storage;
+            for (std::size_t i = 0; i < n; ++i)
+                storage.insert(static_cast<EntityID>(i), C1{});
+            bytes = bench::live_bytes() - before;
+            bench::keep(storage.size());
+        });
+        result.counter("bytes_per_entity", static_cast<double>(bytes) / static_cast<double>(n));
+    }
+
+    ComponentStorage<C1> storage;
+    for (std::size_t i = 0; i < n; ++i)
+        storage.insert(static_cast<EntityID>(i), C1{static_cast<float>(i), 0.0f});
+
+    if (ctx.enabled(sized("storage/get_random", n))) {
+        const auto ids = random_ids(n, n, 1);
+        ctx.measure(sized("storage/get_random", n), ids.size(), [&] {
+            float sum = 0.0f;
+            for (EntityID id : ids)
+                sum += storage.get(id)->a;
+            bench::keep(sum);
+        });
+    }
+    if (ctx.enabled(sized("storage/remove_insert", n))) {
+        const auto ids = random_ids(n, n, 2);
+        ctx.measure(sized("storage/remove_insert", n), 2 * ids.size(), [&] {
+            for (EntityID id : ids) {
+                storage.remove(id);
+                storage.insert(id, C1{});
+            }
+        });
+    }
+    if (ctx.enabled(sized("storage/each", n))) {
+        ctx.measure(sized("storage/each", n), n, [&] {
+            float sum = 0.0f;
+            storage.each([&](Entity, C1& c) { sum += c.a; });
+            bench::keep(sum);
+        });
+    }
+}
+
+void world_benchmarks(bench::Context& ctx, std::size_t n) {
+    Population pop(n, 1.0);
+    World& world = pop.world;
+
+    if (ctx.enabled(sized("world/create_destroy", n))) {
+        // Steady-state churn: destroy a batch, then recreate it from the
+        // free list.
+        std::vector<Entity> batch;
+        for (EntityID id : random_ids(n, n / 4, 3))
+            batch.push_back(Entity(id));
+        std::sort(batch.begin(), batch.end(), [](Entity x, Entity y) { return x.id() < y.id(); });
+        batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+        auto& result = ctx.measure(sized("world/create_destroy", n), 2 * batch.size(), [&] {
+            for (Entity e : batch)
+                world.destroy(e);
+            for (Entity& e : batch) {
+                e = world.create();
+                world.emplace<C1>(e, C1{});
+            }
+        });
+        result.counter("bytes_per_entity", pop.bytes_per_entity);
+    }
+    if (ctx.enabled(sized("world/emplace_remove", n))) {
+        const auto ids = random_ids(n, n, 4);
+        ctx.measure(sized("world/emplace_remove", n), 2 * ids.size(), [&] {
+            for (EntityID id : ids) {
+                world.emplace<C2>(Entity(id), C2{});
+                world.remove<C2>(Entity(id));
+            }
+        });
+    }
+    if (ctx.enabled(sized("world/get_random", n))) {
+        const auto ids = random_ids(n, n, 5);
+        ctx.measure(sized("world/get_random", n), ids.size(), [&] {
+            float sum = 0.0f;
+            for (EntityID id : ids)
+                if (const C1* c = world.get<C1>(Entity(id)))
+                    sum += c->a;
+            bench::keep(sum);
+        });
+    }
+    if (ctx.enabled(sized("world/find_first", n))) {
+        // Worst case: only the last entity in dense order matches.
+        const Entity last(world.get_storage<C1>()->entities().back());
+        world.get<C1>(last)->b = -1.0f;
+        ctx.measure(sized("world/find_first", n), world.get_storage<C1>()->size(), [&] {
+            bench::keep(world.view<C1>().find_first([](const C1& c) { return c.b < 0.0f; }));
+        });
+        world.get<C1>(last)->b = 2.0f;
+    }
+}
+
+// view<C1..Ck>::each where C2..C4 cover `overlap` of the C1 entities.
+// ns/op is per entity of the leading (C1) storage.
+void view_benchmarks(bench::Context& ctx, std::size_t n) {
+    for (int percent : {100, 50, 10}) {
+        const std::string suffix = "/overlap=" + std::to_string(percent);
+        auto name = [&](int components) {
+            return sized("world/view" + std::to_string(components), n) + suffix;
+        };
+        if (!ctx.enabled(name(1)) && !ctx.enabled(name(2)) && !ctx.enabled(name(3)) &&
+            !ctx.enabled(name(4)))
+            continue;
+
+        Population pop(n, percent / 100.0);
+        World& world = pop.world;
+        auto run = [&](int components, auto&& body) {
+            if (!ctx.enabled(name(components)))
+                return;
+            ctx.measure(name(components), n, body).counter("bytes_per_entity", pop.bytes_per_entity);
+        };
+        float sum = 0.0f;
+        run(1, [&] { world.view<C1>().each([&](Entity, C1& a) { sum += a.a; }); });
+        run(2, [&] { world.view<C1, C2>().each([&](Entity, C1& a, C2& b) { sum += a.a + b.a; }); });
+        run(3, [&] {
+            world.view<C1, C2, C3>().each(
+                [&](Entity, C1& a, C2& b, C3& c) { sum += a.a + b.a + c.a; });
+        });
+        run(4, [&] {
+            world.view<C1, C2, C3, C4>().each(
+                [&](Entity, C1& a, C2& b, C3& c, C4& d) { sum += a.a + b.a + c.a + d.a; });
+        });
+        bench::keep(sum);
+    }
+}
+
+} // namespace
+
+BENCH(ecs_storage) {
+    for (std::size_t n : ctx.sweep<std::size_t>({1'000, 100'000, 1'000'000, 10'000'000}))
+        storage_benchmarks(ctx, n);
+}
+
+BENCH(ecs_world) {
+    for (std::size_t n : ctx.sweep<std::size_t>({1'000, 100'000, 1'000'000, 10'000'000}))
+        world_benchmarks(ctx, n);
+}
+
+BENCH(ecs_view) {
+    for (std::size_t n : ctx.sweep<std::size_t>({1'000, 100'000, 1'000'000, 10'000'000}))
+        view_benchmarks(ctx, n);
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifndef NETRA_BENCH_BUILD_TYPE
+#define NETRA_BENCH_BUILD_TYPE "unknown"
+#endif
+
+namespace bench {
+
+// Command-line options shared by every benchmark.
+struct Options {
+    std::string filter;    // run only cases whose name contains this
+    std::string json_path; // write results here when set
+    double min_time = 0.2; // seconds per timed batch
+    bool quick = false;    // smallest parameter of each sweep (smoke runs)
+};
+
+// One measured configuration, e.g. "sim/ripple_adder/bits=64/builtin".
+// `iterations` operations took `seconds`; counters carry derived metrics
+// (gates/sec, bytes/entity, ...).
+struct Case {
+    std::string name;
+    std::uint64_t iterations = 0;
+    double seconds = 0.0;
+    std::vector<std::pair<std::string, double>> counters;
+
+    double ns_per_op() const {
+        return iterations ? seconds * 1e9 / static_cast<double>(iterations) : 0.0;
+    }
+    double ops_per_second() const {
+        return seconds > 0.0 ? static_cast<double>(iterations) / seconds : 0.0;
+    }
+    void counter(std::string key, double value) {
+        counters.emplace_back(std::move(key), value);
+    }
+};
+
+class Context {
+public:
+    explicit Context(Options options) : m_options(std::move(options)) {}
+
+    const Options& options() const { return m_options; }
+
+    // Check before doing any setup for a case.
+    bool enabled(std::string_view name) const {
+        return name.find(m_options.filter) != std::string_view::npos;
+    }
+
+    // The values of a parameter sweep to run: all, or the first in quick mode.
+    template <typename T>
+    std::vector<T> sweep(std::initializer_list<T> values) const {
+        if (m_options.quick)
+            return {*values.begin()};
+        return values;
+    }
+
+    // Calls `op` in batches that double in size until one batch runs for at
+    // least min_time, and records that batch. `op` is one operation.
+    template <typename Op>
+    Case& measure(std::string name, Op&& op) {
+        return measure(std::move(name), 1, std::forward<Op>(op));
+    }
+
+    // As above for an `op` that performs `items` operations (a loop over a
+    // batch of ids, a full iteration, ...); ns/op is then per item.
+    template <typename Op>
+    Case& measure(std::string name, std::uint64_t items, Op&& op) {
+        using clock = std::chrono::steady_clock;
+        std::uint64_t batch = 1;
+        for (;;) {
+            const auto start = clock::now();
+            for (std::uint64_t i = 0; i < batch; ++i)
+                op();
+            const double seconds =
+                std::chrono::duration<double>(clock::now() - start).count();
+            if (seconds >= m_options.min_time || batch >= (1ull << 40))
+                return record(std::move(name), batch * items, seconds);
+            batch *= 2;
+        }
+    }
+
+    // For benchmarks that time themselves (e.g. per-query latencies).
+    Case& record(std::string name, std::uint64_t iterations, double seconds) {
+        m_cases.push_back(Case{std::move(name), iterations, seconds, {}});
+        return m_cases.back();
+    }
+
+    const std::vector<Case>& cases() const { return m_cases; }
+
+private:
+    Options m_options;
+    std::vector<Case> m_cases;
+};
+
+struct Benchmark {
+    std::string name;
+    std::function<void(Context&)> func;
+};
+
+inline std::vector<Benchmark>& get_benchmarks() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+inline int register_benchmark(const std::string& name, std::function<void(Context&)> func) {
+    get_benchmarks().push_back({name, std::move(func)});
+    return 0;
+}
+
+// Keeps `value` observable so the computation producing it is not elided.
+template <typename T>
+void keep(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+inline void print_case(const Case& c) {
+    std::cout << std::left << std::setw(56) << c.name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << c.ns_per_op() << " ns/op";
+    for (const auto& [key, value] : c.counters) {
+        std::cout << "  " << key << "=";
+        if (value == static_cast<double>(static_cast<long long>(value)))
+            std::cout << static_cast<long long>(value);
+        else
+            std::cout << std::setprecision(value < 100 ? 3 : 0) << value;
+    }
+    std::cout << std::defaultfloat << "\n";
+}
+
+inline void write_json_string(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+// {"build_type": ..., "min_time": ..., "benchmarks": [{"name", "iterations",
+//  "seconds", "ns_per_op", "counters": {...}}, ...]}; names are stable across
+// commits, so two files can be joined on "name".
+inline bool write_json(const std::string& path, const Context& ctx) {
+    std::ofstream out(path);
+    out << std::setprecision(9);
+    out << "{\n  \"build_type\": ";
+    write_json_string(out, NETRA_BENCH_BUILD_TYPE);
+    out << ",\n  \"min_time\": " << ctx.options().min_time << ",\n  \"benchmarks\": [";
+    const char* separator = "\n";
+    for (const auto& c : ctx.cases()) {
+        out << separator << "    {\"name\": ";
+        write_json_string(out, c.name);
+        out << ", \"iterations\": " << c.iterations << ", \"seconds\": " << c.seconds
+            << ", \"ns_per_op\": " << c.ns_per_op() << ", \"counters\": {";
+        const char* field_separator = "";
+        for (const auto& [key, value] : c.counters) {
+            out << field_separator;
+            write_json_string(out, key);
+            out << ": " << value;
+            field_separator = ", ";
+        }
+        out << "}}";
+        separator = ",\n";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+inline int run_all(const Options& options) {
+    Context ctx(options);
+    std::cout << "netra_bench (" << NETRA_BENCH_BUILD_TYPE << " build)\n";
+    for (const auto& benchmark : get_benchmarks()) {
+        const std::size_t first = ctx.cases().size();
+        try {
+            benchmark.func(ctx);
+        } catch (const std::exception& e) {
+            std::cout << benchmark.name << ": EXCEPTION: " << e.what() << "\n";
+            return 1;
+        }
+        for (std::size_t i = first; i < ctx.cases().size(); ++i)
+            print_case(ctx.cases()[i]);
+    }
+    if (!options.json_path.empty() && !write_json(options.json_path, ctx)) {
+        std::cerr << "could not write " << options.json_path << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+#define BENCH(name) \
+    static void bench_##name(bench::Context& ctx); \
+    static int _reg_##name = bench::register_benchmark(#name, bench_##name); \
+    static void bench_##name(bench::Context& ctx)
+
+} // namespace bench
@@ -0,0 +1,35 @@
+#include "bench_framework.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: netra_bench [--filter <substring>] [--json <path>]\n"
+                 "                   [--min-time <seconds>] [--quick]\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--filter" && has_value) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++i];
+        } else if (arg == "--min-time" && has_value) {
+            options.min_time = std::atof(argv[++i]);
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    return bench::run_all(options);
+}
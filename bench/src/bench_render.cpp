@@ -0,0 +1,207 @@
+// Window first: it includes GLAD ahead of GLFW.
+#include <graphics/window.hpp>
+
+#include "bench_framework.hpp"
+
+#include <components/components.hpp>
+#include <components/render_components.hpp>
+#include <editor_state.hpp>
+#include <graphics/grid.hpp>
+#include <systems/layout_system.hpp>
+#include <systems/render_system.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef NETRA_SHADER_DIR
+#define NETRA_SHADER_DIR "shaders/logic_gates"
+#endif
+
+using namespace netra;
+
+namespace {
+
+constexpr int k_window_width = 1280;
+constexpr int k_window_height = 720;
+constexpr graphics::Grid::unit_t k_unit_px = 10; // as in the editor
+
+// Editor gate templates: 20x16 cells, inputs at (0,4) and (0,12), output
+// at (20,8). Gates sit on a regular lattice with wiring channels between.
+constexpr std::int32_t k_width = 20;
+constexpr std::int32_t k_height = 16;
+constexpr std::int32_t k_pitch_x = 32;
+constexpr std::int32_t k_pitch_y = 24;
+constexpr std::int32_t k_reach = 4; // wires connect gates at most this many lattice steps apart
+
+constexpr auto k_gate_types =
+    std::to_array<std::string_view>({"AND", "NAND", "OR", "NOR", "XOR", "XNOR", "NOT"});
+
+struct Scene {
+    std::int32_t columns = 0;
+    std::int32_t rows = 0;
+};
+
+// `gates` gates and `wires` wires, each from a gate output to an input of a
+// nearby gate. Wires leave through the channel right of the driver, so
+// vertical runs cross the horizontal ones and the crossing arcs get drawn.
+Scene populate(World& world, std::size_t gates, std::size_t wires, std::mt19937& rng) {
+    Scene scene;
+    scene.columns = static_cast<std::int32_t>(std::ceil(std::sqrt(static_cast<double>(gates))));
+    scene.rows = static_cast<std::int32_t>((gates + scene.columns - 1) / scene.columns);
+
+    const Symbol a = world.intern("A");
+    const Symbol b = world.intern("B");
+    const Symbol y = world.intern("Y");
+    std::vector<std::array<Entity, 3>> ports; // A, B, Y per gate
+    ports.reserve(gates);
+    for (std::size_t i = 0; i < gates; ++i) {
+        const auto column = static_cast<std::int32_t>(i % scene.columns);
+        const auto row = static_cast<std::int32_t>(i / scene.columns);
+        const GridCoord origin{column * k_pitch_x, row * k_pitch_y};
+
+        const Entity inst = world.create();
+        world.emplace<ModuleInst>(inst, Symbol{}, Entity{});
+        world.emplace<ModuleExtent>(inst, k_width, k_height);
+        world.emplace<ShaderKey>(inst, world.intern(k_gate_types[i % k_gate_types.size()]));
+        world.emplace<ModulePixelPosition>(inst, static_cast<float>(origin.x * k_unit_px),
+                                           static_cast<float>(origin.y * k_unit_px));
+        auto port = [&](Symbol name, PortDirection direction, std::int32_t x, std::int32_t py) {
+            const Entity e = world.create();
+            world.emplace<Port>(e, name, direction, 1u, inst, Entity{});
+            world.emplace<PortOffset>(e, x, py);
+            world.emplace<PortGridPosition>(e, GridCoord{origin.x + x, origin.y + py});
+            return e;
+        };
+        ports.push_back({port(a, PortDirection::In, 0, 4), port(b, PortDirection::In, 0, 12),
+                         port(y, PortDirection::Out, k_width, 8)});
+    }
+
+    std::uniform_int_distribution<std::int32_t> step(-k_reach, k_reach);
+    std::uniform_int_distribution<std::int32_t> lane(1, k_pitch_x - k_width - 1);
+    for (std::size_t i = 0; i < wires; ++i) {
+        const std::size_t from = i % gates;
+        const auto column = std::clamp(static_cast<std::int32_t>(from % scene.columns) + step(rng), 0,
+                                       scene.columns - 1);
+        const auto row = std::clamp(static_cast<std::int32_t>(from / scene.columns) + step(rng), 0,
+                                    scene.rows - 1);
+        const std::size_t to =
+            std::min(static_cast<std::size_t>(row) * scene.columns + column, gates - 1);
+
+        const Entity out = ports[from][2];
+        const Entity in = ports[to][rng() % 2];
+        const GridCoord p1 = world.get<PortGridPosition>(out)->position;
+        const GridCoord p2 = world.get<PortGridPosition>(in)->position;
+
+        Wire wire{world.create(), out, in, {}};
+        if (p1.y != p2.y) {
+            const std::int32_t x = p1.x + lane(rng);
+            wire.points = {{x, p1.y}, {x, p2.y}};
+        }
+        world.emplace<Wire>(world.create(), std::move(wire));
+    }
+    return scene;
+}
+
+// FNV-1a over the RGBA back buffer. Only comparable between runs on the same
+// GL implementation: drivers differ in rasterization and blending details.
+std::uint32_t framebuffer_checksum(int width, int height) {
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+    glFinish();
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    std::uint32_t hash = 2166136261u;
+    for (std::uint8_t byte : pixels) {
+        hash ^= byte;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void render_benchmarks(bench::Context& ctx, const graphics::Window& window, std::size_t gates,
+                       std::size_t wires) {
+    const std::string suffix = "/gates=" + std::to_string(gates) + "/wires=" + std::to_string(wires);
+    const std::string fit_name = "render/fit" + suffix;
+    const std::string detail_name = "render/detail" + suffix;
+    if (!ctx.enabled(fit_name) && !ctx.enabled(detail_name))
+        return;
+
+    World world;
+    graphics::Grid grid(k_unit_px);
+    EditorState editor;
+    LayoutSystem layout(world, grid);
+    std::mt19937 rng(5);
+    const Scene scene = populate(world, gates, wires, rng);
+    // Index the placed wires: render_wires looks crossings up there.
+    layout.rebuild_spatial_index();
+
+    RenderSystem renderer(world, grid, editor, layout);
+    renderer.init(NETRA_SHADER_DIR);
+
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(window.handle(), &width, &height);
+    const glm::vec2 viewport{static_cast<float>(width), static_cast<float>(height)};
+
+    // Each frame is render() plus glFinish so queued GL work does not pile
+    // up across the batch; ns/op is the whole frame, cpu_us the render()
+    // call alone.
+    using clock = std::chrono::steady_clock;
+    auto run = [&](const std::string& name) {
+        double cpu_seconds = 0.0;
+        std::uint64_t frames = 0;
+        auto& result = ctx.measure(name, [&] {
+            const auto start = clock::now();
+            renderer.render(viewport);
+            cpu_seconds += std::chrono::duration<double>(clock::now() - start).count();
+            glFinish();
+            ++frames;
+        });
+        const RenderStats& stats = renderer.last_frame_stats();
+        result.counter("gates", static_cast<double>(gates));
+        result.counter("wires", static_cast<double>(wires));
+        result.counter("cpu_us", cpu_seconds * 1e6 / static_cast<double>(frames));
+        result.counter("draw_calls", static_cast<double>(stats.draw_calls));
+        result.counter("vertices", static_cast<double>(stats.vertices));
+        result.counter("program_binds", static_cast<double>(stats.program_binds));
+        result.counter("vao_binds", static_cast<double>(stats.vao_binds));
+        result.counter("uniform_sets", static_cast<double>(stats.uniform_sets));
+        result.counter("buffer_uploads", static_cast<double>(stats.buffer_uploads));
+        result.counter("uploaded_bytes", static_cast<double>(stats.uploaded_bytes));
+        result.counter("checksum", static_cast<double>(framebuffer_checksum(width, height)));
+    };
+
+    // Whole design on screen.
+    if (ctx.enabled(fit_name)) {
+        const auto design_w = static_cast<float>(scene.columns * k_pitch_x * k_unit_px);
+        const auto design_h = static_cast<float>(scene.rows * k_pitch_y * k_unit_px);
+        editor.camera.pan = {static_cast<float>(k_pitch_x * k_unit_px) * 0.5f, 0.0f};
+        editor.camera.zoom = std::min(viewport.x / design_w, viewport.y / design_h) * 0.9f;
+        run(fit_name);
+    }
+
+    // Editing zoom on one corner: most of the design is off screen.
+    if (ctx.enabled(detail_name)) {
+        editor.camera.pan = {0.0f, 0.0f};
+        editor.camera.zoom = 1.0f;
+        run(detail_name);
+    }
+}
+
+} // namespace
+
+// Needs a GL 4.3 context. Without a GPU, run under Xvfb with Mesa's software
+// rasterizer: LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a netra_render_bench
+BENCH(render) {
+    const graphics::Window window(k_window_width, k_window_height, "netra_render_bench", false);
+    const auto sizes = ctx.sweep<std::pair<std::size_t, std::size_t>>(
+        {{100, 100}, {1'000, 1'000}, {10'000, 10'000}});
+    for (const auto& [gates, wires] : sizes)
+        render_benchmarks(ctx, window, gates, wires);
+}
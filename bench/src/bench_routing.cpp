@@ -0,0 +1,315 @@
+#include "bench_framework.hpp"
+
+#include <components/components.hpp>
+#include <components/render_components.hpp>
+#include <core/astar.hpp>
+#include <core/thread_pool.hpp>
+#include <systems/autorouter.hpp>
+#include <graphics/grid.hpp>
+#include <systems/layout_system.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace netra;
+
+namespace {
+
+// Editor-sized gates (see the gate templates in the app). Inputs sit on
+// the left padding column and the output on the right one: cells inside a
+// module are blocked, so ports on the ring are the ones a wire can reach.
+constexpr std::int32_t k_width = 20;
+constexpr std::int32_t k_height = 16;
+constexpr std::int32_t k_gap = 3;      // free cells kept around each padded module
+constexpr double k_density = 0.3;      // fraction of the area covered by modules
+constexpr std::int32_t k_margin = 8;   // routable border around the placement area
+
+struct Placement {
+    std::vector<Entity> outputs;
+    std::vector<Entity> inputs;
+    std::int32_t side = 0; // placement area is [0, side)^2
+};
+
+Placement place_modules(World& world, const graphics::Grid& grid, std::size_t count,
+                        std::mt19937& rng) {
+    Placement placement;
+    const double cell_area = static_cast<double>((k_width + 2 + 2 * k_gap) * (k_height + 2 + 2 * k_gap));
+    placement.side = static_cast<std::int32_t>(std::ceil(std::sqrt(count * cell_area / k_density)));
+    const std::int32_t side = placement.side;
+
+    // Coarse occupancy of padded boxes plus the gap, for rejection sampling.
+    std::vector<bool> taken(static_cast<std::size_t>(side) * side, false);
+    const std::int32_t reach = 1 + k_gap;
+    auto fits = [&](std::int32_t ox, std::int32_t oy) {
+        for (std::int32_t y = oy - reach; y < oy + k_height + reach; ++y)
+            for (std::int32_t x = ox - reach; x < ox + k_width + reach; ++x)
+                if (taken[static_cast<std::size_t>(y) * side + x])
+                    return false;
+        return true;
+    };
+
+    const Symbol a = world.intern("A");
+    const Symbol b = world.intern("B");
+    const Symbol y = world.intern("Y");
+    std::uniform_int_distribution<std::int32_t> coord(reach, side - k_width - reach - 1);
+    for (std::size_t placed = 0, attempts = 0; placed < count && attempts < count * 100; ++attempts) {
+        const std::int32_t ox = coord(rng);
+        const std::int32_t oy = coord(rng);
+        if (!fits(ox, oy))
+            continue;
+        for (std::int32_t cy = oy - reach; cy < oy + k_height + reach; ++cy)
+            for (std::int32_t cx = ox - reach; cx < ox + k_width + reach; ++cx)
+                taken[static_cast<std::size_t>(cy) * side + cx] = true;
+
+        const Entity inst = world.create();
+        world.emplace<ModuleInst>(inst, Symbol{}, Entity{});
+        world.emplace<ModuleExtent>(inst, k_width, k_height);
+        world.emplace<ModulePixelPosition>(inst, static_cast<float>(ox * grid.unit_px()),
+                                           static_cast<float>(oy * grid.unit_px()));
+        auto port = [&](Symbol name, PortDirection direction, std::int32_t x, std::int32_t py) {
+            const Entity e = world.create();
+            world.emplace<Port>(e, name, direction, 1u, inst, Entity{});
+            world.emplace<PortOffset>(e, x, py);
+            return e;
+        };
+        placement.inputs.push_back(port(a, PortDirection::In, -1, 4));
+        placement.inputs.push_back(port(b, PortDirection::In, -1, 12));
+        placement.outputs.push_back(port(y, PortDirection::Out, k_width, 8));
+        ++placed;
+    }
+    return placement;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty())
+        return 0.0;
+    const auto index = static_cast<std::size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+void routing_benchmarks(bench::Context& ctx, std::size_t modules, std::size_t queries) {
+    const std::string suffix = "/modules=" + std::to_string(modules);
+    const std::string build_name = "route/build_index" + suffix;
+    const std::string move_name = "route/index_move_module" + suffix;
+    const std::string astar_name = "route/find_orthogonal_path" + suffix;
+    const std::string layout_name = "route/route_wire" + suffix;
+    const std::string jump_name = "route/route_wire_jumps" + suffix;
+    const std::string tiled_name = "route/route_wire_hierarchical" + suffix;
+    const std::string preview_name = "route/preview_route" + suffix;
+    if (!ctx.enabled(build_name) && !ctx.enabled(move_name) && !ctx.enabled(astar_name) && !ctx.enabled(layout_name) &&
+        !ctx.enabled(jump_name) && !ctx.enabled(tiled_name) && !ctx.enabled(preview_name))
+        return;
+
+    World world;
+    graphics::Grid grid;
+    std::mt19937 rng(11);
+    const Placement placement = place_modules(world, grid, modules, rng);
+    LayoutSystem layout(world, grid);
+    layout.update_all();
+
+    if (ctx.enabled(build_name))
+        ctx.measure(build_name, [&] { layout.rebuild_spatial_index(); });
+
+    // One module dropped a cell right and back again: the index update an
+    // editor drop costs, against the rebuild it used to take.
+    if (ctx.enabled(move_name)) {
+        const Entity anchor = placement.outputs.front();
+        const Entity module = world.get<Port>(anchor)->owner;
+        std::int32_t shift = 1;
+        ctx.measure(move_name, [&] {
+            world.get<PortGridPosition>(anchor)->position.x += shift;
+            layout.update_module_from_anchor(anchor, module);
+            shift = -shift;
+        });
+        layout.rebuild_spatial_index();
+    }
+
+    struct Query {
+        GridCoord start;
+        GridCoord end;
+    };
+    std::vector<Query> pairs;
+    std::uniform_int_distribution<std::size_t> pick_output(0, placement.outputs.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_input(0, placement.inputs.size() - 1);
+    while (pairs.size() < queries) {
+        const Entity from = placement.outputs[pick_output(rng)];
+        const Entity to = placement.inputs[pick_input(rng)];
+        if (world.get<Port>(from)->owner == world.get<Port>(to)->owner)
+            continue;
+        pairs.push_back({world.get<PortGridPosition>(from)->position,
+                         world.get<PortGridPosition>(to)->position});
+    }
+
+    // Cells outside the placement area plus a margin are blocked, so a
+    // search for an enclosed port fails instead of running unbounded.
+    const std::int32_t lo = -k_margin;
+    const std::int32_t hi = placement.side + k_margin;
+    auto bounded = [&](GridCoord p) {
+        return p.x < lo || p.y < lo || p.x > hi || p.y > hi || layout.is_cell_blocked(p);
+    };
+
+    using clock = std::chrono::steady_clock;
+    std::vector<bool> routed(pairs.size(), false);
+    std::vector<int> costs(pairs.size(), 0);
+    if (ctx.enabled(astar_name) || ctx.enabled(layout_name) || ctx.enabled(jump_name) ||
+        ctx.enabled(tiled_name)) {
+        std::vector<double> latencies;
+        std::size_t expanded = 0;
+        std::size_t failed = 0;
+        double total = 0.0;
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            PathSearchStats stats;
+            const auto start = clock::now();
+            const auto path = find_orthogonal_path(pairs[i].start, pairs[i].end, bounded, &stats);
+            const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+            latencies.push_back(seconds * 1e6);
+            total += seconds;
+            expanded += stats.expanded;
+            routed[i] = !path.empty();
+            costs[i] = orthogonal_path_cost(path);
+            failed += path.empty();
+        }
+        if (ctx.enabled(astar_name)) {
+            auto& result = ctx.record(astar_name, pairs.size(), total);
+            result.counter("p50_us", percentile(latencies, 0.5));
+            result.counter("p99_us", percentile(latencies, 0.99));
+            result.counter("nodes_expanded", static_cast<double>(expanded) / static_cast<double>(pairs.size()));
+            result.counter("failed_rate", static_cast<double>(failed) / static_cast<double>(pairs.size()));
+        }
+    }
+
+    // route_wire searches the unbounded grid, so only pairs known to be
+    // routable are timed through it. cost_ratio compares route costs with
+    // the minimum found by find_orthogonal_path (1 for the exact searches).
+    auto time_route_wire = [&](const std::string& name, RouteSearch search, bool hierarchical) {
+        std::vector<double> latencies;
+        std::size_t expanded = 0;
+        double total = 0.0;
+        double cost_ratio = 0.0;
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            if (!routed[i])
+                continue;
+            PathSearchStats stats;
+            const auto start = clock::now();
+            const auto path = hierarchical
+                                  ? layout.route_wire_hierarchical(pairs[i].start, pairs[i].end, &stats, search)
+                                  : layout.route_wire(pairs[i].start, pairs[i].end, &stats, search);
+            const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+            latencies.push_back(seconds * 1e6);
+            total += seconds;
+            expanded += stats.expanded;
+            cost_ratio += static_cast<double>(orthogonal_path_cost(path)) / costs[i];
+        }
+        const double routes = latencies.empty() ? 1.0 : static_cast<double>(latencies.size());
+        auto& result = ctx.record(name, latencies.size(), total);
+        result.counter("p50_us", percentile(latencies, 0.5));
+        result.counter("p99_us", percentile(latencies, 0.99));
+        result.counter("nodes_expanded", static_cast<double>(expanded) / routes);
+        result.counter("cost_ratio", cost_ratio / routes);
+    };
+    if (ctx.enabled(layout_name))
+        time_route_wire(layout_name, RouteSearch::Cells, false);
+    if (ctx.enabled(jump_name))
+        time_route_wire(jump_name, RouteSearch::JumpPoints, false);
+    if (ctx.enabled(tiled_name))
+        time_route_wire(tiled_name, RouteSearch::Cells, true);
+
+    // Wiring preview: the mouse sweeps from each query's start to its end
+    // one cell per frame, and every frame routes to where it is.
+    if (ctx.enabled(preview_name)) {
+        std::vector<double> latencies;
+        std::size_t expanded = 0;
+        double total = 0.0;
+        for (std::size_t i = 0; i < pairs.size(); i += 10) {
+            const GridCoord from = pairs[i].start;
+            const GridCoord to = pairs[i].end;
+            const int frames = std::abs(to.x - from.x) + std::abs(to.y - from.y);
+            for (int frame = 1; frame <= frames; ++frame) {
+                const GridCoord mouse{from.x + (to.x - from.x) * frame / frames,
+                                      from.y + (to.y - from.y) * frame / frames};
+                PathSearchStats stats;
+                const auto start = clock::now();
+                bench::keep(layout.preview_route(from, mouse, &stats));
+                const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+                latencies.push_back(seconds * 1e6);
+                total += seconds;
+                expanded += stats.expanded;
+            }
+        }
+        const double frames = latencies.empty() ? 1.0 : static_cast<double>(latencies.size());
+        auto& result = ctx.record(preview_name, latencies.size(), total);
+        result.counter("p50_us", percentile(latencies, 0.5));
+        result.counter("p99_us", percentile(latencies, 0.99));
+        result.counter("max_us", latencies.empty() ? 0.0 : *std::ranges::max_element(latencies));
+        result.counter("nodes_expanded", static_cast<double>(expanded) / frames);
+    }
+}
+
+// Every output drives one to three of the free inputs nearest to it; the
+// resulting signals are routed in one autoroute() call per thread count.
+void autoroute_benchmarks(bench::Context& ctx, std::size_t modules) {
+    std::vector<std::size_t> thread_counts{1};
+    if (const std::size_t hardware = std::thread::hardware_concurrency(); hardware > 1)
+        thread_counts.push_back(hardware);
+    const std::string suffix = "/modules=" + std::to_string(modules) + "/threads=";
+    for (std::size_t threads : thread_counts) {
+        const std::string name = "route/autoroute" + suffix + std::to_string(threads);
+        if (!ctx.enabled(name))
+            continue;
+
+        World world;
+        graphics::Grid grid;
+        std::mt19937 rng(17);
+        const Placement placement = place_modules(world, grid, modules, rng);
+        LayoutSystem layout(world, grid);
+        layout.update_all();
+
+        std::vector<bool> used(placement.inputs.size(), false);
+        std::uniform_int_distribution<int> fanout(1, 3);
+        for (Entity out : placement.outputs) {
+            const GridCoord from = world.get<PortGridPosition>(out)->position;
+            std::vector<std::pair<std::int64_t, std::size_t>> nearest;
+            for (std::size_t i = 0; i < placement.inputs.size(); ++i) {
+                if (used[i] || world.get<Port>(placement.inputs[i])->owner == world.get<Port>(out)->owner)
+                    continue;
+                const GridCoord to = world.get<PortGridPosition>(placement.inputs[i])->position;
+                nearest.push_back({std::abs(std::int64_t{to.x} - from.x) + std::abs(std::int64_t{to.y} - from.y), i});
+            }
+            const auto count = std::min<std::size_t>(static_cast<std::size_t>(fanout(rng)), nearest.size());
+            std::partial_sort(nearest.begin(), nearest.begin() + static_cast<std::ptrdiff_t>(count), nearest.end());
+            std::vector<Entity> ports{out};
+            for (std::size_t k = 0; k < count; ++k) {
+                used[nearest[k].second] = true;
+                ports.push_back(placement.inputs[nearest[k].second]);
+            }
+            world.emplace<Signal>(world.create(), Symbol{}, 1u, Entity{}, std::move(ports));
+        }
+
+        ThreadPool pool(threads);
+        const AutorouteReport report = autoroute(world, layout, pool);
+        auto& result = ctx.record(name, 1, report.seconds);
+        result.counter("nets", static_cast<double>(report.nets));
+        result.counter("routed_nets", static_cast<double>(report.routed_nets));
+        result.counter("overflow_cells", static_cast<double>(report.overflow_cells));
+        result.counter("iterations", report.iterations);
+        result.counter("wirelength", static_cast<double>(report.wirelength));
+        result.counter("bends", static_cast<double>(report.bends));
+        result.counter("nodes_expanded", static_cast<double>(report.expanded));
+    }
+}
+
+} // namespace
+
+BENCH(routing) {
+    for (std::size_t modules : ctx.sweep<std::size_t>({10, 30, 100, 1'000}))
+        routing_benchmarks(ctx, modules, 100);
+    for (std::size_t modules : ctx.sweep<std::size_t>({100, 1'000}))
+        autoroute_benchmarks(ctx, modules);
+}
@@ -0,0 +1,112 @@
+#include "alloc_counter.hpp"
+#include "bench_framework.hpp"
+#include "circuits.hpp"
+
+#include <systems/simulation.hpp>
+
+#include <functional>
+#include <string>
+
+using namespace netra;
+
+namespace {
+
+// Every built-in gate as a BehaviorFunc, to time the by-name path that
+// custom primitives take against the inline opcode dispatch.
+void register_behavior_gates(Simulation& sim) {
+    auto fold = [&sim](const char* name, bool unary, auto op) {
+        sim.register_primitive(name, [unary, op](const std::vector<BitValue>& in,
+                                                 std::vector<BitValue>& out) {
+            if (in.size() < (unary ? 1u : 2u) || out.empty())
+                return;
+            std::size_t ones = 0;
+            for (const auto& value : in)
+                ones += value.get_bit(0);
+            out[0] = BitValue(1);
+            out[0].set_bit(0, op(ones, in.size(), in[0].get_bit(0)));
+        });
+    };
+    fold("AND", false, [](std::size_t ones, std::size_t n, bool) { return ones == n; });
+    fold("NAND", false, [](std::size_t ones, std::size_t n, bool) { return ones != n; });
+    fold("OR", false, [](std::size_t ones, std::size_t, bool) { return ones != 0; });
+    fold("NOR", false, [](std::size_t ones, std::size_t, bool) { return ones == 0; });
+    fold("XOR", false, [](std::size_t ones, std::size_t, bool) { return (ones & 1u) != 0; });
+    fold("XNOR", false, [](std::size_t ones, std::size_t, bool) { return (ones & 1u) == 0; });
+    fold("NOT", true, [](std::size_t, std::size_t, bool first) { return !first; });
+    fold("BUF", true, [](std::size_t, std::size_t, bool first) { return first; });
+}
+
+struct Mode {
+    const char* name;
+    void (*setup)(Simulation&);
+};
+
+constexpr Mode k_modes[] = {
+    {"builtin", primitives::register_basic_gates},
+    {"behavior", register_behavior_gates},
+};
+
+// Builds the circuit in a fresh World for each mode and times step().
+// bytes_per_gate is everything the World and Simulation hold once the
+// first step has cached opcodes and written every output value.
+void run_circuit(bench::Context& ctx, const std::string& name,
+                 const std::function<bench::Circuit(World&)>& make) {
+    for (const Mode& mode : k_modes) {
+        const std::string case_name = "sim/" + name + "/" + mode.name;
+        if (!ctx.enabled(case_name))
+            continue;
+
+        const std::size_t bytes_before = bench::live_bytes();
+        World world;
+        const bench::Circuit circuit = make(world);
+        Simulation sim(world);
+        mode.setup(sim);
+        std::mt19937 rng(1);
+        bench::randomize_inputs(world, circuit, rng);
+        sim.step();
+        const double bytes = static_cast<double>(bench::live_bytes() - bytes_before);
+
+        auto& result = ctx.measure(case_name, [&] { sim.step(); });
+        const double gates = static_cast<double>(circuit.gates);
+        result.counter("gates", gates);
+        result.counter("steps_per_sec", result.ops_per_second());
+        result.counter("gates_per_sec", gates * result.ops_per_second());
+        result.counter("bytes_per_gate", bytes / gates);
+    }
+}
+
+} // namespace
+
+BENCH(simulation_adders) {
+    for (unsigned bits : ctx.sweep({64u, 1024u, 16384u})) {
+        run_circuit(ctx, "ripple_adder/bits=" + std::to_string(bits),
+                    [bits](World& w) { return bench::ripple_carry_adder(w, bits); });
+        run_circuit(ctx, "cla_adder/bits=" + std::to_string(bits),
+                    [bits](World& w) { return bench::carry_lookahead_adder(w, bits); });
+    }
+}
+
+BENCH(simulation_multiplier) {
+    for (unsigned bits : ctx.sweep({8u, 32u, 64u})) {
+        run_circuit(ctx, "array_multiplier/bits=" + std::to_string(bits),
+                    [bits](World& w) { return bench::array_multiplier(w, bits); });
+    }
+}
+
+BENCH(simulation_random_dag) {
+    for (std::size_t gates : ctx.sweep<std::size_t>({1'000, 100'000, 1'000'000})) {
+        for (unsigned fanout : {2u, 8u}) {
+            run_circuit(ctx,
+                        "random_dag/gates=" + std::to_string(gates) +
+                            "/fanout=" + std::to_string(fanout),
+                        [=](World& w) { return bench::random_dag(w, gates, fanout, 42); });
+        }
+    }
+}
+
+BENCH(simulation_lfsr) {
+    for (unsigned bits : ctx.sweep({64u, 4096u})) {
+        run_circuit(ctx, "lfsr/bits=" + std::to_string(bits),
+                    [bits](World& w) { return bench::lfsr(w, bits); });
+    }
+}
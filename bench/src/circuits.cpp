@@ -0,0 +1,255 @@
+#include "circuits.hpp"
+
+#include <systems/simulation.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+
+using namespace netra;
+
+namespace bench {
+
+namespace {
+
+// Sum and carry of up to three bits; missing bits count as constant 0, so
+// two bits make a half adder and one bit passes through without gates.
+std::pair<Entity, std::optional<Entity>>
+add_bits(CircuitBuilder& builder, std::initializer_list<std::optional<Entity>> bits) {
+    std::vector<Entity> present;
+    for (const auto& bit : bits)
+        if (bit)
+            present.push_back(*bit);
+    if (present.size() == 1)
+        return {present[0], std::nullopt};
+    if (present.size() == 2) {
+        return {builder.gate(GateType::XOR, {present[0], present[1]}),
+                builder.gate(GateType::AND, {present[0], present[1]})};
+    }
+    const Entity half = builder.gate(GateType::XOR, {present[0], present[1]});
+    const Entity sum = builder.gate(GateType::XOR, {half, present[2]});
+    const Entity both = builder.gate(GateType::AND, {present[0], present[1]});
+    const Entity carried = builder.gate(GateType::AND, {half, present[2]});
+    return {sum, builder.gate(GateType::OR, {both, carried})};
+}
+
+Circuit make_inputs(CircuitBuilder& builder, std::size_t count) {
+    Circuit circuit;
+    circuit.inputs.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        circuit.inputs.push_back(builder.net());
+    return circuit;
+}
+
+} // namespace
+
+CircuitBuilder::CircuitBuilder(World& world)
+    : m_world(world), m_output_name(world.intern("Y")) {}
+
+Entity CircuitBuilder::net() {
+    const Entity signal = m_world.create();
+    m_world.emplace<Signal>(signal, Symbol{}, 1u, Entity{}, std::vector<Entity>{});
+    m_world.emplace<BitValue>(signal, 1u);
+    return signal;
+}
+
+void CircuitBuilder::drive(GateType type, std::span<const Entity> inputs, Entity output) {
+    auto& def = m_defs[static_cast<std::size_t>(type)];
+    if (!def) {
+        def = m_world.create();
+        m_world.emplace<ModuleDef>(def, m_world.intern(gate_name(type)), true);
+    }
+
+    const Entity inst = m_world.create();
+    m_world.emplace<ModuleInst>(inst, Symbol{}, def);
+    auto connect = [&](Symbol name, PortDirection direction, Entity signal) {
+        const Entity port = m_world.create();
+        m_world.emplace<Port>(port, name, direction, 1u, inst, signal);
+        m_world.get<Signal>(signal)->connected_ports.push_back(port);
+    };
+    for (std::size_t i = 0; i < inputs.size(); ++i)
+        connect(input_name(i), PortDirection::In, inputs[i]);
+    connect(m_output_name, PortDirection::Out, output);
+    ++m_gates;
+}
+
+Entity CircuitBuilder::gate(GateType type, std::span<const Entity> inputs) {
+    const Entity output = net();
+    drive(type, inputs, output);
+    return output;
+}
+
+Symbol CircuitBuilder::input_name(std::size_t index) {
+    while (m_input_names.size() <= index) {
+        const std::size_t i = m_input_names.size();
+        m_input_names.push_back(m_world.intern(
+            i < 26 ? std::string(1, static_cast<char>('A' + i)) : "I" + std::to_string(i)));
+    }
+    return m_input_names[index];
+}
+
+Circuit ripple_carry_adder(World& world, unsigned bits) {
+    CircuitBuilder builder(world);
+    Circuit circuit = make_inputs(builder, 2 * bits);
+    std::optional<Entity> carry;
+    for (unsigned i = 0; i < bits; ++i) {
+        auto [sum, carry_out] =
+            add_bits(builder, {circuit.inputs[i], circuit.inputs[bits + i], carry});
+        circuit.outputs.push_back(sum);
+        carry = carry_out;
+    }
+    if (carry)
+        circuit.outputs.push_back(*carry);
+    circuit.gates = builder.gate_count();
+    return circuit;
+}
+
+Circuit carry_lookahead_adder(World& world, unsigned bits) {
+    CircuitBuilder builder(world);
+    Circuit circuit = make_inputs(builder, 2 * bits + 1);
+    Entity carry = circuit.inputs[2 * bits]; // carry in
+
+    for (unsigned base = 0; base < bits; base += 4) {
+        const unsigned width = std::min(4u, bits - base);
+        std::vector<Entity> p;
+        std::vector<Entity> g;
+        for (unsigned i = 0; i < width; ++i) {
+            const Entity a = circuit.inputs[base + i];
+            const Entity b = circuit.inputs[bits + base + i];
+            p.push_back(builder.gate(GateType::XOR, {a, b}));
+            g.push_back(builder.gate(GateType::AND, {a, b}));
+        }
+        // c[i+1] = g[i] | p[i]g[i-1] | ... | p[i]..p[0]c[0]
+        std::vector<Entity> carries{carry};
+        for (unsigned i = 0; i < width; ++i) {
+            std::vector<Entity> terms{g[i]};
+            for (unsigned j = 0; j <= i; ++j) {
+                std::vector<Entity> term(p.begin() + j, p.begin() + i + 1);
+                term.push_back(j == 0 ? carry : g[j - 1]);
+                terms.push_back(builder.gate(GateType::AND, term));
+            }
+            carries.push_back(builder.gate(GateType::OR, terms));
+        }
+        for (unsigned i = 0; i < width; ++i)
+            circuit.outputs.push_back(builder.gate(GateType::XOR, {p[i], carries[i]}));
+        carry = carries.back();
+    }
+    circuit.outputs.push_back(carry);
+    circuit.gates = builder.gate_count();
+    return circuit;
+}
+
+Circuit array_multiplier(World& world, unsigned bits) {
+    CircuitBuilder builder(world);
+    Circuit circuit = make_inputs(builder, 2 * bits);
+    auto partial = [&](unsigned row) {
+        std::vector<Entity> products;
+        for (unsigned j = 0; j < bits; ++j)
+            products.push_back(
+                builder.gate(GateType::AND, {circuit.inputs[j], circuit.inputs[bits + row]}));
+        return products;
+    };
+
+    // acc holds the running sum shifted so acc[0] is the next product bit.
+    std::vector<Entity> acc = partial(0);
+    std::optional<Entity> top;
+    for (unsigned row = 1; row < bits; ++row) {
+        circuit.outputs.push_back(acc[0]);
+        const auto products = partial(row);
+        std::vector<Entity> next;
+        std::optional<Entity> carry;
+        for (unsigned j = 0; j < bits; ++j) {
+            const std::optional<Entity> upper = j + 1 < bits ? std::optional(acc[j + 1]) : top;
+            auto [sum, carry_out] = add_bits(builder, {upper, products[j], carry});
+            next.push_back(sum);
+            carry = carry_out;
+        }
+        acc = std::move(next);
+        top = carry;
+    }
+    circuit.outputs.insert(circuit.outputs.end(), acc.begin(), acc.end());
+    if (top)
+        circuit.outputs.push_back(*top);
+    circuit.gates = builder.gate_count();
+    return circuit;
+}
+
+Circuit random_dag(World& world, std::size_t gates, unsigned fanout, std::uint32_t seed) {
+    static constexpr std::array<GateType, 7> k_types{
+        GateType::AND, GateType::NAND, GateType::OR, GateType::NOR,
+        GateType::XOR, GateType::XNOR, GateType::NOT};
+
+    CircuitBuilder builder(world);
+    std::mt19937 rng(seed);
+    Circuit circuit = make_inputs(builder, std::max<std::size_t>(16, gates / 16));
+
+    // Nets that can still take a reader, with their reader counts.
+    std::vector<Entity> open(circuit.inputs);
+    std::vector<unsigned> readers(open.size(), 0);
+    auto swap_nets = [&](std::size_t i, std::size_t j) {
+        std::swap(open[i], open[j]);
+        std::swap(readers[i], readers[j]);
+    };
+
+    for (std::size_t n = 0; n < gates; ++n) {
+        const GateType type = k_types[rng() % k_types.size()];
+        const std::size_t arity = type == GateType::NOT ? 1 : 2;
+        while (open.size() < arity) {
+            open.push_back(builder.net());
+            readers.push_back(0);
+            circuit.inputs.push_back(open.back());
+        }
+        // Distinct picks: each one is moved to the end of the open list.
+        const std::size_t end = open.size();
+        Entity picked[2];
+        for (std::size_t k = 0; k < arity; ++k) {
+            const std::size_t range = end - k;
+            swap_nets(rng() % range, range - 1);
+            picked[k] = open[range - 1];
+        }
+        for (std::size_t index = end; index-- > end - arity;) {
+            if (++readers[index] >= fanout) {
+                swap_nets(index, open.size() - 1);
+                open.pop_back();
+                readers.pop_back();
+            }
+        }
+        open.push_back(builder.gate(type, std::span<const Entity>(picked, arity)));
+        readers.push_back(0);
+    }
+
+    for (std::size_t i = 0; i < open.size(); ++i)
+        if (readers[i] == 0)
+            circuit.outputs.push_back(open[i]);
+    circuit.gates = builder.gate_count();
+    return circuit;
+}
+
+Circuit lfsr(World& world, unsigned bits) {
+    CircuitBuilder builder(world);
+    Circuit circuit;
+    std::vector<Entity> stages;
+    for (unsigned i = 0; i < bits; ++i)
+        stages.push_back(builder.net());
+    world.get<BitValue>(stages[0])->set_bit(0, true);
+
+    // Feedback from the old top stages, then the shift from the top down.
+    const Entity feedback = builder.gate(GateType::XOR, {stages[bits - 1], stages[bits - 2]});
+    for (unsigned i = bits - 1; i > 0; --i) {
+        const Entity from = stages[i - 1];
+        builder.drive(GateType::BUF, std::span<const Entity>(&from, 1), stages[i]);
+    }
+    builder.drive(GateType::BUF, std::span<const Entity>(&feedback, 1), stages[0]);
+
+    circuit.outputs = stages;
+    circuit.gates = builder.gate_count();
+    return circuit;
+}
+
+void randomize_inputs(World& world, const Circuit& circuit, std::mt19937& rng) {
+    for (Entity input : circuit.inputs)
+        world.get<BitValue>(input)->set_bit(0, (rng() & 1u) != 0);
+}
+
+} // namespace bench
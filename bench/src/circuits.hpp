@@ -0,0 +1,82 @@
+#pragma once
+
+#include <components/components.hpp>
+#include <core/world.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace bench {
+
+// Builds gate-level netlists directly in a World, shaped like the Verilog
+// importer's output: one shared primitive ModuleDef per GateType, a Signal
+// per net with a 1-bit BitValue, and input ports A, B, C... before output Y.
+//
+// Simulation::step() evaluates instances in creation order, so a circuit
+// whose gates are created in topological order settles in one step.
+class CircuitBuilder {
+public:
+    explicit CircuitBuilder(netra::World& world);
+
+    // A new undriven net (primary input, or a net driven later by drive()).
+    netra::Entity net();
+
+    // Adds a gate reading `inputs` and driving `output`.
+    void drive(netra::GateType type, std::span<const netra::Entity> inputs,
+               netra::Entity output);
+
+    // Adds a gate driving a new net and returns that net.
+    netra::Entity gate(netra::GateType type, std::span<const netra::Entity> inputs);
+    netra::Entity gate(netra::GateType type, std::initializer_list<netra::Entity> inputs) {
+        return gate(type, std::span<const netra::Entity>(inputs.begin(), inputs.size()));
+    }
+
+    std::size_t gate_count() const { return m_gates; }
+
+private:
+    netra::Symbol input_name(std::size_t index);
+
+    netra::World& m_world;
+    std::array<netra::Entity, static_cast<std::size_t>(netra::GateType::INVALID)> m_defs{};
+    std::vector<netra::Symbol> m_input_names;
+    netra::Symbol m_output_name;
+    std::size_t m_gates = 0;
+};
+
+struct Circuit {
+    std::vector<netra::Entity> inputs;
+    std::vector<netra::Entity> outputs;
+    std::size_t gates = 0;
+};
+
+// a + b over `bits` full adders (5 two-input gates each).
+Circuit ripple_carry_adder(netra::World& world, unsigned bits);
+
+// a + b with 4-bit carry-lookahead groups, rippled between groups. The
+// lookahead terms use the wide AND/OR gates Simulation folds natively.
+Circuit carry_lookahead_adder(netra::World& world, unsigned bits);
+
+// bits x bits array multiplier: AND partial products summed row by row
+// with ripple adders.
+Circuit array_multiplier(netra::World& world, unsigned bits);
+
+// `gates` random gates (two-input gates and NOT) over random earlier nets.
+// Each net feeds at most `fanout` gates; nets nobody reads are outputs.
+Circuit random_dag(netra::World& world, std::size_t gates, unsigned fanout,
+                   std::uint32_t seed);
+
+// Fibonacci LFSR of `bits` stages with taps on the two top stages, seeded
+// with 1. Simulation has no flip-flops, so each stage is a BUF created in
+// reverse shift order: every step() reads the previous step's values and
+// advances the register by one, like a clock edge.
+Circuit lfsr(netra::World& world, unsigned bits);
+
+// Assigns random values to the primary inputs.
+void randomize_inputs(netra::World& world, const Circuit& circuit, std::mt19937& rng);
+
+} // namespace bench
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace netra {
@@ -12,6 +13,7 @@ enum class GateType : std::uint8_t {
     XOR,
     XNOR,
     NOT,
+    BUF,
     INVALID,
     COUNT
 };
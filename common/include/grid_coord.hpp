@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 
 namespace netra {
 
@@ -13,4 +15,26 @@ struct GridCoord {
     bool operator==(const GridCoord&) const = default;
 };
 
+// Axis-aligned block of cells, both corners inclusive.
+struct GridRect {
+    GridCoord min;
+    GridCoord max;
+
+    bool contains(GridCoord p) const {
+        return p.x >= min.x && p.y >= min.y && p.x <= max.x && p.y <= max.y;
+    }
+    bool operator==(const GridRect&) const = default;
+};
+
 } // namespace netra
+
+// Packs both coordinates into one word and mixes it, so nearby cells spread
+// over all buckets (x ^ (y << 1) sent whole diagonals to the same bucket).
+template <> struct std::hash<netra::GridCoord> {
+    std::size_t operator()(const netra::GridCoord& c) const noexcept {
+        std::uint64_t key = (std::uint64_t{static_cast<std::uint32_t>(c.x)} << 32) |
+                            static_cast<std::uint32_t>(c.y);
+        key *= 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(key ^ (key >> 32));
+    }
+};
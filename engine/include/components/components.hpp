@@ -1,49 +1,82 @@
 #pragma once
 
+#include <gates.hpp>
 #include <types.hpp>
 #include "core/entity.hpp"
+#include "core/symbol_table.hpp"
 #include <boost/dynamic_bitset.hpp>
-#include <string>
+#include <type_traits>
 #include <vector>
 #include <cstdint>
 
 namespace netra {
 
+// Names are Symbols interned in the owning World (World::intern/name), so
+// ModuleDef, ModuleInst and Port are trivially copyable and names compare as
+// integers.
+
 // Module definition - a "type" or "class" of module (e.g., "AND gate", "Adder")
 struct ModuleDef {
-    std::string name;
+    Symbol name;
     bool is_primitive = false;
     Entity internal_root = Entity{};
+
+    bool operator==(const ModuleDef&) const = default;
 };
 
 // Module instance - a placed instance of a module definition
 struct ModuleInst {
-    std::string instance_name;
+    Symbol instance_name;
     Entity definition;
+
+    bool operator==(const ModuleInst&) const = default;
 };
 
 // Port on a module
 struct Port {
-    std::string name;
+    Symbol name;
     PortDirection direction = PortDirection::In;
     std::uint32_t width = 1;
     Entity owner;
     Entity connected_signal;
+
+    bool operator==(const Port&) const = default;
+};
+
+// Opcode of a primitive ModuleDef, cached on the def entity by Simulation so
+// evaluation dispatches on an enum instead of looking the name up. `name` is
+// the ModuleDef::name it was resolved from; a renamed def is re-resolved.
+// GateType::INVALID marks primitives with no built-in gate (custom
+// behaviours registered by name).
+struct PrimitiveOp {
+    GateType type = GateType::INVALID;
+    Symbol name;
+
+    bool operator==(const PrimitiveOp&) const = default;
 };
 
+static_assert(std::is_trivially_copyable_v<ModuleDef> &&
+              std::is_trivially_copyable_v<ModuleInst> &&
+              std::is_trivially_copyable_v<Port> &&
+              std::is_trivially_copyable_v<PrimitiveOp>);
+
 // Signal/wire connecting ports
 // Ideally, we would have a single writer/multi-reader regulation per update cycle.
 struct Signal {
-    std::string name;
+    Symbol name;
     std::uint32_t width = 1;
     Entity scope;
     std::vector<Entity> connected_ports;
+
+    bool operator==(const Signal&) const = default;
 };
 
 // Parent/child hierarchy
 struct Hierarchy {
     Entity parent;
     std::vector<Entity> children;
+
+    bool operator==(const Hierarchy&) const = default;
 };
 
 // Value storage for simulation
@@ -1,10 +1,10 @@
 #pragma once
 
 #include "core/entity.hpp"
+#include "core/symbol_table.hpp"
 #include <grid_coord.hpp>
 
 #include <cstdint>
-#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -21,12 +21,16 @@ enum class PortSide : std::uint8_t {
 struct ModuleExtent {
   std::int32_t width = 1;
   std::int32_t height = 1;
+
+  bool operator==(const ModuleExtent &) const = default;
 };
 
 // Module render position in pixels (derived from port grid positions).
 struct ModulePixelPosition {
   float x = 0.0f;
   float y = 0.0f;
+
+  bool operator==(const ModulePixelPosition &) const = default;
 };
 
 // Port offset from module top-left corner in grid units.
@@ -34,24 +38,32 @@ struct ModulePixelPosition {
 struct PortOffset {
   std::int32_t x = 0;
   std::int32_t y = 0;
+
+  bool operator==(const PortOffset &) const = default;
 };
 
 // Rendering association for an entity (e.g. module instance box, primitive gate
 // symbol, etc.). This is a stable key that the graphics layer can map to an
-// actual shader/program.
+// actual shader/program. Interned in the owning World.
 struct ShaderKey {
-  std::string key;
+  Symbol key;
+
+  bool operator==(const ShaderKey &) const = default;
 };
 
 // Which side the port is on (for visual orientation of pin/arrow).
 struct PortVisual {
   PortSide side = PortSide::Left;
+
+  bool operator==(const PortVisual &) const = default;
 };
 
 // Cached port position in canvas grid coordinates (derived from module position
 // + offset).
 struct PortGridPosition {
   GridCoord position{0, 0};
+
+  bool operator==(const PortGridPosition &) const = default;
 };
 
 // A user-authored wire entity.
@@ -63,12 +75,16 @@ struct Wire {
   Entity from_endpoint{};        // Port or wire point this wire starts from
   Entity to_endpoint{};          // Port or wire point this wire ends at
   std::vector<GridCoord> points; // Polyline points (excluding endpoints)
+
+  bool operator==(const Wire &) const = default;
 };
 
 // Marker component for a wire junction point (where wires can connect).
 // Attached to wire entities; the junction position is one of the wire's points.
 struct WireJunction {
   std::size_t point_index = 0; // Index into Wire::points where junction exists
+
+  bool operator==(const WireJunction &) const = default;
 };
 
 // Transient segment structure for crossing detection
@@ -1,25 +1,510 @@
 #pragma once
 
+#include <core/occupancy_bitmap.hpp>
 #include <grid_coord.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <vector>
 #include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <utility>
 
 namespace netra {
 
 // Function signature for checking if a cell is blocked.
 // Returns true if the cell at (x, y) is blocked.
+// The router is templated on the predicate; this type-erased form is for
+// callers that need to store one.
 using ObstacleCheck = std::function<bool(GridCoord)>;
 
-// Finds an orthogonal path from start to end on a grid.
-// Uses A* with Manhattan distance and turn penalties.
-// 
+// Path cost model: every step costs k_path_move_cost, every change of
+// direction another k_path_turn_cost.
+inline constexpr int k_path_move_cost = 1;
+inline constexpr int k_path_turn_cost = 50;
+
+// Cost of a path of unit orthogonal steps under the model above.
+int orthogonal_path_cost(const std::vector<GridCoord>& path);
+
+// Upper bound on the extra cost of one step in
+// OrthogonalRouter::find_weighted_path; keeps the bucket queue small.
+inline constexpr int k_max_step_cost = 63;
+
+// How OrthogonalRouter explores the grid. Both find minimum-cost paths.
+enum class RouteSearch : std::uint8_t {
+    // A* over every cell. Cheapest for short routes.
+    Cells,
+    // Jump point search: straight runs are skipped in one step and only
+    // cells where a turn can pay off become search nodes. Far fewer
+    // expansions on long routes across open space.
+    JumpPoints,
+};
+
+// Optional search counters, filled in when passed to find_orthogonal_path.
+struct PathSearchStats {
+    std::size_t expanded = 0; // nodes taken off the open set
+};
+
+// A* over (cell, entry direction) states with Manhattan distance and turn
+// penalties. Keying the search on direction as well as position keeps the
+// cheapest path per heading, so the result has the fewest bends the cost
+// model allows.
+//
+// The search runs in a window around start and end: flat state arrays over
+// the window, reset by bumping a generation stamp, and a bucket queue over
+// the small integer costs. If the window is too small to prove the result
+// optimal (a cheaper path could leave it), the margin doubles and the search
+// repeats. The first window is always searched, however far apart the ends
+// are; later ones stop growing past four times its size or
+// k_max_window_cells, whichever is larger. A search that hits that limit
+// returns the cheapest path found inside the last window, which may not be
+// optimal, or an empty path if there was none, instead of running
+// unbounded.
+//
+// With RouteSearch::JumpPoints the same windows are searched over jump
+// points. Some minimum-cost path only turns off a straight run at a cell
+// where the free run beside it gets longer than beside the previous cell
+// (the turn clears an obstacle), or onto the end's row or column. Any other
+// turn slides back along the run without raising the cost. Jumps therefore
+// stop only at such cells, and costs match the cell search exactly.
+//
+// `is_blocked` is any callable bool(GridCoord); it is inlined into the
+// search. Its results are cached per cell for the duration of a search,
+// except for an OccupancyBitmap: the part under each window is packed into
+// a dense bitmap and probed directly.
+//
+// Keep one router around to reuse its buffers across searches. Not
+// thread-safe.
+class OrthogonalRouter {
+public:
+    static constexpr std::size_t k_max_window_cells = std::size_t{1} << 20;
+
+    // See find_orthogonal_path.
+    template <typename IsBlocked>
+    std::vector<GridCoord> find_path(GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                                     PathSearchStats* stats = nullptr,
+                                     RouteSearch search = RouteSearch::Cells);
+
+    // As find_path, with step_cost(from, to, turn) added for every step of
+    // the path: any callable int(GridCoord, GridCoord, bool), where `turn`
+    // says the path bends at `from`; clamped to [0, k_max_step_cost]. For
+    // congestion-aware routing. Always searches cell by cell: jump points
+    // rely on every step costing the same.
+    template <typename IsBlocked, typename StepCost>
+    std::vector<GridCoord> find_weighted_path(GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                                              const StepCost& step_cost, PathSearchStats* stats = nullptr);
+
+private:
+    struct NoStepCost {
+        int operator()(GridCoord, GridCoord, bool) const { return 0; }
+    };
+
+    struct Window {
+        std::int64_t x0 = 0;
+        std::int64_t y0 = 0;
+        std::int64_t width = 0;
+        std::int64_t height = 0;
+
+        bool contains(GridCoord p) const {
+            return p.x >= x0 && p.y >= y0 && p.x < x0 + width && p.y < y0 + height;
+        }
+        std::uint32_t index(GridCoord p) const {
+            return static_cast<std::uint32_t>((p.y - y0) * width + (p.x - x0));
+        }
+        GridCoord coord(std::uint32_t cell) const {
+            return {static_cast<std::int32_t>(x0 + cell % width), static_cast<std::int32_t>(y0 + cell / width)};
+        }
+        std::size_t cells() const { return static_cast<std::size_t>(width * height); }
+    };
+
+    // Directions: 0=up, 1=down, 2=left, 3=right. d ^ 1 is the opposite of d.
+    static constexpr std::array<GridCoord, 4> k_steps = {{{0, 1}, {0, -1}, {-1, 0}, {1, 0}}};
+    // Parent direction of the start states.
+    static constexpr std::uint8_t k_from_start = 4;
+    // Parent state of the start states in jump point search.
+    static constexpr std::uint32_t k_no_parent = std::numeric_limits<std::uint32_t>::max();
+
+    static Window window_around(GridCoord start, GridCoord end, std::int64_t margin);
+    // Lower bound on the cost of any path through a cell outside the window.
+    static std::int64_t outside_bound(GridCoord start, GridCoord end, std::int64_t margin);
+    static int heuristic(GridCoord from, GridCoord end) {
+        return (std::abs(from.x - end.x) + std::abs(from.y - end.y)) * k_path_move_cost;
+    }
+
+    // The window-growing loop behind find_path and find_weighted_path.
+    template <typename IsBlocked, typename StepCost>
+    std::vector<GridCoord> search_windows(GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                                          const StepCost& step_cost, PathSearchStats* stats,
+                                          RouteSearch search_kind);
+
+    // One pass over a fixed window. Returns the path's cost (and fills
+    // `path`) or -1; `left_window` is set when the search tried to step
+    // onto a free cell outside the window.
+    template <typename IsBlocked, typename StepCost>
+    int search(const Window& window, GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+               const StepCost& step_cost, PathSearchStats* stats, std::vector<GridCoord>& path,
+               bool& left_window);
+
+    // As search(), over jump points. `left_window` is also set when a free
+    // run that steered the search ran into the window's edge.
+    template <typename IsBlocked>
+    int search_jumps(const Window& window, GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                     PathSearchStats* stats, std::vector<GridCoord>& path, bool& left_window);
+
+    template <typename IsBlocked>
+    bool cell_blocked(const IsBlocked& is_blocked, std::uint32_t cell, GridCoord pos);
+
+    void next_generation(const Window& window, bool jumps);
+    void trace_back(const Window& window, GridCoord end, std::uint32_t state, std::vector<GridCoord>& path) const;
+    void trace_jumps(const Window& window, std::uint32_t state, std::vector<GridCoord>& path) const;
+
+    // Per state (cell * 4 + entry direction); valid where stamp == generation.
+    std::vector<std::uint32_t> m_state_stamp;
+    std::vector<int> m_g_cost;
+    std::vector<std::uint8_t> m_parent_dir;
+
+    // Per cell: cached is_blocked result; valid where stamp == generation.
+    std::vector<std::uint32_t> m_cell_stamp;
+    std::vector<std::uint8_t> m_blocked;
+
+    std::uint32_t m_generation = 0;
+
+    // The window's cells, when is_blocked is an OccupancyBitmap.
+    OccupancyBitmap::Packed m_packed;
+
+    // Jump point search only. m_runs holds, per cell and direction, the free
+    // cells before the next obstacle or the window's edge; filled a column
+    // (up/down) or row (left/right) at a time, valid where that column's or
+    // row's stamp == generation. m_column_edge / m_row_edge flag whether the
+    // cell just outside the window beyond each end is blocked (bit = dir).
+    std::vector<std::uint32_t> m_parent_state;
+    std::vector<std::int32_t> m_runs;
+    std::vector<std::uint32_t> m_column_stamp;
+    std::vector<std::uint32_t> m_row_stamp;
+    std::vector<std::uint8_t> m_column_edge;
+    std::vector<std::uint8_t> m_row_edge;
+
+    // Monotone bucket queue keyed by f cost modulo the bucket count. One step
+    // raises f by at most move + turn + step cost + 1 (the heuristic can grow
+    // by one), so every pending entry fits in the ring.
+    static constexpr std::size_t k_bucket_count = 128;
+    static_assert(k_bucket_count > k_path_move_cost + k_path_turn_cost + k_max_step_cost + 1);
+    std::array<std::vector<std::uint32_t>, k_bucket_count> m_buckets;
+};
+
+template <typename IsBlocked>
+std::vector<GridCoord> OrthogonalRouter::find_path(GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                                                   PathSearchStats* stats, RouteSearch search_kind) {
+    return search_windows(start, end, is_blocked, NoStepCost{}, stats, search_kind);
+}
+
+template <typename IsBlocked, typename StepCost>
+std::vector<GridCoord> OrthogonalRouter::find_weighted_path(GridCoord start, GridCoord end,
+                                                            const IsBlocked& is_blocked, const StepCost& step_cost,
+                                                            PathSearchStats* stats) {
+    return search_windows(start, end, is_blocked, step_cost, stats, RouteSearch::Cells);
+}
+
+template <typename IsBlocked, typename StepCost>
+std::vector<GridCoord> OrthogonalRouter::search_windows(GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                                                        const StepCost& step_cost, PathSearchStats* stats,
+                                                        RouteSearch search_kind) {
+    if (start.x == end.x && start.y == end.y) {
+        return {start};
+    }
+    if(is_blocked(end)) return {};
+
+    // Margin of the first window around the endpoints' bounding box. Enough
+    // for a detour with a couple of bends to be proven optimal first time.
+    constexpr std::int64_t k_initial_margin = 32;
+
+    const std::size_t max_cells =
+        std::max(k_max_window_cells, 4 * window_around(start, end, k_initial_margin).cells());
+
+    std::vector<GridCoord> path;
+    for (std::int64_t margin = k_initial_margin;; margin *= 2) {
+        const Window window = window_around(start, end, margin);
+        if (margin > k_initial_margin && window.cells() > max_cells)
+            return path; // the best found so far, if any
+
+        if constexpr (std::is_same_v<IsBlocked, OccupancyBitmap>) {
+            is_blocked.pack({{static_cast<std::int32_t>(window.x0), static_cast<std::int32_t>(window.y0)},
+                             {static_cast<std::int32_t>(window.x0 + window.width - 1),
+                              static_cast<std::int32_t>(window.y0 + window.height - 1)}},
+                            m_packed);
+        }
+
+        bool left_window = false;
+        const int cost = search_kind == RouteSearch::JumpPoints
+                             ? search_jumps(window, start, end, is_blocked, stats, path, left_window)
+                             : search(window, start, end, is_blocked, step_cost, stats, path, left_window);
+        if (!left_window)
+            return path; // the search never reached the window's edge: same as unbounded
+        // Step costs only add to a detour, so the bound still holds.
+        if (cost >= 0 && cost <= outside_bound(start, end, margin))
+            return path;
+    }
+}
+
+template <typename IsBlocked, typename StepCost>
+int OrthogonalRouter::search(const Window& window, GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                             const StepCost& step_cost, PathSearchStats* stats, std::vector<GridCoord>& path,
+                             bool& left_window) {
+    next_generation(window, false);
+    const std::uint32_t generation = m_generation;
+
+    std::size_t pending = 0;
+    auto push = [&](std::uint32_t state, int f) {
+        m_buckets[static_cast<std::size_t>(f) % k_bucket_count].push_back(state);
+        ++pending;
+    };
+
+    // The first step turns nowhere: seed the start in every direction.
+    const std::uint32_t start_cell = window.index(start);
+    const int start_f = heuristic(start, end);
+    for (std::uint32_t d = 0; d < 4; ++d) {
+        const std::uint32_t state = start_cell * 4 + d;
+        m_state_stamp[state] = generation;
+        m_g_cost[state] = 0;
+        m_parent_dir[state] = k_from_start;
+        push(state, start_f);
+    }
+
+    const std::uint32_t end_cell = window.index(end);
+
+    for (int f = start_f; pending > 0; ++f) {
+        auto& bucket = m_buckets[static_cast<std::size_t>(f) % k_bucket_count];
+        while (!bucket.empty()) {
+            const std::uint32_t state = bucket.back();
+            bucket.pop_back();
+            --pending;
+
+            const std::uint32_t cell = state / 4;
+            const auto dir = static_cast<int>(state % 4);
+            const GridCoord pos = window.coord(cell);
+            const int g = m_g_cost[state];
+            // Superseded by a cheaper entry that was expanded already.
+            if (g + heuristic(pos, end) != f)
+                continue;
+            if (stats) ++stats->expanded;
+
+            if (cell == end_cell) {
+                trace_back(window, end, state, path);
+                return g;
+            }
+
+            for (int d = 0; d < 4; ++d) {
+                if (d == (dir ^ 1))
+                    continue; // stepping back onto the previous cell never helps
+                const GridCoord next{pos.x + k_steps[d].x, pos.y + k_steps[d].y};
+                if (!window.contains(next)) {
+                    if (!is_blocked(next))
+                        left_window = true;
+                    continue;
+                }
+                const std::uint32_t next_cell = window.index(next);
+                if (next_cell != end_cell && cell_blocked(is_blocked, next_cell, next))
+                    continue;
+
+                int next_g = g + k_path_move_cost + (d != dir ? k_path_turn_cost : 0);
+                if constexpr (!std::is_same_v<StepCost, NoStepCost>)
+                    next_g += std::clamp(step_cost(pos, next, d != dir), 0, k_max_step_cost);
+                const std::uint32_t next_state = next_cell * 4 + static_cast<std::uint32_t>(d);
+                if (m_state_stamp[next_state] == generation && m_g_cost[next_state] <= next_g)
+                    continue;
+                m_state_stamp[next_state] = generation;
+                m_g_cost[next_state] = next_g;
+                m_parent_dir[next_state] = static_cast<std::uint8_t>(dir);
+                push(next_state, next_g + heuristic(next, end));
+            }
+        }
+    }
+
+    return -1; // No path found
+}
+
+template <typename IsBlocked>
+bool OrthogonalRouter::cell_blocked(const IsBlocked& is_blocked, std::uint32_t cell, GridCoord pos) {
+    if constexpr (std::is_same_v<IsBlocked, OccupancyBitmap>) {
+        return m_packed.test(pos);
+    } else {
+        if (m_cell_stamp[cell] != m_generation) {
+            m_cell_stamp[cell] = m_generation;
+            m_blocked[cell] = is_blocked(pos);
+        }
+        return m_blocked[cell] != 0;
+    }
+}
+
+template <typename IsBlocked>
+int OrthogonalRouter::search_jumps(const Window& window, GridCoord start, GridCoord end,
+                                   const IsBlocked& is_blocked, PathSearchStats* stats,
+                                   std::vector<GridCoord>& path, bool& left_window) {
+    next_generation(window, true);
+    const std::uint32_t generation = m_generation;
+
+    auto fill_column = [&](std::int64_t cx) {
+        m_column_stamp[static_cast<std::size_t>(cx)] = generation;
+        for (int d = 0; d < 2; ++d) {
+            // Walk against d so each cell sees the run beyond it.
+            const std::int64_t first = d == 0 ? window.height - 1 : 0;
+            const std::int64_t last = d == 0 ? -1 : window.height;
+            const std::int64_t step = d == 0 ? -1 : 1;
+            std::int32_t run = 0;
+            for (std::int64_t cy = first; cy != last; cy += step) {
+                const auto cell = static_cast<std::uint32_t>(cy * window.width + cx);
+                m_runs[std::size_t{cell} * 4 + static_cast<std::size_t>(d)] = run;
+                run = cell_blocked(is_blocked, cell, window.coord(cell)) ? 0 : run + 1;
+            }
+        }
+        const auto x = static_cast<std::int32_t>(window.x0 + cx);
+        m_column_edge[static_cast<std::size_t>(cx)] = static_cast<std::uint8_t>(
+            (is_blocked(GridCoord{x, static_cast<std::int32_t>(window.y0 + window.height)}) ? 1u : 0u) |
+            (is_blocked(GridCoord{x, static_cast<std::int32_t>(window.y0 - 1)}) ? 2u : 0u));
+    };
+    auto fill_row = [&](std::int64_t cy) {
+        m_row_stamp[static_cast<std::size_t>(cy)] = generation;
+        for (int d = 2; d < 4; ++d) {
+            const std::int64_t first = d == 2 ? 0 : window.width - 1;
+            const std::int64_t last = d == 2 ? window.width : -1;
+            const std::int64_t step = d == 2 ? 1 : -1;
+            std::int32_t run = 0;
+            for (std::int64_t cx = first; cx != last; cx += step) {
+                const auto cell = static_cast<std::uint32_t>(cy * window.width + cx);
+                m_runs[std::size_t{cell} * 4 + static_cast<std::size_t>(d)] = run;
+                run = cell_blocked(is_blocked, cell, window.coord(cell)) ? 0 : run + 1;
+            }
+        }
+        const auto y = static_cast<std::int32_t>(window.y0 + cy);
+        m_row_edge[static_cast<std::size_t>(cy)] = static_cast<std::uint8_t>(
+            (is_blocked(GridCoord{static_cast<std::int32_t>(window.x0 - 1), y}) ? 4u : 0u) |
+            (is_blocked(GridCoord{static_cast<std::int32_t>(window.x0 + window.width), y}) ? 8u : 0u));
+    };
+    // Free cells after `pos` in direction d. A run that reaches a free cell
+    // past the window's edge may differ on the unbounded grid.
+    auto run = [&](int d, GridCoord pos) {
+        const std::int64_t cx = pos.x - window.x0;
+        const std::int64_t cy = pos.y - window.y0;
+        std::int64_t to_edge = 0;
+        std::uint8_t edge_blocked = 0;
+        if (d < 2) {
+            if (m_column_stamp[static_cast<std::size_t>(cx)] != generation)
+                fill_column(cx);
+            to_edge = d == 0 ? window.height - 1 - cy : cy;
+            edge_blocked = m_column_edge[static_cast<std::size_t>(cx)];
+        } else {
+            if (m_row_stamp[static_cast<std::size_t>(cy)] != generation)
+                fill_row(cy);
+            to_edge = d == 2 ? cx : window.width - 1 - cx;
+            edge_blocked = m_row_edge[static_cast<std::size_t>(cy)];
+        }
+        const std::int32_t result = m_runs[std::size_t{window.index(pos)} * 4 + static_cast<std::size_t>(d)];
+        if (result == to_edge && !(edge_blocked & (1u << d)))
+            left_window = true;
+        return result;
+    };
+    // Whether a path moving in d may usefully turn into u at pos.
+    auto turn_pays = [&](GridCoord pos, int d, int u) {
+        if (u < 2 ? pos.x == end.x : pos.y == end.y)
+            return true;
+        const GridCoord behind{pos.x - k_steps[d].x, pos.y - k_steps[d].y};
+        return run(u, pos) > run(u, behind);
+    };
+    // The next jump point from `from` in direction d, if any.
+    auto jump = [&](GridCoord from, int d) -> std::pair<bool, GridCoord> {
+        GridCoord pos = from;
+        for (;;) {
+            pos = {pos.x + k_steps[d].x, pos.y + k_steps[d].y};
+            if (!window.contains(pos)) {
+                if (!is_blocked(pos))
+                    left_window = true;
+                return {false, pos};
+            }
+            if (cell_blocked(is_blocked, window.index(pos), pos))
+                return {false, pos};
+            if (pos == end)
+                return {true, pos};
+            const int u = d < 2 ? 2 : 0;
+            if (turn_pays(pos, d, u) || turn_pays(pos, d, u + 1))
+                return {true, pos};
+        }
+    };
+
+    // Few nodes with widely spread costs: a binary heap suits better than
+    // the cell search's bucket ring.
+    using Entry = std::pair<int, std::uint32_t>; // f, state
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+    const std::uint32_t start_cell = window.index(start);
+    for (std::uint32_t d = 0; d < 4; ++d) {
+        const std::uint32_t state = start_cell * 4 + d;
+        m_state_stamp[state] = generation;
+        m_g_cost[state] = 0;
+        m_parent_state[state] = k_no_parent;
+        open.push({heuristic(start, end), state});
+    }
+
+    const std::uint32_t end_cell = window.index(end);
+    while (!open.empty()) {
+        const auto [f, state] = open.top();
+        open.pop();
+        const std::uint32_t cell = state / 4;
+        const auto dir = static_cast<int>(state % 4);
+        const GridCoord pos = window.coord(cell);
+        const int g = m_g_cost[state];
+        if (g + heuristic(pos, end) != f)
+            continue;
+        if (stats) ++stats->expanded;
+
+        if (cell == end_cell) {
+            trace_jumps(window, state, path);
+            return g;
+        }
+
+        // Start states leave straight; the other headings have their own.
+        const bool at_start = m_parent_state[state] == k_no_parent;
+        for (int d = 0; d < 4; ++d) {
+            if (d == (dir ^ 1) || (d != dir && (at_start || !turn_pays(pos, dir, d))))
+                continue;
+            const auto [found, next] = jump(pos, d);
+            if (!found)
+                continue;
+            const int steps = std::abs(next.x - pos.x) + std::abs(next.y - pos.y);
+            const int next_g = g + steps * k_path_move_cost + (d != dir ? k_path_turn_cost : 0);
+            const std::uint32_t next_state = window.index(next) * 4 + static_cast<std::uint32_t>(d);
+            if (m_state_stamp[next_state] == generation && m_g_cost[next_state] <= next_g)
+                continue;
+            m_state_stamp[next_state] = generation;
+            m_g_cost[next_state] = next_g;
+            m_parent_state[next_state] = state;
+            open.push({next_g + heuristic(next, end), next_state});
+        }
+    }
+
+    return -1; // No path found
+}
+
+// Finds an orthogonal path from start to end on a grid, with a throwaway
+// OrthogonalRouter; see there for the search.
+//
 // start: Starting grid coordinate.
 // end: Target grid coordinate.
 // is_blocked: Callback to check if a specific coordinate is blocked (obstacle).
 //             Note: The 'end' coordinate is NOT checked against obstacles to allow connecting to ports on modules.
 //
+// stats: Optional; accumulates search counters.
+//
 // Returns: A vector of grid coordinates representing the path (including start and end).
 //          Returns an empty vector if no path is found.
-std::vector<GridCoord> find_orthogonal_path(GridCoord start, GridCoord end, ObstacleCheck is_blocked);
+template <typename IsBlocked>
+std::vector<GridCoord> find_orthogonal_path(GridCoord start, GridCoord end, const IsBlocked& is_blocked,
+                                            PathSearchStats* stats = nullptr) {
+    OrthogonalRouter router;
+    return router.find_path(start, end, is_blocked, stats);
+}
 
 } // namespace netra
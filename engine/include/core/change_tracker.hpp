@@ -0,0 +1,51 @@
+#pragma once
+
+#include "entity.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace netra {
+
+// Per-storage record of which entities gained, changed or lost a component
+// since the last clear(). Enabled per component type with World::track<T>().
+//
+// Each list holds an entity at most once (deduplicated through a flag byte
+// per entity id). The three lists are independent: an entity added and then
+// removed in the same frame appears in both, so consumers must check the
+// current World state rather than infer it from list membership.
+//
+// "Modified" is only recorded by World::emplace on an existing component,
+// World::patch and World::mark_modified. Writes through World::get<T>() are
+// invisible to the tracker.
+class ChangeTracker {
+public:
+  void on_added(Entity entity);
+  void on_modified(Entity entity);
+  void on_removed(Entity entity);
+
+  std::span<const Entity> added() const;
+  std::span<const Entity> modified() const;
+  std::span<const Entity> removed() const;
+  bool empty() const;
+
+  // O(number of recorded changes), not O(entity count).
+  void clear();
+
+private:
+  enum Flag : std::uint8_t {
+    Added = 1 << 0,
+    Modified = 1 << 1,
+    Removed = 1 << 2,
+  };
+
+  bool mark(Entity entity, Flag flag);
+
+  std::vector<std::uint8_t> m_flags; // entity id -> Flag bits
+  std::vector<Entity> m_added;
+  std::vector<Entity> m_modified;
+  std::vector<Entity> m_removed;
+};
+
+} // namespace netra
@@ -3,11 +3,32 @@
 #include "entity.hpp"
 
 #include <types.hpp>
+#include <algorithm>
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <stdexcept>
 
 namespace netra {
 
+namespace detail {
+
+// Makes room for `extra` more elements. Reserving exactly size() + extra on
+// every batch would defeat vector's geometric growth and make a run of
+// small batches quadratic, so capacity at least doubles when it grows.
+template <typename U>
+void reserve_more(std::vector<U>& values, std::size_t extra) {
+    const std::size_t needed = values.size() + extra;
+    if (needed > values.capacity()) {
+        values.reserve(std::max(needed, 2 * values.capacity()));
+    }
+}
+
+} // namespace detail
+
 // Sparse set for O(1) lookup and cache-friendly iteration
 template<typename T>
 class ComponentStorage {
@@ -29,6 +50,40 @@ public:
         m_dense_components.push_back(std::move(component));
     }
 
+    // Bulk insert. The sparse array is grown once to the largest id in the
+    // batch and the dense arrays are reserved up front, so a batch of N costs
+    // at most one reallocation per array instead of log(N).
+    // Existing components are overwritten, matching insert().
+    void insert_many(std::span<const Entity> entities, std::span<const T> components) {
+        if (entities.size() != components.size()) {
+            throw std::invalid_argument("ComponentStorage::insert_many: size mismatch");
+        }
+        prepare_batch(entities);
+        for (std::size_t i = 0; i < entities.size(); ++i) {
+            insert(entities[i].id(), components[i]);
+        }
+    }
+
+    // Bulk insert of one value into every entity of the batch.
+    void insert_many(std::span<const Entity> entities, const T& component) {
+        prepare_batch(entities);
+        for (Entity entity : entities) {
+            insert(entity.id(), component);
+        }
+    }
+
+    // Reserve dense capacity for `count` components.
+    void reserve(std::size_t count) {
+        m_dense_entities.reserve(count);
+        m_dense_components.reserve(count);
+    }
+
+    // Make room for `count` more components, growing geometrically.
+    void reserve_more(std::size_t count) {
+        detail::reserve_more(m_dense_entities, count);
+        detail::reserve_more(m_dense_components, count);
+    }
+
     void remove(EntityID entity) {
         if (!contains(entity)) return;
 
@@ -68,6 +123,50 @@ public:
     auto end() const { return m_dense_components.end(); }
 
     const std::vector<EntityID>& entities() const { return m_dense_entities; }
+    // Dense components, parallel to entities().
+    std::span<const T> components() const { return m_dense_components; }
+
+    // Bulk-load raw bytes laid out as entities() and components() (e.g. a
+    // section of a memory-mapped design file). The dense arrays are filled
+    // with one memcpy each; only the sparse array needs a pass over the ids.
+    // The storage must be empty. Throws std::invalid_argument on size
+    // mismatch or repeated ids, leaving the storage empty.
+    void load_bytes(std::span<const std::byte> entity_bytes,
+                    std::span<const std::byte> component_bytes)
+        requires std::is_trivially_copyable_v<T>
+    {
+        if (!empty()) {
+            throw std::logic_error("ComponentStorage::load_bytes: storage not empty");
+        }
+        const std::size_t count = entity_bytes.size() / sizeof(EntityID);
+        if (entity_bytes.size() != count * sizeof(EntityID) ||
+            component_bytes.size() != count * sizeof(T)) {
+            throw std::invalid_argument("ComponentStorage::load_bytes: size mismatch");
+        }
+
+        m_dense_entities.resize(count);
+        m_dense_components.resize(count);
+        if (count > 0) {
+            std::memcpy(m_dense_entities.data(), entity_bytes.data(), entity_bytes.size());
+            std::memcpy(m_dense_components.data(), component_bytes.data(), component_bytes.size());
+        }
+
+        EntityID max_id = 0;
+        for (EntityID id : m_dense_entities) {
+            max_id = std::max(max_id, id);
+        }
+        if (count > 0 && max_id != INVALID) {
+            m_sparse.assign(static_cast<std::size_t>(max_id) + 1, INVALID);
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const EntityID id = m_dense_entities[i];
+            if (id == INVALID || m_sparse[id] != INVALID) {
+                clear();
+                throw std::invalid_argument("ComponentStorage::load_bytes: invalid or repeated entity");
+            }
+            m_sparse[id] = static_cast<EntityID>(i);
+        }
+    }
 
     // Iterate with entity ID
     template<typename Func>
@@ -84,6 +183,18 @@ public:
     }
 
 private:
+    void prepare_batch(std::span<const Entity> entities) {
+        EntityID max_id = 0;
+        for (Entity entity : entities) {
+            assert(entity.valid());
+            max_id = std::max(max_id, entity.id());
+        }
+        if (!entities.empty() && max_id >= m_sparse.size()) {
+            m_sparse.resize(static_cast<std::size_t>(max_id) + 1, INVALID);
+        }
+        reserve_more(entities.size());
+    }
+
     std::vector<EntityID> m_sparse;           // entity -> dense index
     std::vector<EntityID> m_dense_entities;   // dense index -> entity
     std::vector<T> m_dense_components;        // dense index -> component
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <grid_coord.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace netra {
+
+// One bit per cell of the unbounded grid, in square tiles of k_tile_side
+// cells allocated on first set and freed again once all of their cells are
+// free. A tile is one 64-bit word per row, so memory follows the occupied
+// area, not its bounding box: modules far apart cost two tiles each.
+//
+// Copies share tiles; set() and reset() copy a tile first if another
+// bitmap still holds it. Copying a bitmap costs a pointer per tile, so an
+// owner can hand a copy to another thread and keep editing its own. Const
+// use is thread-safe.
+//
+// Usable directly as an obstacle predicate for OrthogonalRouter, which
+// packs the part it searches with pack() instead of hashing every probe.
+class OccupancyBitmap {
+public:
+  static constexpr std::int32_t k_tile_bits = 6;
+  static constexpr std::int32_t k_tile_side = 1 << k_tile_bits;
+
+  // The cells of a rectangle, widened to whole tile columns, in one dense
+  // block of words row by row.
+  struct Packed {
+    GridCoord origin; // left edge on a tile boundary
+    std::size_t words_per_row = 0;
+    std::vector<std::uint64_t> words;
+
+    // `pos` must lie inside the packed rectangle.
+    bool test(GridCoord pos) const {
+      const auto x = static_cast<std::size_t>(std::int64_t{pos.x} - origin.x);
+      const auto y = static_cast<std::size_t>(std::int64_t{pos.y} - origin.y);
+      return (words[y * words_per_row + (x >> 6)] >> (x & 63)) & 1u;
+    }
+  };
+
+  void set(GridCoord pos);
+  void reset(GridCoord pos);
+
+  bool test(GridCoord pos) const {
+    const auto it = m_tiles.find(tile_of(pos));
+    if (it == m_tiles.end())
+      return false;
+    return ((*it->second)[row_in_tile(pos)] >> column_in_tile(pos)) & 1u;
+  }
+
+  bool operator()(GridCoord pos) const { return test(pos); }
+
+  // Copies the cells of `rect` (non-empty) into `out`, reusing its buffer.
+  // One hash per tile of `rect`.
+  void pack(const GridRect &rect, Packed &out) const;
+
+  // Tiles currently allocated.
+  std::size_t tile_count() const { return m_tiles.size(); }
+
+private:
+  // One word per row; bit i of a word is column i.
+  using Tile = std::array<std::uint64_t, k_tile_side>;
+
+  static GridCoord tile_of(GridCoord p) {
+    return {p.x >> k_tile_bits, p.y >> k_tile_bits};
+  }
+  static std::size_t row_in_tile(GridCoord p) {
+    return static_cast<std::size_t>(p.y & (k_tile_side - 1));
+  }
+  static std::uint32_t column_in_tile(GridCoord p) {
+    return static_cast<std::uint32_t>(p.x & (k_tile_side - 1));
+  }
+
+  // `tile`, copied first if another bitmap shares it.
+  Tile &writable_tile(std::shared_ptr<Tile> &tile);
+
+  std::unordered_map<GridCoord, std::shared_ptr<Tile>> m_tiles;
+};
+
+} // namespace netra
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "entity.hpp"
+
+#include <span>
+#include <vector>
+
+namespace netra {
+
+// Reverse index for an Entity-valued component field: target -> sources.
+// Example: for Port::owner, target is the module and sources are its ports.
+//
+// Storage is a flat vector indexed by target EntityID, so a lookup is one
+// bounds check and one indexed load; each bucket is a small vector whose size
+// is the target's degree. Buckets keep insertion order (unlink erases
+// in place) so iteration order is deterministic and matches link order.
+class RelationIndex {
+public:
+  // Record that `source` references `target`. Invalid targets are ignored.
+  void link(Entity target, Entity source);
+
+  // Remove one `source -> target` edge. Missing edges are ignored.
+  void unlink(Entity target, Entity source);
+
+  // Entities whose indexed field references `target`.
+  // The span is invalidated by any later link/unlink/clear.
+  std::span<const Entity> sources(Entity target) const;
+
+  void clear();
+
+private:
+  std::vector<std::vector<Entity>> m_sources; // target id -> sources
+};
+
+} // namespace netra
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <core/astar.hpp>
+#include <grid_coord.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stop_token>
+#include <unordered_map>
+#include <vector>
+
+namespace netra {
+
+// Search tree from one start, kept between queries: Dijkstra over (cell,
+// entry direction) states under the OrthogonalRouter cost model. A query for
+// an end resumes the search only until that end is settled, so while the
+// start stays put and the end wanders (the wiring preview), every state is
+// expanded at most once over all queries. Routes cost the same as
+// OrthogonalRouter's.
+//
+// The tree holds for one start and one set of obstacles: reset() when either
+// changes. States live in square pages allocated as the search reaches them,
+// so the tree grows over the unbounded grid without a window. Once
+// k_max_expanded states are expanded, queries that need more give up
+// (empty path, exhausted() set) instead of running unbounded.
+//
+// Not thread-safe.
+class RouteField {
+public:
+    static constexpr std::size_t k_max_expanded = std::size_t{1} << 24;
+
+    // Drops the tree and starts a new one at `start`.
+    void reset(GridCoord start);
+
+    bool has_start() const { return m_has_start; }
+    GridCoord start() const { return m_start; }
+    // States expanded since reset().
+    std::size_t expanded() const { return m_expanded; }
+    // A query stopped at k_max_expanded since reset().
+    bool exhausted() const { return m_exhausted; }
+
+    // Minimum-cost path from start() to `end`, as OrthogonalRouter::find_path
+    // would cost it; empty if `end` is blocked or unreachable, or the search
+    // gave up. `is_blocked` must describe the same obstacles on every call
+    // until the next reset(); it is probed once per state relaxation, so
+    // pass something cheap (an OccupancyBitmap). `stats` counts the states
+    // this call expanded. Once `stop` is requested the call returns an empty
+    // path between two expansions; the tree stays valid for later queries.
+    template <typename IsBlocked>
+    std::vector<GridCoord> path_to(GridCoord end, const IsBlocked& is_blocked, PathSearchStats* stats = nullptr,
+                                   std::stop_token stop = {});
+
+private:
+    static constexpr std::int32_t k_page_bits = 6;
+    static constexpr std::int32_t k_page_side = 1 << k_page_bits;
+    static constexpr std::size_t k_page_states = std::size_t{k_page_side} * k_page_side * 4;
+    static constexpr std::uint32_t k_unseen = std::numeric_limits<std::uint32_t>::max();
+    // Parent direction of the start states.
+    static constexpr std::uint8_t k_from_start = 4;
+    // Directions as in OrthogonalRouter: 0=up, 1=down, 2=left, 3=right.
+    static constexpr std::array<GridCoord, 4> k_steps = {{{0, 1}, {0, -1}, {-1, 0}, {1, 0}}};
+
+    struct Page {
+        Page() { g.fill(k_unseen); }
+        // Per state (cell in page * 4 + entry direction).
+        std::array<std::uint32_t, k_page_states> g;
+        std::array<std::uint8_t, k_page_states> parent_dir;
+    };
+
+    struct Entry {
+        GridCoord pos;
+        std::uint8_t dir;
+    };
+
+    static GridCoord page_of(GridCoord p) { return {p.x >> k_page_bits, p.y >> k_page_bits}; }
+    static std::size_t state_in_page(GridCoord p, int dir) {
+        const auto x = static_cast<std::size_t>(p.x & (k_page_side - 1));
+        const auto y = static_cast<std::size_t>(p.y & (k_page_side - 1));
+        return (y * k_page_side + x) * 4 + static_cast<std::size_t>(dir);
+    }
+
+    // Page holding `p`; nullptr if the search never reached it.
+    const Page* find_page(GridCoord p) const;
+    Page& page(GridCoord p);
+    std::uint32_t g_cost(GridCoord p, int dir) const;
+
+    void push(GridCoord p, int dir, std::uint32_t g);
+    // Cheapest settled or pending cost of reaching `end` in any direction.
+    std::uint32_t best_cost(GridCoord end, int& dir) const;
+    void trace_back(GridCoord end, int dir, std::vector<GridCoord>& path) const;
+
+    GridCoord m_start;
+    bool m_has_start = false;
+    bool m_exhausted = false;
+    std::size_t m_expanded = 0;
+
+    std::unordered_map<GridCoord, std::unique_ptr<Page>> m_pages;
+    // Last page looked up, to skip the hash on runs of nearby cells.
+    mutable GridCoord m_last_page_key;
+    mutable Page* m_last_page = nullptr;
+
+    // Monotone bucket queue keyed by g modulo the bucket count (one step
+    // adds at most move + turn). m_cost is the bucket being drained.
+    static constexpr std::size_t k_bucket_count = 64;
+    static_assert(k_bucket_count > k_path_move_cost + k_path_turn_cost);
+    std::array<std::vector<Entry>, k_bucket_count> m_buckets;
+    std::uint32_t m_cost = 0;
+    std::size_t m_pending = 0;
+};
+
+template <typename IsBlocked>
+std::vector<GridCoord> RouteField::path_to(GridCoord end, const IsBlocked& is_blocked, PathSearchStats* stats,
+                                           std::stop_token stop) {
+    std::vector<GridCoord> path;
+    if (!m_has_start)
+        return path;
+    if (end == m_start) {
+        path.push_back(end);
+        return path;
+    }
+    if (is_blocked(end))
+        return path;
+
+    int end_dir = 0;
+    std::uint32_t best = best_cost(end, end_dir);
+    // Everything still pending costs at least m_cost, so once m_cost reaches
+    // the best cost found for the end, that cost is final.
+    while (m_pending > 0 && m_cost < best) {
+        auto& bucket = m_buckets[m_cost % k_bucket_count];
+        if (bucket.empty()) {
+            ++m_cost;
+            continue;
+        }
+        const Entry entry = bucket.back();
+        if (g_cost(entry.pos, entry.dir) != m_cost) {
+            bucket.pop_back(); // superseded by a cheaper entry
+            --m_pending;
+            continue;
+        }
+        if (m_expanded >= k_max_expanded) {
+            m_exhausted = true;
+            return path;
+        }
+        if (stop.stop_requested())
+            return path;
+        bucket.pop_back();
+        --m_pending;
+        ++m_expanded;
+        if (stats) ++stats->expanded;
+
+        for (int d = 0; d < 4; ++d) {
+            if (d == (entry.dir ^ 1))
+                continue; // stepping back onto the previous cell never helps
+            const GridCoord next{entry.pos.x + k_steps[d].x, entry.pos.y + k_steps[d].y};
+            if (is_blocked(next))
+                continue;
+            const std::uint32_t next_g = m_cost + k_path_move_cost + (d != entry.dir ? k_path_turn_cost : 0);
+            Page& next_page = page(next);
+            const std::size_t state = state_in_page(next, d);
+            if (next_page.g[state] <= next_g)
+                continue;
+            next_page.g[state] = next_g;
+            next_page.parent_dir[state] = entry.dir;
+            push(next, d, next_g);
+            if (next == end && next_g < best) {
+                best = next_g;
+                end_dir = d;
+            }
+        }
+    }
+
+    if (best != k_unseen)
+        trace_back(end, end_dir, path);
+    return path;
+}
+
+} // namespace netra
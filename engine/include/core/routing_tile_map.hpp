@@ -0,0 +1,72 @@
+#pragma once
+
+#include <grid_coord.hpp>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace netra {
+
+// Coarse view of the routing grid: the canvas cut into square tiles, each
+// holding how many of its cells are blocked (passability) and how many wire
+// cells run through it (congestion). Tiles with nothing in them are not
+// stored, so the map stays sparse on an unbounded canvas.
+//
+// Counts are updated by adding and removing footprints, so a moved module
+// costs a few tile updates rather than a rebuild. Used by
+// LayoutSystem::route_wire_hierarchical to pick a corridor of tiles before
+// the fine search.
+class RoutingTileMap {
+public:
+  static constexpr std::int32_t k_default_tile_size = 16;
+
+  // Throws std::invalid_argument for a tile size below 1.
+  explicit RoutingTileMap(std::int32_t tile_size = k_default_tile_size);
+
+  std::int32_t tile_size() const { return m_tile_size; }
+
+  // Tile containing `cell` (floor division, so negative cells work).
+  GridCoord tile_of(GridCoord cell) const;
+  // Cells covered by `tile`.
+  GridRect cells_of(GridCoord tile) const;
+
+  void clear();
+
+  // Adds `count` blocked cells for every cell of `rect` (negative to take
+  // a footprint back out).
+  void add_blocked(const GridRect &rect, std::int32_t count = 1);
+  // Adds `count` wire cells at `cell`.
+  void add_wire_cell(GridCoord cell, std::int32_t count = 1);
+
+  std::int32_t blocked_cells(GridCoord tile) const;
+  std::int32_t wire_cells(GridCoord tile) const;
+  // A tile is passable while some of its cells are free.
+  bool passable(GridCoord tile) const;
+
+  // Cheapest chain of 4-connected passable tiles from the tile of `start`
+  // to the tile of `end`, both included (they count as passable even when
+  // full). Entering a tile costs its width plus surcharges for the share
+  // of blocked cells and for wire cells, so corridors prefer open,
+  // uncongested tiles. Searches the occupied tiles plus a one-tile margin,
+  // keeping state only for the tiles it reaches; empty if no chain exists
+  // there.
+  std::vector<GridCoord> find_corridor(GridCoord start, GridCoord end) const;
+
+  bool operator==(const RoutingTileMap &) const = default;
+
+private:
+  struct Tile {
+    std::int32_t blocked = 0;
+    std::int32_t wires = 0;
+
+    bool operator==(const Tile &) const = default;
+  };
+
+  void adjust(GridCoord tile, std::int32_t blocked, std::int32_t wires);
+
+  std::int32_t m_tile_size;
+  std::unordered_map<GridCoord, Tile> m_tiles;
+};
+
+} // namespace netra
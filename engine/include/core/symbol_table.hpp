@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace netra {
+
+// Interned string handle. Symbols compare and hash as integers and are only
+// meaningful within the SymbolTable (World) that produced them. The default
+// Symbol is the empty string.
+struct Symbol {
+  std::uint32_t id = 0;
+
+  bool operator==(const Symbol &) const = default;
+};
+
+// Append-only string pool: each distinct string is stored once and mapped to
+// a dense Symbol id. Ids are assigned in interning order starting at 1 (0 is
+// the empty string), so replaying the same strings rebuilds the same ids.
+//
+// Owned by World; there is no process-wide table. Not thread-safe: intern()
+// mutates, so do not call it from par_each bodies.
+class SymbolTable {
+public:
+  SymbolTable();
+  SymbolTable(const SymbolTable &other);
+  SymbolTable &operator=(const SymbolTable &other);
+  SymbolTable(SymbolTable &&) = default;
+  SymbolTable &operator=(SymbolTable &&) = default;
+
+  Symbol intern(std::string_view text);
+
+  // Lookup without interning.
+  std::optional<Symbol> find(std::string_view text) const;
+
+  // Throws std::out_of_range for a Symbol from another table.
+  std::string_view name(Symbol symbol) const;
+
+  bool contains(Symbol symbol) const { return symbol.id < m_names.size(); }
+  std::size_t size() const { return m_names.size(); }
+
+private:
+  // deque: elements never move, so the index's views stay valid.
+  std::deque<std::string> m_names;
+  std::unordered_map<std::string_view, Symbol> m_index;
+};
+
+} // namespace netra
+
+template <> struct std::hash<netra::Symbol> {
+  std::size_t operator()(const netra::Symbol &s) const noexcept {
+    return std::hash<std::uint32_t>{}(s.id);
+  }
+};
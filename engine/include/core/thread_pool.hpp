@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace netra {
+
+// Fixed-size worker pool for data-parallel loops.
+//
+// There is no global pool: the owner (application, benchmark, test) creates
+// one and passes it explicitly to the code that may run in parallel, so
+// threading is always visible at the call site. Workers sleep on a condition
+// variable between jobs and never run anything but parallel_for chunks.
+//
+// The calling thread participates in every job, so a pool of size 1 has no
+// workers and runs everything inline.
+class ThreadPool {
+public:
+  // thread_count includes the calling thread. 0 selects
+  // std::thread::hardware_concurrency().
+  explicit ThreadPool(std::size_t thread_count = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+
+  // Threads taking part in a job (workers + caller).
+  std::size_t size() const;
+
+  // Calls func(begin, end) for consecutive chunks of [0, count) and blocks
+  // until all chunks ran. Chunks run concurrently in unspecified order; func
+  // must be safe to call from several threads at once.
+  // The first exception thrown by func is rethrown here after all threads
+  // stopped taking chunks.
+  // Must not be called from inside func (the pool is not reentrant).
+  void parallel_for(std::size_t count, std::size_t chunk,
+                    const std::function<void(std::size_t, std::size_t)> &func);
+
+private:
+  void worker_loop(std::stop_token stop);
+  void run_chunks();
+
+  std::vector<std::jthread> m_workers;
+
+  std::mutex m_call_mutex; // serialises concurrent parallel_for callers
+  std::mutex m_mutex;      // guards the job fields below
+  std::condition_variable_any m_wake;
+  std::condition_variable m_done;
+
+  const std::function<void(std::size_t, std::size_t)> *m_job = nullptr;
+  std::size_t m_count = 0;
+  std::size_t m_chunk = 1;
+  std::uint64_t m_generation = 0;
+  std::size_t m_active = 0;
+  std::exception_ptr m_error;
+
+  // Next unclaimed index. Only used to hand out chunks; the job fields are
+  // published through m_mutex, so relaxed ordering is sufficient here.
+  std::atomic<std::size_t> m_next{0};
+};
+
+} // namespace netra
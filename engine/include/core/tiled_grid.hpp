@@ -0,0 +1,185 @@
+#pragma once
+
+#include <grid_coord.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace netra {
+
+// One T per cell of the unbounded grid, stored in square tiles of
+// k_tile_side cells allocated on first write. A default-constructed T is an
+// empty cell: cells never written read as empty, and a tile is freed again
+// once all of its cells are empty, so the grid stays sparse on a large
+// canvas while neighbouring cells share a tile (one hash per tile, not per
+// cell, and rows of a rectangle are contiguous).
+//
+// T must be cheap to copy and compare with ==. Not thread-safe, even for
+// reads: lookups remember the last tile.
+template <typename T> class TiledGrid {
+public:
+  static constexpr std::int32_t k_tile_bits = 6;
+  static constexpr std::int32_t k_tile_side = 1 << k_tile_bits;
+
+  // The cell at `p`, or nullptr if its tile is not allocated (the cell is
+  // empty).
+  const T *find(GridCoord p) const {
+    const Tile *tile = find_tile(tile_of(p));
+    return tile ? &tile->cells[cell_in_tile(p)] : nullptr;
+  }
+
+  // Calls fn(T &) on the cell at `p`.
+  template <typename F> void update(GridCoord p, F &&fn) {
+    update_rect({p, p}, [&fn](GridCoord, T &cell) { fn(cell); });
+  }
+
+  // Calls fn(GridCoord, T &) on every cell of `rect`, tile by tile and row
+  // by row within a tile. Empty rectangles are a no-op.
+  template <typename F> void update_rect(const GridRect &rect, F &&fn);
+
+  // Calls fn(GridCoord, const T &) on every non-empty cell, in no
+  // particular order.
+  template <typename F> void for_each(F &&fn) const;
+  // Calls fn(GridCoord, const T &) on every non-empty cell of `rect`.
+  // Unallocated tiles are skipped whole.
+  template <typename F> void for_each_in(const GridRect &rect, F &&fn) const;
+
+  void clear() {
+    m_tiles.clear();
+    m_last_tile = nullptr;
+  }
+
+  // Tiles currently allocated.
+  std::size_t tile_count() const { return m_tiles.size(); }
+
+private:
+  struct Tile {
+    std::array<T, std::size_t{k_tile_side} * k_tile_side> cells{};
+    std::size_t live = 0; // non-empty cells
+  };
+
+  static GridCoord tile_of(GridCoord p) {
+    return {p.x >> k_tile_bits, p.y >> k_tile_bits};
+  }
+  static std::size_t cell_in_tile(GridCoord p) {
+    const auto x = static_cast<std::size_t>(p.x & (k_tile_side - 1));
+    const auto y = static_cast<std::size_t>(p.y & (k_tile_side - 1));
+    return y * k_tile_side + x;
+  }
+
+  const Tile *find_tile(GridCoord key) const {
+    if (m_last_tile && m_last_key == key) {
+      return m_last_tile;
+    }
+    auto it = m_tiles.find(key);
+    if (it == m_tiles.end()) {
+      return nullptr;
+    }
+    m_last_key = key;
+    m_last_tile = it->second.get();
+    return m_last_tile;
+  }
+
+  Tile &tile(GridCoord key) {
+    if (const Tile *found = find_tile(key)) {
+      return *const_cast<Tile *>(found);
+    }
+    auto &slot = m_tiles[key];
+    slot = std::make_unique<Tile>();
+    m_last_key = key;
+    m_last_tile = slot.get();
+    return *slot;
+  }
+
+  std::unordered_map<GridCoord, std::unique_ptr<Tile>> m_tiles;
+  // Last tile looked up, to skip the hash on runs of nearby cells.
+  mutable GridCoord m_last_key;
+  mutable Tile *m_last_tile = nullptr;
+};
+
+template <typename T>
+template <typename F>
+void TiledGrid<T>::update_rect(const GridRect &rect, F &&fn) {
+  if (rect.max.x < rect.min.x || rect.max.y < rect.min.y) {
+    return;
+  }
+  const GridCoord first = tile_of(rect.min);
+  const GridCoord last = tile_of(rect.max);
+  for (std::int32_t ty = first.y; ty <= last.y; ++ty) {
+    for (std::int32_t tx = first.x; tx <= last.x; ++tx) {
+      const GridCoord key{tx, ty};
+      Tile &t = tile(key);
+      // The part of `rect` inside this tile.
+      const std::int32_t x0 = std::max(rect.min.x, tx * k_tile_side);
+      const std::int32_t x1 = std::min(rect.max.x, tx * k_tile_side + k_tile_side - 1);
+      const std::int32_t y0 = std::max(rect.min.y, ty * k_tile_side);
+      const std::int32_t y1 = std::min(rect.max.y, ty * k_tile_side + k_tile_side - 1);
+      for (std::int32_t y = y0; y <= y1; ++y) {
+        T *row = &t.cells[cell_in_tile({x0, y})];
+        for (std::int32_t x = x0; x <= x1; ++x, ++row) {
+          const bool was_live = !(*row == T{});
+          fn(GridCoord{x, y}, *row);
+          const bool is_live = !(*row == T{});
+          t.live = t.live + is_live - was_live;
+        }
+      }
+      if (t.live == 0) {
+        if (m_last_tile == &t) {
+          m_last_tile = nullptr;
+        }
+        m_tiles.erase(key);
+      }
+    }
+  }
+}
+
+template <typename T>
+template <typename F>
+void TiledGrid<T>::for_each_in(const GridRect &rect, F &&fn) const {
+  if (rect.max.x < rect.min.x || rect.max.y < rect.min.y) {
+    return;
+  }
+  const GridCoord first = tile_of(rect.min);
+  const GridCoord last = tile_of(rect.max);
+  for (std::int32_t ty = first.y; ty <= last.y; ++ty) {
+    for (std::int32_t tx = first.x; tx <= last.x; ++tx) {
+      const Tile *t = find_tile({tx, ty});
+      if (!t) {
+        continue;
+      }
+      const std::int32_t x0 = std::max(rect.min.x, tx * k_tile_side);
+      const std::int32_t x1 = std::min(rect.max.x, tx * k_tile_side + k_tile_side - 1);
+      const std::int32_t y0 = std::max(rect.min.y, ty * k_tile_side);
+      const std::int32_t y1 = std::min(rect.max.y, ty * k_tile_side + k_tile_side - 1);
+      for (std::int32_t y = y0; y <= y1; ++y) {
+        const T *row = &t->cells[cell_in_tile({x0, y})];
+        for (std::int32_t x = x0; x <= x1; ++x, ++row) {
+          if (!(*row == T{})) {
+            fn(GridCoord{x, y}, *row);
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+template <typename F>
+void TiledGrid<T>::for_each(F &&fn) const {
+  for (const auto &[key, tile] : m_tiles) {
+    for (std::size_t i = 0; i < tile->cells.size(); ++i) {
+      if (tile->cells[i] == T{}) {
+        continue;
+      }
+      fn(GridCoord{key.x * k_tile_side + static_cast<std::int32_t>(i % k_tile_side),
+                   key.y * k_tile_side + static_cast<std::int32_t>(i / k_tile_side)},
+         tile->cells[i]);
+    }
+  }
+}
+
+} // namespace netra
@@ -1,27 +1,62 @@
 #pragma once
 
+#include "change_tracker.hpp"
 #include "component_storage.hpp"
 #include "entity.hpp"
+#include "relation_index.hpp"
+#include "symbol_table.hpp"
+#include "thread_pool.hpp"
 #include <any>
+#include <cassert>
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <typeindex>
 #include <unordered_map>
 #include <concepts>
+#include <cstring>
+#include <vector>
 
 namespace netra {
 
+namespace detail {
+// Maps `Entity T::*` to its component type T (see World::index_relation).
+template <typename Field> struct relation_field;
+template <typename T> struct relation_field<Entity T::*> {
+  using component = T;
+};
+template <auto Field> struct relation_tag {};
+} // namespace detail
+
 class World {
 public:
   World() = default;
   ~World() = default;
 
-  World(const World &) = delete;
+  // Copies are explicit (clone()) so a World is never duplicated by accident.
   World &operator=(const World &) = delete;
   World(World &&) = default;
   World &operator=(World &&) = default;
 
+  // Deep copy of the whole World: entity table, every component storage,
+  // relation indices and change-tracking state (pending changes included).
+  // The copy shares nothing with the original, so each may be mutated or
+  // simulated on its own thread.
+  //
+  // Cost: O(total component bytes). Storages are std::vector copies, which
+  // become a single memmove for trivially-copyable components; components
+  // owning heap memory (strings, vectors) are copied element by element.
+  // Safe to call during par_each (read-only), but not concurrently with a
+  // structural change.
+  World clone() const {
+    World copy(*this);
+    copy.m_parallel_iterations = 0;
+    return copy;
+  }
+
   // Entity management
   Entity create() {
+    assert_structural_change_allowed();
     EntityID id;
     if (!m_free_ids.empty()) {
       id = m_free_ids.back();
@@ -33,16 +68,63 @@ public:
     return Entity(id);
   }
 
+  // Create `count` entities at once. Recycled ids are handed out first (same
+  // order as repeated create()), the remainder is a contiguous range of fresh
+  // ids. The alive set is grown once for the whole batch.
+  std::vector<Entity> create_many(std::size_t count) {
+    assert_structural_change_allowed();
+    std::vector<Entity> created;
+    created.reserve(count);
+    m_alive.reserve_more(count);
+
+    while (created.size() < count && !m_free_ids.empty()) {
+      created.emplace_back(m_free_ids.back());
+      m_free_ids.pop_back();
+    }
+    while (created.size() < count) {
+      created.emplace_back(m_next_id++);
+    }
+
+    m_alive.insert_many(created, true);
+    return created;
+  }
+
   void destroy(Entity entity) {
+    assert_structural_change_allowed();
     if (!alive(entity))
       return;
 
     m_alive.remove(entity.id());
     m_free_ids.push_back(entity.id());
 
-    // Remove all components for this entity
-    for (auto &[type, remover] : m_component_removers) {
-      remover(entity.id());
+    // Remove all components for this entity. The contains() probe is a sparse
+    // array read, so storages that never saw the entity cost no removal work.
+    for (auto &[type, entry] : m_storages) {
+      erase_component(entry, entity.id());
+    }
+  }
+
+  // Destroy a batch of entities. Dead or duplicate entries are ignored.
+  // Storages are visited once each (outer loop) instead of once per entity.
+  void destroy_many(std::span<const Entity> entities) {
+    assert_structural_change_allowed();
+    detail::reserve_more(m_free_ids, entities.size());
+    std::vector<EntityID> destroyed;
+    destroyed.reserve(entities.size());
+    for (Entity entity : entities) {
+      if (!alive(entity))
+        continue;
+      m_alive.remove(entity.id());
+      m_free_ids.push_back(entity.id());
+      destroyed.push_back(entity.id());
+    }
+
+    for (auto &[type, entry] : m_storages) {
+      if (entry.empty(entry.storage))
+        continue;
+      for (EntityID id : destroyed) {
+        erase_component(entry, id);
+      }
     }
   }
 
@@ -51,17 +133,195 @@ public:
   // Component management
   template <typename T, typename... Args>
   T &emplace(Entity entity, Args &&...args) {
-    auto &storage = get_or_create_storage<T>();
+    assert_structural_change_allowed();
+    auto &entry = get_or_create_entry<T>();
+    auto &storage = *std::any_cast<ComponentStorage<T>>(&entry.storage);
+    const bool existed = begin_write(entry, entity.id());
     storage.insert(entity.id(), T{std::forward<Args>(args)...});
+    end_write(entry, entity.id(), existed);
     return *storage.get(entity.id());
   }
 
-  template <typename T> void remove(Entity entity) {
-    if (auto *storage = get_storage<T>()) {
-      storage->remove(entity.id());
+  // Bulk emplace: one component per entity, spans must have equal length.
+  // Entities must be unique within the batch when T has indexed relations.
+  template <typename T>
+  void emplace_many(std::span<const Entity> entities,
+                    std::span<const T> components) {
+    assert_structural_change_allowed();
+    auto &entry = get_or_create_entry<T>();
+    auto existed = begin_write_many(entry, entities);
+    std::any_cast<ComponentStorage<T>>(&entry.storage)
+        ->insert_many(entities, components);
+    end_write_many(entry, entities, existed);
+  }
+
+  // Bulk emplace of the same value on every entity of the batch.
+  template <typename T>
+  void emplace_many(std::span<const Entity> entities, const T &component) {
+    assert_structural_change_allowed();
+    auto &entry = get_or_create_entry<T>();
+    auto existed = begin_write_many(entry, entities);
+    std::any_cast<ComponentStorage<T>>(&entry.storage)
+        ->insert_many(entities, component);
+    end_write_many(entry, entities, existed);
+  }
+
+  // Bulk-load T from raw bytes (see ComponentStorage::load_bytes). Meant for
+  // deserialisation into a fresh World: the storage of T must be empty.
+  // Throws std::invalid_argument if an id is repeated or not alive, leaving
+  // the storage empty.
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void emplace_bytes(std::span<const std::byte> entity_bytes,
+                     std::span<const std::byte> component_bytes) {
+    assert_structural_change_allowed();
+    // Before load_bytes, which sizes the sparse array by the largest id.
+    for (std::size_t offset = 0;
+         offset + sizeof(EntityID) <= entity_bytes.size();
+         offset += sizeof(EntityID)) {
+      EntityID id;
+      std::memcpy(&id, entity_bytes.data() + offset, sizeof(EntityID));
+      if (!m_alive.contains(id))
+        throw std::invalid_argument("World::emplace_bytes: entity not alive");
+    }
+    auto &entry = get_or_create_entry<T>();
+    auto &storage = *std::any_cast<ComponentStorage<T>>(&entry.storage);
+    storage.load_bytes(entity_bytes, component_bytes);
+    for (EntityID id : storage.entities()) {
+      end_write(entry, id, false);
+    }
+  }
+
+  // Mutate a component in place and keep relation indices and change
+  // tracking in sync. Returns false if the entity has no T.
+  template <typename T, typename Func> bool patch(Entity entity, Func &&func) {
+    assert_structural_change_allowed();
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    if (it == m_storages.end())
+      return false;
+    auto &entry = it->second;
+    auto *component =
+        std::any_cast<ComponentStorage<T>>(&entry.storage)->get(entity.id());
+    if (!component)
+      return false;
+    const bool existed = begin_write(entry, entity.id());
+    std::forward<Func>(func)(*component);
+    end_write(entry, entity.id(), existed);
+    return true;
+  }
+
+  // Change tracking (opt-in per component type).
+  //
+  // After track<T>(), every emplace/emplace_many/patch/remove/destroy of T is
+  // recorded in changes<T>() until clear_changes<T>(). Untracked storages pay
+  // one null check per write. In-place writes through get<T>() are not seen;
+  // report them with mark_modified<T>() or use patch<T>().
+  template <typename T> void track() {
+    assert_structural_change_allowed();
+    auto &entry = get_or_create_entry<T>();
+    if (!entry.tracker) {
+      entry.tracker.emplace();
     }
   }
 
+  template <typename T> bool tracked() const {
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    return it != m_storages.end() && it->second.tracker.has_value();
+  }
+
+  // Throws std::logic_error if T is not tracked.
+  template <typename T> const ChangeTracker &changes() const {
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    if (it == m_storages.end() || !it->second.tracker) {
+      throw std::logic_error("World::changes: component type not tracked");
+    }
+    return *it->second.tracker;
+  }
+
+  template <typename T> void clear_changes() {
+    assert_structural_change_allowed();
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    if (it != m_storages.end() && it->second.tracker) {
+      it->second.tracker->clear();
+    }
+  }
+
+  // Record an in-place write made through get<T>(). No-op when untracked or
+  // when the entity has no T.
+  template <typename T> void mark_modified(Entity entity) {
+    assert_structural_change_allowed();
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    if (it == m_storages.end() || !it->second.tracker)
+      return;
+    if (it->second.contains(it->second.storage, entity.id())) {
+      it->second.tracker->on_modified(entity);
+    }
+  }
+
+  // Relationship indices.
+  //
+  // index_relation<&Port::owner>() maintains a reverse index from the value
+  // of an Entity-valued field to the entities holding it, so
+  // related<&Port::owner>(module) returns the module's ports in O(degree).
+  // The index follows emplace/emplace_many/patch/remove/destroy.
+  //
+  // WARNING: writing the field through get<T>() bypasses the index and leaves
+  // it stale. Indexed fields must be changed through patch<T>() or emplace.
+  //
+  // Registration is idempotent and backfills from existing components, so
+  // every system registers the relations it queries.
+  template <auto Field> void index_relation() {
+    assert_structural_change_allowed();
+    using T = typename detail::relation_field<decltype(Field)>::component;
+    auto &entry = get_or_create_entry<T>();
+    const std::type_index key(typeid(detail::relation_tag<Field>));
+    if (find_binding(entry, key))
+      return;
+
+    RelationBinding binding{
+        key,
+        [](const std::any &s, EntityID id) -> Entity {
+          return std::any_cast<ComponentStorage<T>>(&s)->get(id)->*Field;
+        },
+        {}};
+    const auto &storage = *std::any_cast<ComponentStorage<T>>(&entry.storage);
+    for (EntityID id : storage.entities()) {
+      binding.index.link(storage.get(id)->*Field, Entity(id));
+    }
+    entry.relations.push_back(std::move(binding));
+  }
+
+  // Entities whose indexed field references `target`, in link order.
+  // Throws std::logic_error if the relation was never registered.
+  // The span is invalidated by any structural change to the component T.
+  template <auto Field>
+  std::span<const Entity> related(Entity target) const {
+    using T = typename detail::relation_field<decltype(Field)>::component;
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    const RelationBinding *binding =
+        it == m_storages.end()
+            ? nullptr
+            : find_binding(it->second,
+                           std::type_index(typeid(detail::relation_tag<Field>)));
+    if (!binding) {
+      throw std::logic_error("World::related: relation not indexed");
+    }
+    return binding->index.sources(target);
+  }
+
+  // Pre-size the storage of T for `count` components.
+  template <typename T> void reserve(std::size_t count) {
+    get_or_create_storage<T>().reserve(count);
+  }
+
+  template <typename T> void remove(Entity entity) {
+    assert_structural_change_allowed();
+    auto it = m_storages.find(std::type_index(typeid(T)));
+    if (it == m_storages.end())
+      return;
+    erase_component(it->second, entity.id());
+  }
+
   template <typename T> T *get(Entity entity) {
     if (auto *storage = get_storage<T>()) {
       return storage->get(entity.id());
@@ -90,6 +350,12 @@ public:
     }
   }
 
+  // Parallel iteration - single component. See View::par_each for the rules.
+  template <typename T, typename Func>
+  void par_each(ThreadPool &pool, Func &&func) {
+    view<T>().par_each(pool, std::forward<Func>(func));
+  }
+
   // View - iterate entities with specific components
   template <typename... Components> class View {
   public:
@@ -108,6 +374,39 @@ public:
         }
       }
     }
+    // Parallel each(). The dense range of the first component's storage is
+    // split into chunks that run concurrently on `pool`; func is called at
+    // most once per matching entity, in unspecified order.
+    //
+    // Rules while par_each runs:
+    // - func may read any component and write only the components it was
+    //   handed for its own entity.
+    // - No structural change: create/destroy, emplace/remove, patch,
+    //   index_relation, track/clear_changes/mark_modified. In debug builds
+    //   these assert; in release builds they are data races.
+    //
+    // `chunk` is the number of dense entries per task; the default keeps
+    // scheduling overhead low for small per-entity work.
+    template <typename Func>
+    void par_each(ThreadPool &pool, Func &&func, std::size_t chunk = 1024) {
+      auto *first_storage = m_world.get_storage<
+          std::tuple_element_t<0, std::tuple<Components...>>>();
+      if (!first_storage)
+        return;
+
+      const auto &ids = first_storage->entities();
+      ParallelScope scope(m_world);
+      pool.parallel_for(ids.size(), chunk,
+                        [&](std::size_t begin, std::size_t end) {
+                          for (std::size_t i = begin; i < end; ++i) {
+                            Entity entity(ids[i]);
+                            if ((m_world.has<Components>(entity) && ...)) {
+                              func(entity, *m_world.get<Components>(entity)...);
+                            }
+                          }
+                        });
+    }
+
     template <typename Pred>
         requires std::is_invocable_r_v<bool, Pred, Entity, Components&...>
         std::optional<Entity> find_first(Pred&& predicate) {
@@ -154,39 +453,185 @@ public:
     auto it = m_storages.find(std::type_index(typeid(T)));
     if (it == m_storages.end())
       return nullptr;
-    return std::any_cast<ComponentStorage<T>>(&it->second);
+    return std::any_cast<ComponentStorage<T>>(&it->second.storage);
   }
 
   template <typename T> const ComponentStorage<T> *get_storage() const {
     auto it = m_storages.find(std::type_index(typeid(T)));
     if (it == m_storages.end())
       return nullptr;
-    return std::any_cast<ComponentStorage<T>>(&it->second);
+    return std::any_cast<ComponentStorage<T>>(&it->second.storage);
   }
 
   std::size_t entity_count() const { return m_alive.size(); }
 
+  // Ids of all living entities, in unspecified order.
+  std::span<const EntityID> alive_ids() const { return m_alive.entities(); }
+
+  // One past the largest id ever handed out. A fresh World given
+  // create_many(id_bound()) reproduces the same id range.
+  EntityID id_bound() const { return m_next_id; }
+
+  // Names used by components (Port::name, ModuleDef::name, ...). Symbols are
+  // per World; clone() copies the table, so symbols stay valid in the copy.
+  Symbol intern(std::string_view text) { return m_symbols.intern(text); }
+  std::string_view name(Symbol symbol) const { return m_symbols.name(symbol); }
+  const SymbolTable &symbols() const { return m_symbols; }
+
 private:
-  template <typename T> ComponentStorage<T> &get_or_create_storage() {
+  World(const World &) = default;
+
+  // Marks the World as being iterated by par_each. Only the thread that
+  // started the iteration writes the counter, and workers read it after
+  // synchronising through the pool's mutex, so a plain integer suffices.
+  // The member exists in all builds to keep the layout independent of NDEBUG.
+  class ParallelScope {
+  public:
+    explicit ParallelScope(World &world) : m_world(world) {
+      ++m_world.m_parallel_iterations;
+    }
+    ~ParallelScope() { --m_world.m_parallel_iterations; }
+    ParallelScope(const ParallelScope &) = delete;
+    ParallelScope &operator=(const ParallelScope &) = delete;
+
+  private:
+    World &m_world;
+  };
+
+  void assert_structural_change_allowed() const {
+    assert(m_parallel_iterations == 0 &&
+           "structural World change during par_each");
+  }
+
+  // Reverse index for one Entity-valued field of a component.
+  struct RelationBinding {
+    std::type_index field;
+    Entity (*read)(const std::any &, EntityID);
+    RelationIndex index;
+  };
+
+  // Type-erased storage plus the operations destroy() needs on it.
+  // Plain function pointers operating on the stored std::any: no captured
+  // World pointer (survives World moves) and no std::function indirection.
+  struct StorageEntry {
+    std::any storage;
+    bool (*contains)(const std::any &, EntityID) = nullptr;
+    bool (*empty)(const std::any &) = nullptr;
+    void (*remove)(std::any &, EntityID) = nullptr;
+    std::vector<RelationBinding> relations;
+    std::optional<ChangeTracker> tracker;
+
+    bool observed() const { return !relations.empty() || tracker; }
+  };
+
+  static const RelationBinding *find_binding(const StorageEntry &entry,
+                                             std::type_index field) {
+    for (const auto &binding : entry.relations) {
+      if (binding.field == field)
+        return &binding;
+    }
+    return nullptr;
+  }
+
+  // Write hooks. begin_write() runs before a component is inserted or
+  // mutated in place and returns whether it already existed; end_write()
+  // relinks relation indices and records the change. Both return immediately
+  // for storages with no indexed relation and no tracker.
+  static bool begin_write(StorageEntry &entry, EntityID id) {
+    if (!entry.observed() || !entry.contains(entry.storage, id))
+      return false;
+    for (auto &binding : entry.relations) {
+      binding.index.unlink(binding.read(entry.storage, id), Entity(id));
+    }
+    return true;
+  }
+
+  static void end_write(StorageEntry &entry, EntityID id, bool existed) {
+    if (!entry.observed())
+      return;
+    for (auto &binding : entry.relations) {
+      binding.index.link(binding.read(entry.storage, id), Entity(id));
+    }
+    if (entry.tracker) {
+      if (existed) {
+        entry.tracker->on_modified(Entity(id));
+      } else {
+        entry.tracker->on_added(Entity(id));
+      }
+    }
+  }
+
+  static std::vector<bool> begin_write_many(StorageEntry &entry,
+                                            std::span<const Entity> entities) {
+    if (!entry.observed())
+      return {};
+    std::vector<bool> existed(entities.size());
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+      existed[i] = begin_write(entry, entities[i].id());
+    }
+    return existed;
+  }
+
+  static void end_write_many(StorageEntry &entry,
+                             std::span<const Entity> entities,
+                             const std::vector<bool> &existed) {
+    if (!entry.observed())
+      return;
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+      end_write(entry, entities[i].id(), existed[i]);
+    }
+  }
+
+  // Removes the entity's component (if any), unlinking relations and
+  // recording the removal first.
+  static void erase_component(StorageEntry &entry, EntityID id) {
+    if (!entry.contains(entry.storage, id))
+      return;
+    for (auto &binding : entry.relations) {
+      binding.index.unlink(binding.read(entry.storage, id), Entity(id));
+    }
+    if (entry.tracker) {
+      entry.tracker->on_removed(Entity(id));
+    }
+    entry.remove(entry.storage, id);
+  }
+
+  template <typename T> static StorageEntry make_entry() {
+    StorageEntry entry;
+    entry.storage = ComponentStorage<T>{};
+    entry.contains = [](const std::any &s, EntityID id) {
+      return std::any_cast<ComponentStorage<T>>(&s)->contains(id);
+    };
+    entry.empty = [](const std::any &s) {
+      return std::any_cast<ComponentStorage<T>>(&s)->empty();
+    };
+    entry.remove = [](std::any &s, EntityID id) {
+      std::any_cast<ComponentStorage<T>>(&s)->remove(id);
+    };
+    return entry;
+  }
+
+  template <typename T> StorageEntry &get_or_create_entry() {
     auto type = std::type_index(typeid(T));
     auto it = m_storages.find(type);
     if (it == m_storages.end()) {
-      m_storages[type] = ComponentStorage<T>{};
-      m_component_removers[type] = [this](EntityID id) {
-        if (auto *s = get_storage<T>())
-          s->remove(id);
-      };
+      it = m_storages.emplace(type, make_entry<T>()).first;
     }
-    return *std::any_cast<ComponentStorage<T>>(&m_storages[type]);
+    return it->second;
+  }
+
+  template <typename T> ComponentStorage<T> &get_or_create_storage() {
+    return *std::any_cast<ComponentStorage<T>>(
+        &get_or_create_entry<T>().storage);
   }
 
   EntityID m_next_id = 0;
   std::vector<EntityID> m_free_ids;
   ComponentStorage<bool> m_alive;
+  SymbolTable m_symbols;
 
-  std::unordered_map<std::type_index, std::any> m_storages;
-  std::unordered_map<std::type_index, std::function<void(EntityID)>>
-      m_component_removers;
+  std::unordered_map<std::type_index, StorageEntry> m_storages;
+  int m_parallel_iterations = 0;
 };
 
 } // namespace netra
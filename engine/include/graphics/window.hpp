@@ -9,7 +9,9 @@ namespace netra::graphics {
 
 class Window {
 public:
-    Window(int width, int height, const std::string& title);
+    // A window created with visible = false still has a default framebuffer
+    // to render into and read back (benchmarks, headless runs under Xvfb).
+    Window(int width, int height, const std::string& title, bool visible = true);
     ~Window();
 
     Window(const Window&) = delete;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace netra::io {
+
+// Output file for text formats. Appends go to an in-memory buffer that is
+// handed to stdio in large blocks, so writers can emit tokens one at a time.
+// A failed write is remembered and reported by finish().
+class BufferedWriter {
+public:
+  // Returns std::nullopt if the file cannot be created.
+  static std::optional<BufferedWriter> open(const std::filesystem::path &path);
+
+  BufferedWriter &put(std::string_view text) {
+    m_buffer.append(text);
+    if (m_buffer.size() >= k_flush_threshold)
+      flush();
+    return *this;
+  }
+
+  BufferedWriter &put(char c) { return put(std::string_view(&c, 1)); }
+
+  // Integers and floats via std::to_chars (shortest round-trip for floats).
+  template <typename T> BufferedWriter &number(T value) {
+    std::array<char, 32> digits;
+    auto [end, ec] =
+        std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    return put(std::string_view(digits.data(), end - digits.data()));
+  }
+
+  // Flushes everything. Returns false if any write failed.
+  bool finish();
+
+private:
+  static constexpr std::size_t k_flush_threshold = 64 * 1024;
+
+  struct FileCloser {
+    void operator()(std::FILE *file) const { std::fclose(file); }
+  };
+
+  explicit BufferedWriter(std::FILE *file);
+  void flush();
+
+  std::unique_ptr<std::FILE, FileCloser> m_file;
+  std::string m_buffer;
+  bool m_ok = true;
+};
+
+} // namespace netra::io
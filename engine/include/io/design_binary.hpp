@@ -0,0 +1,47 @@
+#pragma once
+
+#include <core/world.hpp>
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+
+namespace netra::io {
+
+enum class BinaryError : std::uint8_t {
+  OpenFailed,         // file could not be opened/created
+  WriteFailed,        // short write (disk full, I/O error)
+  BadMagic,           // not a Netra design file
+  UnsupportedVersion, // format version or byte order differs from this build
+  Truncated,          // a header or section runs past the end of the file
+  Corrupt,            // structurally valid but inconsistent contents
+};
+
+const char *to_string(BinaryError error);
+
+// Binary design format (.netra).
+//
+// The file is a 24-byte header followed by tagged sections, each payload
+// aligned to 8 bytes:
+// - entity table: alive ids + id bound, so entity ids survive a round trip
+// - one section per design component: dense entity ids followed by the
+//   dense component array, exactly as ComponentStorage holds them
+// - the World's symbol table and entity/coordinate pools for variable-size
+//   fields
+//
+// Trivially-copyable components (ModuleExtent, ModulePixelPosition,
+// PortOffset, PortVisual, PortGridPosition, WireJunction) are stored raw and
+// loaded from the memory-mapped file with one memcpy per array, without any
+// per-element parsing. Components holding strings or vectors are stored as
+// fixed-size records that reference the symbol table and pools.
+//
+// The format is host-endian and records sizeof() of each raw component, so a
+// file from a different byte order or ABI is rejected instead of misread.
+// Simulation state (BitValue) is not part of a design and is not written.
+std::expected<void, BinaryError> save_binary(const World &world,
+                                             const std::filesystem::path &path);
+
+std::expected<World, BinaryError>
+load_binary(const std::filesystem::path &path);
+
+} // namespace netra::io
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <core/world.hpp>
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <string>
+
+namespace netra::io {
+
+struct TextError {
+  std::size_t line = 0; // 1-based; 0 for file-level errors (open, write)
+  std::string message;
+};
+
+// Text design format (.netra.txt).
+//
+// Line-oriented and diff-friendly: one block per entity, one line per
+// component, entities in ascending id order. Entity references are ids
+// ('-' for none), strings are double-quoted with \" \\ \n \t escapes, and
+// '#' starts a comment line.
+//
+//   netra-design 1
+//   bound 7
+//   entity 0
+//     def "AND" primitive -
+//     extent 3 2
+//   entity 2
+//     inst "u1" 0
+//     pixel 40 20
+//     shader "AND"
+//   entity 4
+//     port "A" in 1 2 3
+//     offset 0 1
+//   entity 3
+//     signal "net_a" 1 - 4
+//   entity 6
+//     wire 3 5 4 7,3 7,5 4,5
+//     junction 1
+//
+// Components: def, inst, port, signal, hierarchy, shader, wire, extent,
+// pixel, offset, side, grid, junction. The id bound and the entity table
+// are stored so that ids survive a round trip, like the binary format.
+//
+// The loader reads the file through a fixed-size buffer and tokenizes each
+// line in place, so memory use is bounded by the design, not the file, and
+// allocations happen only for the strings and lists the components own.
+std::expected<void, TextError> save_text(const World &world,
+                                         const std::filesystem::path &path);
+
+std::expected<World, TextError>
+load_text(const std::filesystem::path &path);
+
+} // namespace netra::io
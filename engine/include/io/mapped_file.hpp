@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace netra::io {
+
+// Read-only view of a whole file.
+//
+// On POSIX systems the file is memory-mapped, so opening is O(1) and pages
+// are faulted in only when touched. Elsewhere the file is read into an owned
+// buffer once. Either way bytes() stays valid for the lifetime of the object.
+class MappedFile {
+public:
+  // Returns std::nullopt if the file cannot be opened or mapped.
+  static std::optional<MappedFile> open(const std::filesystem::path &path);
+
+  ~MappedFile();
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  std::span<const std::byte> bytes() const;
+  // The same bytes viewed as characters, for text formats.
+  std::string_view text() const;
+
+private:
+  MappedFile() = default;
+  void release();
+
+  void *m_region = nullptr; // mmap region, null when not mapped
+  std::size_t m_size = 0;
+  std::vector<char> m_fallback; // owned copy when mapping is unavailable
+};
+
+} // namespace netra::io
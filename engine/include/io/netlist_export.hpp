@@ -0,0 +1,46 @@
+#pragma once
+
+#include <core/world.hpp>
+
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace netra::io {
+
+struct ExportError {
+  std::string message;
+};
+
+// Netlist export for external synthesis and equivalence checking.
+//
+// Modules written:
+// - every non-primitive ModuleDef, with its interface Ports (owned by the
+//   def) and the instances whose Hierarchy parent is the def;
+// - a synthesized top module `top_name` for instances without a parent
+//   (what the editor creates). Its interface is inferred: nets with no
+//   driving output port become inputs, driven nets nobody reads become
+//   outputs, and unconnected input pins get their own input.
+//
+// Primitive defs named AND/OR/NAND/NOR/XOR/XNOR/NOT/BUF map to gate
+// primitives (Verilog) or .names truth tables (BLIF). Any other primitive is
+// written as an instance of an external cell of that name. Nets are
+// identified by Port::connected_signal and named after their Signal,
+// uniquified per module. Signals named 1'b0 / 1'b1 are written as constants.
+//
+// Output is streamed through a BufferedWriter. Ports are grouped by owner
+// and instances by parent with counting sorts over entity ids, so the
+// export is linear in the number of ports, instances and signals.
+std::expected<void, ExportError>
+export_verilog(const World &world, const std::filesystem::path &path,
+               std::string_view top_name = "top");
+
+// BLIF has no buses: nets wider than one bit and inout ports are rejected.
+// The synthesized top (or else the first uninstantiated module) is written
+// first, since BLIF takes the first .model as the root.
+std::expected<void, ExportError>
+export_blif(const World &world, const std::filesystem::path &path,
+            std::string_view top_name = "top");
+
+} // namespace netra::io
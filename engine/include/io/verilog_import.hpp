@@ -0,0 +1,52 @@
+#pragma once
+
+#include <core/world.hpp>
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace netra::io {
+
+struct VerilogError {
+  std::size_t line = 0; // 1-based; 0 for file-level errors
+  std::string message;
+};
+
+// Structural (gate-level) Verilog import.
+//
+// Every `module` becomes a non-primitive ModuleDef with its interface Ports
+// (owned by the def) and one Signal per net, scoped to the def. Inside a
+// module:
+// - gate primitives (and, or, nand, nor, xor, xnor, not, buf) become
+//   ModuleInsts of a primitive ModuleDef shared per gate type; an existing
+//   primitive def of the same name in the World is reused. Ports are named
+//   A, B, C... for inputs and Y for the output, like the editor's gates.
+// - instances of other modules become ModuleInsts with one Port per port of
+//   the instantiated module, connected by name or by position.
+// - `assign a = b;` between nets merges them into a single Signal.
+// - constants (1'b0, 4'hA, ...) become Signals with an initial BitValue.
+//
+// Hierarchy: a def's Hierarchy lists its interface ports and instances; an
+// instance's Hierarchy has the enclosing def as parent and its ports as
+// children.
+//
+// Behavioural code, bit- and part-selects (a[3], a[7:4]), concatenations,
+// expressions in assign and instance arrays are rejected with an error: a
+// Signal cannot be sliced. Bit-blasted netlists that name each bit with an
+// escaped identifier (\a[3] ) import as one net per bit.
+//
+// The whole input is parsed before the World is touched, so on error the
+// World is left unchanged. On success the entities are created in one
+// create_many() and each component type is added with one emplace_many().
+// Returns the ModuleDefs of the imported modules in source order.
+std::expected<std::vector<Entity>, VerilogError>
+import_verilog(World &world, const std::filesystem::path &path);
+
+std::expected<std::vector<Entity>, VerilogError>
+import_verilog_source(World &world, std::string_view source);
+
+} // namespace netra::io
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <core/thread_pool.hpp>
+#include <core/world.hpp>
+#include <systems/layout_system.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace netra {
+
+struct AutorouteOptions {
+  // Rip-up and reroute rounds before giving up on nets that still overlap.
+  int max_iterations = 40;
+  // Free cells kept around the design for routes to detour through.
+  std::int32_t margin = 16;
+  // Nets handed to a thread at a time.
+  std::size_t chunk = 2;
+};
+
+struct AutorouteReport {
+  std::size_t nets = 0;        // unrouted nets found
+  std::size_t routed_nets = 0; // nets that got wires
+  std::size_t wires = 0;       // wires created (one per pin-to-pin connection)
+  std::size_t overflow_cells = 0; // edges and cells still overused
+  int iterations = 0;
+  std::int64_t wirelength = 0; // unit steps over all created wires
+  std::int64_t bends = 0;      // direction changes over all created wires
+  std::size_t expanded = 0;    // search nodes over all iterations
+  double seconds = 0.0;
+};
+
+// Routes every Signal that has no Wire yet and connects two or more ports
+// with a PortGridPosition, PathFinder style (negotiated congestion).
+//
+// Each net is split into pin-to-pin connections along a minimum spanning
+// tree of its pins (Manhattan distance). Wires may cross, so nets overlap
+// only where they run along the same edge between two cells, or where one
+// bends in a cell another passes through. The first round routes every net
+// around the layout's obstacles only; every later round rips up the nets
+// that overlap and routes them again with
+// OrthogonalRouter::find_weighted_path, where a step costs the history of
+// what it takes (rounds it was overused in) plus a present-sharing penalty
+// that grows every round, until nothing overlaps or max_iterations is
+// reached. A connection is searched for within its net's padded bounding
+// box first, and across the whole area only if that fails.
+//
+// Nets are rerouted in batches whose padded bounding boxes do not overlap;
+// a batch runs in parallel on `pool` and the congestion counts are updated
+// between batches, so the result does not depend on the thread count.
+//
+// Nets that route without overlapping get one Wire per connection (points: the
+// whole path, both pins included); nets left overlapping or without a path
+// get none. The new wires are added to the layout's spatial index.
+AutorouteReport autoroute(World &world, LayoutSystem &layout, ThreadPool &pool,
+                          const AutorouteOptions &options = {});
+
+} // namespace netra
@@ -1,8 +1,21 @@
 #pragma once
 
+#include <components/render_components.hpp>
+#include <core/astar.hpp>
+#include <core/occupancy_bitmap.hpp>
+#include <core/route_field.hpp>
+#include <core/routing_tile_map.hpp>
+#include <core/tiled_grid.hpp>
 #include <core/world.hpp>
 #include <graphics/grid.hpp>
 
+#include <array>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace netra {
 
 // Computes derived positions for modules and ports.
@@ -16,6 +29,24 @@ namespace netra {
 // - Call update_ports() to refresh PortGridPosition for all ports
 class LayoutSystem {
 public:
+  // Layers of the spatial index: how an entity occupies a cell. Module
+  // bodies and wires block routes; the padding ring around a module blocks
+  // them only where no port sits.
+  enum class Layer : std::uint8_t { Module, Padding, Port, Wire };
+
+  // Neighbours a wire runs on to from a cell (Occupant::links).
+  static constexpr std::uint8_t k_link_up = 1; // +y
+  static constexpr std::uint8_t k_link_down = 2;
+  static constexpr std::uint8_t k_link_left = 4;
+  static constexpr std::uint8_t k_link_right = 8;
+
+  // One entity in one cell of the spatial index.
+  struct Occupant {
+    Entity entity;
+    Layer layer = Layer::Module;
+    std::uint8_t links = 0; // wires only: k_link_* bits
+  };
+
   explicit LayoutSystem(World &world, const graphics::Grid &grid);
 
   // Compute module pixel position from an anchor port that was just snapped.
@@ -37,29 +68,170 @@ public:
   bool is_cell_blocked(GridCoord pos, bool checks_module = true,
                        bool checks_wire = true) const;
 
+  // Spatial queries, over the index as of the last update. Every entity
+  // that covers a cell is kept, so overlapping wires and modules are all
+  // found. Calls fn(const Occupant &) for each entity at `pos`, the most
+  // recently indexed first.
+  template <typename F> void for_each_occupant(GridCoord pos, F &&fn) const;
+  // Wires with a point at `pos`: passing, crossing, bending or ending.
+  std::vector<Entity> wires_at(GridCoord pos) const;
+  // The module whose body covers `pos` (the most recently indexed if
+  // several do), or Entity{}.
+  Entity module_at(GridCoord pos) const;
+  // The port at `pos` (the most recently indexed if several), or Entity{}.
+  Entity port_at(GridCoord pos) const;
+  // Each entity on `layer` with a cell in `rect`, once, in no particular
+  // order. Costs the indexed part of `rect`, not the whole world.
+  std::vector<Entity> entities_in(const GridRect &rect, Layer layer) const;
+
   // Find an orthogonal path from start to end avoiding obstacles.
-  // Uses A* pathfinding.
-  std::vector<GridCoord> route_wire(GridCoord start, GridCoord end) const;
+  // Uses A* pathfinding (see OrthogonalRouter) over the occupancy bitmap
+  // kept with the spatial index: cells blocked by modules or wires as of
+  // the last index update. `stats` accumulates search counters. `search`
+  // picks cell-by-cell A* or jump point search; both give minimum-cost
+  // routes, jump points with far fewer expansions on long ones.
+  std::vector<GridCoord> route_wire(GridCoord start, GridCoord end,
+                                    PathSearchStats *stats = nullptr,
+                                    RouteSearch search = RouteSearch::Cells) const;
+
+  // route_wire for a start that stays put while the end moves, as in the
+  // wiring preview: routes of the same cost, but the search tree from
+  // `start` is kept (see RouteField) and only extended as far as each new
+  // end needs. The tree is dropped when the start or the index changes.
+  // Falls back to route_wire when the tree outgrows its limit.
+  std::vector<GridCoord> preview_route(GridCoord start, GridCoord end,
+                                       PathSearchStats *stats = nullptr) const;
+
+  // Two-level variant of route_wire for long routes on large canvases:
+  // picks a corridor of tiles on tile_map() first, then runs the fine
+  // search confined to that corridor (plus one tile around it), in legs
+  // of a few tiles joined at free cells. Never expands the whole fine grid,
+  // but the route is only as good as the corridor: not always minimum-cost.
+  // Falls back to route_wire when the corridor turns out to be a dead end.
+  std::vector<GridCoord>
+  route_wire_hierarchical(GridCoord start, GridCoord end,
+                          PathSearchStats *stats = nullptr,
+                          RouteSearch search = RouteSearch::Cells) const;
 
-  // Rebuilds the internal spatial index of obstacles.
-  // Should be called when modules are moved or wires are created/deleted.
+  // Rebuilds the internal spatial index of obstacles from every module,
+  // port and wire in the world. Edits that touch a few entities are
+  // cheaper through index_entity() and unindex_entity(). Also the way to
+  // pick up a World whose contents were replaced wholesale.
   void rebuild_spatial_index();
 
+  // Adds a module, port or wire to the spatial index where it is now, or
+  // moves it there if it is already indexed; a module's ports are
+  // re-indexed with it. Costs the cells the entity covers, not a rebuild.
+  // update_module_from_anchor() calls this for the module it moved.
+  void index_entity(Entity e);
+  // Takes an entity (and a module's ports) back out of the spatial index.
+  // Call before destroying it; unindexed entities are ignored.
+  void unindex_entity(Entity e);
+
+  // Per-tile blocked and wire cell counts behind route_wire_hierarchical,
+  // kept up to date with the spatial index.
+  const RoutingTileMap &tile_map() const { return m_tiles; }
+
+  // Bumped whenever the obstacles route_wire sees change.
+  std::uint64_t index_version() const { return m_index_version; }
+
+  // The obstacles route_wire sees, as of index_version(). Immutable: an
+  // index update edits a copy while a snapshot is held, so the snapshot
+  // can be routed over on another thread while the editor keeps going
+  // (see PreviewRouter).
+  std::shared_ptr<const OccupancyBitmap> occupancy_snapshot() const {
+    return m_occupancy;
+  }
+
 private:
-  World &m_world;
-  const graphics::Grid &m_grid;
+  // Grid origin of a module from its pixel position.
+  GridCoord grid_origin(const ModulePixelPosition &pixel_pos) const;
+  // Module cells plus the one-cell padding ring the spatial index blocks.
+  static GridRect padded_footprint(GridCoord origin, const ModuleExtent &ext);
+
+  static constexpr std::uint32_t k_no_occupant = ~std::uint32_t{0};
+
+  // One cell of the index: occupants counted per layer, so blocking is a
+  // lookup, and listed (a chain through m_occupant_nodes), so queries see
+  // every entity. All zero / empty for a free cell.
+  struct IndexCell {
+    std::array<std::uint16_t, 4> count{};
+    std::uint32_t first = k_no_occupant;
 
-  // Spatial index: maps grid coordinates to the entity occupying it.
-  // Using unordered_map for infinite grid support while keeping lookup O(1).
-  // If vector<vector> is strictly required for performance, we would need
-  // defined bounds. For now, this satisfies the "spatial index" requirement
-  // functionally. Key: GridCoord (hashed), Value: Entity (ModuleInst or Wire)
-  struct GridCoordHash {
-    std::size_t operator()(const GridCoord &c) const {
-      return std::hash<int>()(c.x) ^ (std::hash<int>()(c.y) << 1);
+    std::uint16_t &operator[](Layer layer) {
+      return count[static_cast<std::size_t>(layer)];
     }
+    std::uint16_t operator[](Layer layer) const {
+      return count[static_cast<std::size_t>(layer)];
+    }
+    bool module_blocked() const {
+      return (*this)[Layer::Module] > 0 ||
+             ((*this)[Layer::Padding] > 0 && (*this)[Layer::Port] == 0);
+    }
+    bool wire_blocked() const { return (*this)[Layer::Wire] > 0; }
+    bool operator==(const IndexCell &) const = default;
+  };
+
+  struct OccupantNode {
+    Occupant occupant;
+    std::uint32_t next = k_no_occupant;
   };
-  std::unordered_map<GridCoord, Entity, GridCoordHash> m_spatial_map;
+
+  // What an indexed entity added, so it can be taken back out exactly.
+  struct IndexedEntity {
+    std::vector<std::pair<GridCoord, Occupant>> cells; // ports and wires
+    // Modules: the padded footprint, stamped as the body rectangle and
+    // the ring around it, and counted in m_tiles.
+    std::optional<GridRect> footprint;
+  };
+
+  // Index updates without the version bump; `bitmap` false defers the
+  // bitmap to the caller (rebuild_spatial_index packs it once at the end).
+  void add_to_index(Entity e, bool bitmap);
+  void remove_from_index(Entity e, bool bitmap);
+  void stamp_module(Entity module, const GridRect &footprint, bool add,
+                    bool bitmap);
+  // Adds `occupant` to every cell of `rect`, or takes it out (`add` false).
+  void update_cells(const GridRect &rect, const Occupant &occupant, bool add,
+                    bool bitmap);
+  // m_occupancy, copied first if a snapshot of it is held elsewhere.
+  OccupancyBitmap &writable_occupancy();
+
+  World &m_world;
+  const graphics::Grid &m_grid;
+
+  // Spatial index: every occupied cell, in tiles allocated as entities
+  // reach them; the occupant lists' nodes (free ones chained from
+  // m_free_node); and what each indexed entity added.
+  TiledGrid<IndexCell> m_spatial_map;
+  std::vector<OccupantNode> m_occupant_nodes;
+  std::uint32_t m_free_node = k_no_occupant;
+  std::unordered_map<Entity, IndexedEntity> m_indexed;
+
+  // Every blocked cell of m_spatial_map as one bit, for route_wire's
+  // searches. Edited in place only while no snapshot shares it.
+  std::shared_ptr<OccupancyBitmap> m_occupancy;
+  std::uint64_t m_index_version = 0;
+
+  // Coarse counts for route_wire_hierarchical.
+  RoutingTileMap m_tiles;
+
+  // Search buffers reused by route_wire (scratch, hence mutable; route_wire
+  // is not safe to call concurrently).
+  mutable OrthogonalRouter m_router;
+
+  // preview_route's search tree and the index version it was grown on.
+  mutable RouteField m_preview_field;
+  mutable std::uint64_t m_preview_version = 0;
 };
 
+template <typename F>
+void LayoutSystem::for_each_occupant(GridCoord pos, F &&fn) const {
+  const IndexCell *cell = m_spatial_map.find(pos);
+  for (std::uint32_t n = cell ? cell->first : k_no_occupant;
+       n != k_no_occupant; n = m_occupant_nodes[n].next) {
+    fn(m_occupant_nodes[n].occupant);
+  }
+}
+
 } // namespace netra
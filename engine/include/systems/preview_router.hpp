@@ -0,0 +1,97 @@
+#pragma once
+
+#include <core/astar.hpp>
+#include <core/occupancy_bitmap.hpp>
+#include <core/route_field.hpp>
+#include <grid_coord.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace netra {
+
+// Routes the wiring preview on a worker thread, so a slow search never holds
+// up a frame.
+//
+// The editor posts the latest (start, end) with an immutable obstacle
+// snapshot (LayoutSystem::occupancy_snapshot()) and, every frame, draws the
+// latest() finished route. A new request replaces one still waiting and
+// cancels the one being routed: only the newest mouse position matters.
+//
+// The worker grows one RouteField per start and snapshot version, like
+// LayoutSystem::preview_route, and falls back to OrthogonalRouter when the
+// field gives up. A cancelled field query leaves the tree intact, so the
+// work done for a superseded request still serves the next one.
+//
+// Owns its thread: construct it where the editor can see it; the destructor
+// cancels the current search and joins.
+class PreviewRouter {
+public:
+  struct Result {
+    GridCoord start;
+    GridCoord end;
+    std::uint64_t version = 0; // snapshot version the route was found on
+    std::vector<GridCoord> path;
+  };
+
+  PreviewRouter();
+  ~PreviewRouter();
+
+  PreviewRouter(const PreviewRouter &) = delete;
+  PreviewRouter &operator=(const PreviewRouter &) = delete;
+
+  // Asks for a route from start to end around `obstacles`, which must not
+  // change while shared (LayoutSystem swaps in a new bitmap instead).
+  // `version` identifies the snapshot: equal versions must mean equal
+  // obstacles. Does nothing if this request is already pending or running.
+  void request(GridCoord start, GridCoord end,
+               std::shared_ptr<const OccupancyBitmap> obstacles,
+               std::uint64_t version);
+
+  // The most recently finished route, if any. Cancelled requests never
+  // finish, so this can trail the newest request by a few frames.
+  std::optional<Result> latest() const;
+
+  // States expanded by every search so far, cancelled ones included.
+  PathSearchStats stats() const;
+
+  // Blocks until every request posted so far has finished or was
+  // cancelled.
+  void wait_idle();
+
+private:
+  struct Request {
+    GridCoord start;
+    GridCoord end;
+    std::shared_ptr<const OccupancyBitmap> obstacles;
+    std::uint64_t version = 0;
+  };
+
+  void worker_loop(std::stop_token stop);
+  std::vector<GridCoord> route(const Request &request, std::stop_token cancel,
+                               PathSearchStats &stats);
+
+  mutable std::mutex m_mutex; // guards everything below up to m_worker
+  std::condition_variable_any m_wake;
+  std::condition_variable m_idle;
+  std::optional<Request> m_pending;
+  std::optional<Request> m_running; // being routed, for duplicate checks
+  std::stop_source m_cancel;        // of the running request
+  std::optional<Result> m_latest;
+  PathSearchStats m_stats;
+
+  // Worker-only search state.
+  RouteField m_field;
+  std::uint64_t m_field_version = 0;
+  OrthogonalRouter m_router;
+
+  std::jthread m_worker; // last: starts after, and stops before, the rest
+};
+
+} // namespace netra
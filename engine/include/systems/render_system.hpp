@@ -6,19 +6,36 @@
 #include <editor_state.hpp>
 #include <graphics/grid.hpp>
 #include <graphics/shader.hpp>
+#include <systems/layout_system.hpp>
 
 #include <glad.h>
 #include <glm/vec2.hpp>
+#include <cstddef>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace netra {
 
+// GL work issued by the last render_region() call, counted at the call sites.
+// A uniform set is a location lookup plus the glUniform* call.
+struct RenderStats {
+  std::size_t draw_calls = 0;
+  std::size_t vertices = 0;
+  std::size_t program_binds = 0;
+  std::size_t vao_binds = 0;
+  std::size_t uniform_sets = 0;
+  std::size_t buffer_uploads = 0;
+  std::size_t uploaded_bytes = 0;
+};
+
 // ECS-driven render system.
 // Iterates world components and issues OpenGL draw calls.
 class RenderSystem {
 public:
-  RenderSystem(World &world, graphics::Grid &grid, EditorState &editor);
+  RenderSystem(World &world, graphics::Grid &grid, EditorState &editor,
+               const LayoutSystem &layout);
   ~RenderSystem();
 
   RenderSystem(const RenderSystem &) = delete;
@@ -31,10 +48,18 @@ public:
   void render_region(glm::vec2 viewport_size, int x, int y, int width,
                      int height, Entity dragging_module = Entity{});
 
+  const RenderStats &last_frame_stats() const { return m_stats; }
+
+  // Symbols are per World: call after replacing the World's contents (for
+  // example with a loaded design) to intern the shader keys again.
+  void rebind_shader_keys();
+
 private:
   World &m_world;
   graphics::Grid &m_grid;
   EditorState &m_editor;
+  // Committed wires, for crossing lookups.
+  const LayoutSystem &m_layout;
 
   // Gate quad: [-1,1] with UVs for SDF shaders
   GLuint m_gate_vao = 0;
@@ -48,8 +73,10 @@ private:
   GLuint m_line_vao = 0;
   GLuint m_line_vbo = 0;
 
-  // Shaders keyed by ShaderKey::key (e.g., "AND", "OR")
-  std::unordered_map<std::string, graphics::Shader> m_shaders;
+  // Shaders keyed by ShaderKey::key (interned "AND", "OR", ...), and the
+  // name each key was interned from.
+  std::unordered_map<Symbol, graphics::Shader> m_shaders;
+  std::vector<std::pair<std::string, Symbol>> m_shader_names;
 
   //Wire triangle vertices
   std::vector<float> triangle_vertices;
@@ -62,6 +89,8 @@ private:
   graphics::Shader m_port_shader;
   graphics::Shader m_wire_shader;
 
+  RenderStats m_stats;
+
   void setup_gate_quad();
   void setup_quad();
   void setup_wire_mesh();
@@ -71,8 +100,6 @@ private:
   void render_ports(const glm::mat4 &view_proj, glm::vec2 viewport_size,
                     Entity dragging_module);
   void render_wires(const glm::mat4 &view_proj, glm::vec2 viewport_size);
-  void collect_committed_segments(WireSegments &segments, Entity e,
-                                  const Wire &wire);
   void collect_preview_segments(WireSegments &segments, Entity e,
                                 const Wire &wire);
 
@@ -2,27 +2,51 @@
 
 #include "core/world.hpp"
 #include "components/components.hpp"
+#include <array>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace netra {
 
 using BehaviorFunc = std::function<void(const std::vector<BitValue>&, std::vector<BitValue>&)>;
 
+// Evaluates primitive instances. Built-in gates (GateType) are dispatched
+// through a switch on the PrimitiveOp cached on their def and folded over
+// any number of inputs; other primitives call a BehaviorFunc looked up by
+// def name.
 class Simulation {
 public:
     explicit Simulation(World& world);
     
+    // Enables the inline evaluation of a built-in gate.
+    void register_gate(GateType type);
+    // Custom behaviour for primitives named `name`; takes precedence over a
+    // built-in gate of the same name.
     void register_primitive(const std::string& name, BehaviorFunc func);
     void step();
     void run(std::size_t cycles);
 
 private:
+    GateType opcode_of(Entity def_entity, const ModuleDef& def);
+    void evaluate_gate(GateType type, Entity instance);
+    void evaluate_custom(const BehaviorFunc& func, Entity instance);
+
     World& m_world;
-    std::unordered_map<std::string, BehaviorFunc> m_primitives;
+    std::array<bool, static_cast<std::size_t>(GateType::COUNT)> m_gates{};
+    // Keyed by interned def name: lookups in step() hash an integer.
+    std::unordered_map<Symbol, BehaviorFunc> m_primitives;
+    std::vector<Entity> m_output_ports; // scratch for evaluate_gate
 };
 
+// Built-in gate of a primitive def name ("AND", "NOT", ...), or INVALID.
+GateType gate_type_of(std::string_view name);
+// Primitive def name of a built-in gate; the inverse of gate_type_of.
+// Throws std::invalid_argument for INVALID and COUNT.
+std::string_view gate_name(GateType type);
+
 namespace primitives {
     void register_basic_gates(Simulation& sim);
 }
@@ -1,103 +1,109 @@
 #include <core/astar.hpp>
-#include <queue>
-#include <unordered_map>
-#include <cmath>
-#include <algorithm>
-#include <limits>
 
 namespace netra {
 
 namespace {
 
-struct Node {
-    GridCoord pos;
-    GridCoord parent_pos; // For path reconstruction
-    int g_cost;           // Cost from start
-    int h_cost;           // Heuristic to end
-    int direction;        // Direction entered from: 0=none, 1=up, 2=down, 3=left, 4=right
-
-    int f_cost() const { return g_cost + h_cost; }
-
-    bool operator>(const Node& other) const {
-        return f_cost() > other.f_cost();
-    }
-};
-
-// Simple hash for GridCoord to use in unordered_map
-struct GridCoordHash {
-    std::size_t operator()(const GridCoord& c) const {
-        return std::hash<int>()(c.x) ^ (std::hash<int>()(c.y) << 1);
-    }
-};
-
-int manhattan_distance(GridCoord a, GridCoord b) {
-    return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+int direction_of(GridCoord from, GridCoord to) {
+    if (to.x == from.x)
+        return to.y > from.y ? 0 : 1;
+    return to.x < from.x ? 2 : 3;
 }
 
 } // namespace
 
-std::vector<GridCoord> find_orthogonal_path(GridCoord start, GridCoord end, ObstacleCheck is_blocked) {
-    if (start.x == end.x && start.y == end.y) {
-        return {start};
+int orthogonal_path_cost(const std::vector<GridCoord>& path) {
+    int cost = 0;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        cost += k_path_move_cost;
+        if (i >= 2 && direction_of(path[i - 2], path[i - 1]) != direction_of(path[i - 1], path[i]))
+            cost += k_path_turn_cost;
     }
-    if(is_blocked(end)) return {};
-
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> open_set;
-    std::unordered_map<GridCoord, int, GridCoordHash> best_g_cost;
-    std::unordered_map<GridCoord, GridCoord, GridCoordHash> came_from;
-
-    open_set.push({start, start, 0, manhattan_distance(start, end), 0});
-    best_g_cost[start] = 0;
-
-    const int MOVE_COST = 1;
-    const int TURN_PENALTY = 50;
+    return cost;
+}
 
-    // Directions: 0=up, 1=down, 2=left, 3=right
-    const GridCoord dirs[] = {{0, 1}, {0, -1}, {-1, 0}, {1, 0}};
-    const int dir_ids[] = {1, 2, 3, 4}; // IDs matching dirs array
+OrthogonalRouter::Window OrthogonalRouter::window_around(GridCoord start, GridCoord end, std::int64_t margin) {
+    Window window;
+    window.x0 = std::int64_t{std::min(start.x, end.x)} - margin;
+    window.y0 = std::int64_t{std::min(start.y, end.y)} - margin;
+    window.width = std::abs(std::int64_t{start.x} - end.x) + 2 * margin + 1;
+    window.height = std::abs(std::int64_t{start.y} - end.y) + 2 * margin + 1;
+    return window;
+}
 
-    while (!open_set.empty()) {
-        Node current = open_set.top();
-        open_set.pop();
+std::int64_t OrthogonalRouter::outside_bound(GridCoord start, GridCoord end, std::int64_t margin) {
+    // A path through a cell outside the window walks past the bounding box
+    // by margin + 1 and back, and turns to come back.
+    return heuristic(start, end) + 2 * (margin + 1) * k_path_move_cost + k_path_turn_cost;
+}
 
-        if (current.pos.x == end.x && current.pos.y == end.y) {
-            // Reconstruct path
-            std::vector<GridCoord> path;
-            GridCoord curr = end;
-            while (curr.x != start.x || curr.y != start.y) {
-                path.push_back(curr);
-                curr = came_from[curr];
-            }
-            path.push_back(start);
-            std::reverse(path.begin(), path.end());
-            return path;
+void OrthogonalRouter::next_generation(const Window& window, bool jumps) {
+    const std::size_t cells = window.cells();
+    if (m_cell_stamp.size() < cells) {
+        m_cell_stamp.resize(cells, 0);
+        m_blocked.resize(cells, 0);
+        m_state_stamp.resize(cells * 4, 0);
+        m_g_cost.resize(cells * 4, 0);
+        m_parent_dir.resize(cells * 4, 0);
+    }
+    if (jumps) {
+        if (m_runs.size() < cells * 4) {
+            m_runs.resize(cells * 4, 0);
+            m_parent_state.resize(cells * 4, 0);
         }
+        const auto width = static_cast<std::size_t>(window.width);
+        const auto height = static_cast<std::size_t>(window.height);
+        if (m_column_stamp.size() < width) {
+            m_column_stamp.resize(width, 0);
+            m_column_edge.resize(width, 0);
+        }
+        if (m_row_stamp.size() < height) {
+            m_row_stamp.resize(height, 0);
+            m_row_edge.resize(height, 0);
+        }
+    }
+    if (++m_generation == 0) {
+        std::ranges::fill(m_cell_stamp, 0u);
+        std::ranges::fill(m_state_stamp, 0u);
+        std::ranges::fill(m_column_stamp, 0u);
+        std::ranges::fill(m_row_stamp, 0u);
+        m_generation = 1;
+    }
+    for (auto& bucket : m_buckets)
+        bucket.clear();
+}
 
-        for (int i = 0; i < 4; ++i) {
-            GridCoord neighbor_pos{current.pos.x + dirs[i].x, current.pos.y + dirs[i].y};
-
-            bool is_target = (neighbor_pos.x == end.x && neighbor_pos.y == end.y);
-            if (!is_target && is_blocked(neighbor_pos)) {
-                continue;
-            }
-
-            int new_turn_penalty = 0;
-            if (current.direction != 0 && current.direction != dir_ids[i]) {
-                new_turn_penalty = TURN_PENALTY;
-            }
-
-            int new_g_cost = current.g_cost + MOVE_COST + new_turn_penalty;
+void OrthogonalRouter::trace_back(const Window& window, GridCoord end, std::uint32_t state,
+                                  std::vector<GridCoord>& path) const {
+    path.clear();
+    GridCoord p = end;
+    for (;;) {
+        path.push_back(p);
+        const std::uint8_t parent = m_parent_dir[state];
+        if (parent == k_from_start)
+            break;
+        const GridCoord step = k_steps[state % 4];
+        p = {p.x - step.x, p.y - step.y};
+        state = window.index(p) * 4 + parent;
+    }
+    std::ranges::reverse(path);
+}
 
-            if (best_g_cost.find(neighbor_pos) == best_g_cost.end() || new_g_cost < best_g_cost[neighbor_pos]) {
-                best_g_cost[neighbor_pos] = new_g_cost;
-                came_from[neighbor_pos] = current.pos;
-                int h = manhattan_distance(neighbor_pos, end) * MOVE_COST; // Scale H to match G scale
-                open_set.push({neighbor_pos, current.pos, new_g_cost, h, dir_ids[i]});
-            }
+void OrthogonalRouter::trace_jumps(const Window& window, std::uint32_t state, std::vector<GridCoord>& path) const {
+    path.clear();
+    GridCoord p = window.coord(state / 4);
+    path.push_back(p);
+    // Jump points are joined by straight runs; fill in the cells between.
+    while (m_parent_state[state] != k_no_parent) {
+        const GridCoord step = k_steps[state % 4];
+        state = m_parent_state[state];
+        const GridCoord stop = window.coord(state / 4);
+        while (!(p == stop)) {
+            p = {p.x - step.x, p.y - step.y};
+            path.push_back(p);
         }
     }
-
-    return {}; // No path found
+    std::ranges::reverse(path);
 }
 
 } // namespace netra
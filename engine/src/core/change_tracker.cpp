@@ -0,0 +1,52 @@
+#include "core/change_tracker.hpp"
+
+namespace netra {
+
+bool ChangeTracker::mark(Entity entity, Flag flag) {
+  if (entity.id() >= m_flags.size()) {
+    m_flags.resize(static_cast<std::size_t>(entity.id()) + 1, 0);
+  }
+  auto &bits = m_flags[entity.id()];
+  if (bits & flag)
+    return false;
+  bits = static_cast<std::uint8_t>(bits | flag);
+  return true;
+}
+
+void ChangeTracker::on_added(Entity entity) {
+  if (mark(entity, Added))
+    m_added.push_back(entity);
+}
+
+void ChangeTracker::on_modified(Entity entity) {
+  if (mark(entity, Modified))
+    m_modified.push_back(entity);
+}
+
+void ChangeTracker::on_removed(Entity entity) {
+  if (mark(entity, Removed))
+    m_removed.push_back(entity);
+}
+
+std::span<const Entity> ChangeTracker::added() const { return m_added; }
+
+std::span<const Entity> ChangeTracker::modified() const { return m_modified; }
+
+std::span<const Entity> ChangeTracker::removed() const { return m_removed; }
+
+bool ChangeTracker::empty() const {
+  return m_added.empty() && m_modified.empty() && m_removed.empty();
+}
+
+void ChangeTracker::clear() {
+  for (const auto *list : {&m_added, &m_modified, &m_removed}) {
+    for (Entity entity : *list) {
+      m_flags[entity.id()] = 0;
+    }
+  }
+  m_added.clear();
+  m_modified.clear();
+  m_removed.clear();
+}
+
+} // namespace netra
@@ -0,0 +1,68 @@
+#include "core/occupancy_bitmap.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace netra {
+
+void OccupancyBitmap::set(GridCoord pos) {
+  std::shared_ptr<Tile> &tile = m_tiles[tile_of(pos)];
+  if (!tile) {
+    tile = std::make_shared<Tile>();
+  }
+  writable_tile(tile)[row_in_tile(pos)] |= std::uint64_t{1}
+                                           << column_in_tile(pos);
+}
+
+void OccupancyBitmap::reset(GridCoord pos) {
+  const auto it = m_tiles.find(tile_of(pos));
+  if (it == m_tiles.end() ||
+      !(((*it->second)[row_in_tile(pos)] >> column_in_tile(pos)) & 1u)) {
+    return;
+  }
+  Tile &tile = writable_tile(it->second);
+  tile[row_in_tile(pos)] &= ~(std::uint64_t{1} << column_in_tile(pos));
+  if (std::ranges::all_of(tile, [](std::uint64_t word) { return word == 0; })) {
+    m_tiles.erase(it);
+  }
+}
+
+void OccupancyBitmap::pack(const GridRect &rect, Packed &out) const {
+  const GridCoord first = tile_of(rect.min);
+  const GridCoord last = tile_of(rect.max);
+  out.origin = {first.x * k_tile_side, rect.min.y};
+  out.words_per_row = static_cast<std::size_t>(last.x - first.x + 1);
+  out.words.assign(out.words_per_row *
+                       static_cast<std::size_t>(rect.max.y - rect.min.y + 1),
+                   0);
+  for (std::int32_t ty = first.y; ty <= last.y; ++ty) {
+    const std::int32_t y0 = std::max(rect.min.y, ty * k_tile_side);
+    const std::int32_t y1 = std::min(rect.max.y, ty * k_tile_side + k_tile_side - 1);
+    for (std::int32_t tx = first.x; tx <= last.x; ++tx) {
+      const auto it = m_tiles.find({tx, ty});
+      if (it == m_tiles.end()) {
+        continue;
+      }
+      const auto column = static_cast<std::size_t>(tx - first.x);
+      for (std::int32_t y = y0; y <= y1; ++y) {
+        out.words[static_cast<std::size_t>(y - rect.min.y) * out.words_per_row +
+                  column] = (*it->second)[row_in_tile({0, y})];
+      }
+    }
+  }
+}
+
+OccupancyBitmap::Tile &
+OccupancyBitmap::writable_tile(std::shared_ptr<Tile> &tile) {
+  if (tile.use_count() > 1) {
+    tile = std::make_shared<Tile>(*tile);
+  } else {
+    // use_count() is a relaxed load. A thread that dropped its copy
+    // released the count after its last read of the tile; this fence pairs
+    // with that release, so those reads happen before our writes.
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *tile;
+}
+
+} // namespace netra
@@ -0,0 +1,34 @@
+#include "core/relation_index.hpp"
+
+#include <algorithm>
+
+namespace netra {
+
+void RelationIndex::link(Entity target, Entity source) {
+  if (!target.valid())
+    return;
+  if (target.id() >= m_sources.size()) {
+    m_sources.resize(static_cast<std::size_t>(target.id()) + 1);
+  }
+  m_sources[target.id()].push_back(source);
+}
+
+void RelationIndex::unlink(Entity target, Entity source) {
+  if (!target.valid() || target.id() >= m_sources.size())
+    return;
+  auto &bucket = m_sources[target.id()];
+  auto it = std::find(bucket.begin(), bucket.end(), source);
+  if (it != bucket.end()) {
+    bucket.erase(it);
+  }
+}
+
+std::span<const Entity> RelationIndex::sources(Entity target) const {
+  if (!target.valid() || target.id() >= m_sources.size())
+    return {};
+  return m_sources[target.id()];
+}
+
+void RelationIndex::clear() { m_sources.clear(); }
+
+} // namespace netra
@@ -0,0 +1,88 @@
+#include <core/route_field.hpp>
+
+#include <algorithm>
+
+namespace netra {
+
+void RouteField::reset(GridCoord start) {
+    m_start = start;
+    m_has_start = true;
+    m_exhausted = false;
+    m_expanded = 0;
+    m_pages.clear();
+    m_last_page = nullptr;
+    for (auto& bucket : m_buckets)
+        bucket.clear();
+    m_cost = 0;
+    m_pending = 0;
+
+    // The first step turns nowhere: seed the start in every direction.
+    Page& start_page = page(start);
+    for (int d = 0; d < 4; ++d) {
+        const std::size_t state = state_in_page(start, d);
+        start_page.g[state] = 0;
+        start_page.parent_dir[state] = k_from_start;
+        push(start, d, 0);
+    }
+}
+
+const RouteField::Page* RouteField::find_page(GridCoord p) const {
+    const GridCoord key = page_of(p);
+    if (m_last_page && m_last_page_key == key)
+        return m_last_page;
+    auto it = m_pages.find(key);
+    if (it == m_pages.end())
+        return nullptr;
+    m_last_page_key = key;
+    m_last_page = it->second.get();
+    return m_last_page;
+}
+
+RouteField::Page& RouteField::page(GridCoord p) {
+    if (const Page* found = find_page(p))
+        return *const_cast<Page*>(found);
+    const GridCoord key = page_of(p);
+    auto& slot = m_pages[key];
+    slot = std::make_unique<Page>();
+    m_last_page_key = key;
+    m_last_page = slot.get();
+    return *slot;
+}
+
+std::uint32_t RouteField::g_cost(GridCoord p, int dir) const {
+    const Page* found = find_page(p);
+    return found ? found->g[state_in_page(p, dir)] : k_unseen;
+}
+
+void RouteField::push(GridCoord p, int dir, std::uint32_t g) {
+    m_buckets[g % k_bucket_count].push_back({p, static_cast<std::uint8_t>(dir)});
+    ++m_pending;
+}
+
+std::uint32_t RouteField::best_cost(GridCoord end, int& dir) const {
+    std::uint32_t best = k_unseen;
+    for (int d = 0; d < 4; ++d) {
+        const std::uint32_t g = g_cost(end, d);
+        if (g < best) {
+            best = g;
+            dir = d;
+        }
+    }
+    return best;
+}
+
+void RouteField::trace_back(GridCoord end, int dir, std::vector<GridCoord>& path) const {
+    path.clear();
+    GridCoord p = end;
+    for (;;) {
+        path.push_back(p);
+        const std::uint8_t parent = find_page(p)->parent_dir[state_in_page(p, dir)];
+        if (parent == k_from_start)
+            break;
+        p = {p.x - k_steps[static_cast<std::size_t>(dir)].x, p.y - k_steps[static_cast<std::size_t>(dir)].y};
+        dir = parent;
+    }
+    std::ranges::reverse(path);
+}
+
+} // namespace netra
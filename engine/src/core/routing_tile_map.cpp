@@ -0,0 +1,187 @@
+#include "core/routing_tile_map.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace netra {
+
+namespace {
+
+std::int32_t floor_div(std::int32_t value, std::int32_t divisor) {
+  const std::int32_t q = value / divisor;
+  return (value % divisor != 0 && value < 0) ? q - 1 : q;
+}
+
+} // namespace
+
+RoutingTileMap::RoutingTileMap(std::int32_t tile_size)
+    : m_tile_size(tile_size) {
+  if (tile_size < 1) {
+    throw std::invalid_argument("RoutingTileMap: tile size must be positive");
+  }
+}
+
+GridCoord RoutingTileMap::tile_of(GridCoord cell) const {
+  return {floor_div(cell.x, m_tile_size), floor_div(cell.y, m_tile_size)};
+}
+
+GridRect RoutingTileMap::cells_of(GridCoord tile) const {
+  const GridCoord min{tile.x * m_tile_size, tile.y * m_tile_size};
+  return {min, {min.x + m_tile_size - 1, min.y + m_tile_size - 1}};
+}
+
+void RoutingTileMap::clear() { m_tiles.clear(); }
+
+void RoutingTileMap::adjust(GridCoord tile, std::int32_t blocked,
+                            std::int32_t wires) {
+  Tile &t = m_tiles[tile];
+  t.blocked += blocked;
+  t.wires += wires;
+  // Drop emptied tiles so the map stays sparse and two maps holding the
+  // same footprints compare equal however they were built.
+  if (t == Tile{}) {
+    m_tiles.erase(tile);
+  }
+}
+
+void RoutingTileMap::add_blocked(const GridRect &rect, std::int32_t count) {
+  if (rect.max.x < rect.min.x || rect.max.y < rect.min.y || count == 0) {
+    return;
+  }
+  const GridCoord lo = tile_of(rect.min);
+  const GridCoord hi = tile_of(rect.max);
+  for (std::int32_t ty = lo.y; ty <= hi.y; ++ty) {
+    for (std::int32_t tx = lo.x; tx <= hi.x; ++tx) {
+      const GridRect cells = cells_of({tx, ty});
+      const std::int32_t w = std::min(cells.max.x, rect.max.x) -
+                             std::max(cells.min.x, rect.min.x) + 1;
+      const std::int32_t h = std::min(cells.max.y, rect.max.y) -
+                             std::max(cells.min.y, rect.min.y) + 1;
+      adjust({tx, ty}, w * h * count, 0);
+    }
+  }
+}
+
+void RoutingTileMap::add_wire_cell(GridCoord cell, std::int32_t count) {
+  if (count != 0) {
+    adjust(tile_of(cell), 0, count);
+  }
+}
+
+std::int32_t RoutingTileMap::blocked_cells(GridCoord tile) const {
+  auto it = m_tiles.find(tile);
+  return it == m_tiles.end() ? 0 : it->second.blocked;
+}
+
+std::int32_t RoutingTileMap::wire_cells(GridCoord tile) const {
+  auto it = m_tiles.find(tile);
+  return it == m_tiles.end() ? 0 : it->second.wires;
+}
+
+bool RoutingTileMap::passable(GridCoord tile) const {
+  return blocked_cells(tile) < m_tile_size * m_tile_size;
+}
+
+std::vector<GridCoord> RoutingTileMap::find_corridor(GridCoord start,
+                                                     GridCoord end) const {
+  const GridCoord from = tile_of(start);
+  const GridCoord to = tile_of(end);
+
+  // Beyond the occupied tiles everything is open, so one free ring around
+  // them (and the two ends) holds a cheapest chain.
+  GridCoord lo{std::min(from.x, to.x), std::min(from.y, to.y)};
+  GridCoord hi{std::max(from.x, to.x), std::max(from.y, to.y)};
+  for (const auto &[tile, counts] : m_tiles) {
+    lo = {std::min(lo.x, tile.x), std::min(lo.y, tile.y)};
+    hi = {std::max(hi.x, tile.x), std::max(hi.y, tile.y)};
+  }
+  lo = {lo.x - 1, lo.y - 1};
+  hi = {hi.x + 1, hi.y + 1};
+
+  const std::int64_t area = std::int64_t{m_tile_size} * m_tile_size;
+  auto step_cost = [&](GridCoord t) -> std::int64_t {
+    auto it = m_tiles.find(t);
+    if (it == m_tiles.end()) {
+      return m_tile_size;
+    }
+    return m_tile_size + 2 * m_tile_size * it->second.blocked / area +
+           it->second.wires;
+  };
+  // Every step costs at least one tile width, and the last one enters the
+  // end tile, so this never overestimates. Counting the end tile's
+  // surcharge keeps the open tiles between far-apart ends from all tying
+  // below the cheapest chain.
+  const std::int64_t last_step = step_cost(to);
+  auto heuristic = [&](GridCoord t) -> std::int64_t {
+    const std::int64_t steps =
+        std::int64_t{std::abs(t.x - to.x)} + std::abs(t.y - to.y);
+    return steps == 0 ? 0 : (steps - 1) * m_tile_size + last_step;
+  };
+
+  // Search state only for the tiles reached, so far-apart modules (a huge
+  // bounding box) cost what the search visits.
+  struct Node {
+    GridCoord tile;
+    std::int64_t best = 0;
+    std::uint32_t parent = 0;
+    bool closed = false;
+  };
+  constexpr std::uint32_t k_none = ~std::uint32_t{0};
+  std::vector<Node> nodes;
+  std::unordered_map<GridCoord, std::uint32_t> node_of;
+  // f, then h: among equal f the tile nearer the end first, so an open
+  // stretch is crossed straight instead of filled.
+  using Item = std::tuple<std::int64_t, std::int64_t, std::uint32_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+  nodes.push_back({from, 0, k_none});
+  node_of.emplace(from, 0);
+  open.push({heuristic(from), heuristic(from), 0});
+  const GridCoord steps[] = {{0, 1}, {0, -1}, {-1, 0}, {1, 0}};
+  while (!open.empty()) {
+    const std::uint32_t current = std::get<2>(open.top());
+    open.pop();
+    if (nodes[current].closed) {
+      continue;
+    }
+    nodes[current].closed = true;
+    const GridCoord t = nodes[current].tile;
+    if (t == to) {
+      std::vector<GridCoord> corridor;
+      for (std::uint32_t i = current; i != k_none; i = nodes[i].parent) {
+        corridor.push_back(nodes[i].tile);
+      }
+      std::ranges::reverse(corridor);
+      return corridor;
+    }
+    for (const GridCoord step : steps) {
+      const GridCoord next{t.x + step.x, t.y + step.y};
+      if (next.x < lo.x || next.y < lo.y || next.x > hi.x || next.y > hi.y) {
+        continue;
+      }
+      if (!(next == to) && !passable(next)) {
+        continue;
+      }
+      const std::int64_t g = nodes[current].best + step_cost(next);
+      const auto [it, inserted] =
+          node_of.try_emplace(next, static_cast<std::uint32_t>(nodes.size()));
+      if (inserted) {
+        nodes.push_back({next, g, current});
+      } else if (nodes[it->second].closed || nodes[it->second].best <= g) {
+        continue;
+      } else {
+        nodes[it->second].best = g;
+        nodes[it->second].parent = current;
+      }
+      open.push({g + heuristic(next), heuristic(next), it->second});
+    }
+  }
+  return {};
+}
+
+} // namespace netra
@@ -0,0 +1,47 @@
+#include "core/symbol_table.hpp"
+
+#include <stdexcept>
+
+namespace netra {
+
+SymbolTable::SymbolTable() { intern(""); }
+
+SymbolTable::SymbolTable(const SymbolTable &other) : m_names(other.m_names) {
+  // Rebuild the index over our own copies of the strings.
+  m_index.reserve(m_names.size());
+  for (std::uint32_t i = 0; i < m_names.size(); ++i) {
+    m_index.emplace(m_names[i], Symbol{i});
+  }
+}
+
+SymbolTable &SymbolTable::operator=(const SymbolTable &other) {
+  if (this != &other) {
+    *this = SymbolTable(other);
+  }
+  return *this;
+}
+
+Symbol SymbolTable::intern(std::string_view text) {
+  if (auto it = m_index.find(text); it != m_index.end()) {
+    return it->second;
+  }
+  const Symbol symbol{static_cast<std::uint32_t>(m_names.size())};
+  m_index.emplace(m_names.emplace_back(text), symbol);
+  return symbol;
+}
+
+std::optional<Symbol> SymbolTable::find(std::string_view text) const {
+  if (auto it = m_index.find(text); it != m_index.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
+std::string_view SymbolTable::name(Symbol symbol) const {
+  if (!contains(symbol)) {
+    throw std::out_of_range("SymbolTable::name: unknown symbol");
+  }
+  return m_names[symbol.id];
+}
+
+} // namespace netra
@@ -0,0 +1,106 @@
+#include "core/thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace netra {
+
+ThreadPool::ThreadPool(std::size_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+  m_workers.reserve(thread_count - 1);
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    m_workers.emplace_back(
+        [this](std::stop_token stop) { worker_loop(stop); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  for (auto &worker : m_workers) {
+    worker.request_stop();
+  }
+  m_wake.notify_all();
+  // jthread joins on destruction.
+}
+
+std::size_t ThreadPool::size() const { return m_workers.size() + 1; }
+
+void ThreadPool::parallel_for(
+    std::size_t count, std::size_t chunk,
+    const std::function<void(std::size_t, std::size_t)> &func) {
+  if (count == 0)
+    return;
+  chunk = std::max<std::size_t>(chunk, 1);
+
+  // Not worth waking anyone for a single chunk.
+  if (m_workers.empty() || count <= chunk) {
+    func(0, count);
+    return;
+  }
+
+  std::lock_guard call_lock(m_call_mutex);
+  {
+    std::lock_guard lock(m_mutex);
+    m_job = &func;
+    m_count = count;
+    m_chunk = chunk;
+    m_error = nullptr;
+    m_next.store(0, std::memory_order_relaxed);
+    m_active = m_workers.size();
+    ++m_generation;
+  }
+  m_wake.notify_all();
+
+  run_chunks();
+
+  std::unique_lock lock(m_mutex);
+  m_done.wait(lock, [this] { return m_active == 0; });
+  m_job = nullptr;
+  if (m_error) {
+    std::rethrow_exception(std::exchange(m_error, nullptr));
+  }
+}
+
+void ThreadPool::run_chunks() {
+  for (;;) {
+    const std::size_t begin =
+        m_next.fetch_add(m_chunk, std::memory_order_relaxed);
+    if (begin >= m_count)
+      return;
+    const std::size_t end = std::min(begin + m_chunk, m_count);
+    try {
+      (*m_job)(begin, end);
+    } catch (...) {
+      std::lock_guard lock(m_mutex);
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+      // Stop handing out further chunks.
+      m_next.store(m_count, std::memory_order_relaxed);
+    }
+  }
+}
+
+void ThreadPool::worker_loop(std::stop_token stop) {
+  std::uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock lock(m_mutex);
+      if (!m_wake.wait(lock, stop,
+                       [this, seen] { return m_generation != seen; })) {
+        return; // stop requested
+      }
+      seen = m_generation;
+    }
+
+    run_chunks();
+
+    std::lock_guard lock(m_mutex);
+    if (--m_active == 0) {
+      m_done.notify_one();
+    }
+  }
+}
+
+} // namespace netra
@@ -0,0 +1,30 @@
+#include "io/buffered_writer.hpp"
+
+namespace netra::io {
+
+std::optional<BufferedWriter>
+BufferedWriter::open(const std::filesystem::path &path) {
+  std::FILE *file = std::fopen(path.string().c_str(), "wb");
+  if (!file)
+    return std::nullopt;
+  return BufferedWriter(file);
+}
+
+BufferedWriter::BufferedWriter(std::FILE *file) : m_file(file) {
+  m_buffer.reserve(k_flush_threshold);
+}
+
+bool BufferedWriter::finish() {
+  flush();
+  return m_ok && std::fflush(m_file.get()) == 0;
+}
+
+void BufferedWriter::flush() {
+  if (m_ok && !m_buffer.empty()) {
+    m_ok = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file.get()) ==
+           m_buffer.size();
+  }
+  m_buffer.clear();
+}
+
+} // namespace netra::io
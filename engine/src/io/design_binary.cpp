@@ -0,0 +1,662 @@
+#include "io/design_binary.hpp"
+
+#include <components/components.hpp>
+#include <components/render_components.hpp>
+#include <io/mapped_file.hpp>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace netra::io {
+
+namespace {
+
+constexpr std::array<char, 8> k_magic{'N', 'E', 'T', 'R', 'A', 'D', 'S', 'N'};
+constexpr std::uint32_t k_version = 2;
+constexpr std::uint32_t k_byte_order = 0x01020304;
+constexpr std::size_t k_alignment = 8;
+// Freed ids below FileHeader::id_bound take no space in the file, so the
+// loader allows at most this many per file byte: plenty for designs saved
+// after heavy deletion, while a corrupt header cannot demand gigabytes.
+constexpr std::uint64_t k_max_free_ids_per_byte = 64;
+
+enum class SectionTag : std::uint32_t {
+  Alive = 1,
+  Strings = 2,
+  EntityPool = 3,
+  CoordPool = 4,
+
+  // Record sections (components with strings or vectors).
+  ModuleDef = 16,
+  ModuleInst = 17,
+  Port = 18,
+  Signal = 19,
+  Hierarchy = 20,
+  ShaderKey = 21,
+  Wire = 22,
+
+  // Raw sections (trivially-copyable components).
+  ModuleExtent = 32,
+  ModulePixelPosition = 33,
+  PortOffset = 34,
+  PortVisual = 35,
+  PortGridPosition = 36,
+  WireJunction = 37,
+};
+
+struct FileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t id_bound;
+  std::uint32_t section_count;
+};
+
+// `element_size` is sizeof(record) for fixed-size sections, 0 otherwise.
+struct SectionHeader {
+  std::uint32_t tag;
+  std::uint32_t element_size;
+  std::uint64_t count;
+  std::uint64_t payload_size;
+};
+
+static_assert(sizeof(FileHeader) % k_alignment == 0);
+static_assert(sizeof(SectionHeader) % k_alignment == 0);
+
+// Fixed-size records. Names are Symbol ids into the Strings section (the
+// World's symbol table in id order), variable-length lists are
+// [first, first + count) ranges into a pool.
+struct ModuleDefRecord {
+  std::uint32_t name;
+  std::uint32_t internal_root;
+  std::uint8_t is_primitive;
+  std::array<std::uint8_t, 3> padding;
+};
+
+struct ModuleInstRecord {
+  std::uint32_t instance_name;
+  std::uint32_t definition;
+};
+
+struct PortRecord {
+  std::uint32_t name;
+  std::uint32_t width;
+  std::uint32_t owner;
+  std::uint32_t connected_signal;
+  std::uint8_t direction;
+  std::array<std::uint8_t, 3> padding;
+};
+
+struct SignalRecord {
+  std::uint32_t name;
+  std::uint32_t width;
+  std::uint32_t scope;
+  std::uint32_t ports_first;
+  std::uint32_t ports_count;
+};
+
+struct HierarchyRecord {
+  std::uint32_t parent;
+  std::uint32_t children_first;
+  std::uint32_t children_count;
+};
+
+struct ShaderKeyRecord {
+  std::uint32_t key;
+};
+
+struct WireRecord {
+  std::uint32_t signal;
+  std::uint32_t from_endpoint;
+  std::uint32_t to_endpoint;
+  std::uint32_t points_first;
+  std::uint32_t points_count;
+};
+
+constexpr std::size_t padded(std::size_t size) {
+  return (size + k_alignment - 1) / k_alignment * k_alignment;
+}
+
+// ---------------------------------------------------------------------------
+// Writing
+// ---------------------------------------------------------------------------
+
+struct FileCloser {
+  void operator()(std::FILE *file) const { std::fclose(file); }
+};
+
+class Writer {
+public:
+  explicit Writer(std::FILE *file) : m_file(file) {}
+
+  void bytes(const void *data, std::size_t size) {
+    if (size == 0 || !m_ok)
+      return;
+    m_ok = std::fwrite(data, 1, size, m_file.get()) == size;
+    m_offset += size;
+  }
+
+  template <typename T> void value(const T &v) { bytes(&v, sizeof(T)); }
+
+  template <typename T> void array(std::span<const T> values) {
+    bytes(values.data(), values.size_bytes());
+  }
+
+  void align() {
+    static constexpr std::array<std::byte, k_alignment> zeros{};
+    bytes(zeros.data(), padded(m_offset) - m_offset);
+  }
+
+  void section(SectionTag tag, std::uint32_t element_size, std::size_t count,
+               std::size_t payload_size) {
+    value(SectionHeader{static_cast<std::uint32_t>(tag), element_size, count,
+                        padded(payload_size)});
+  }
+
+  bool finish() {
+    if (m_ok) {
+      m_ok = std::fflush(m_file.get()) == 0;
+    }
+    return m_ok;
+  }
+
+private:
+  std::unique_ptr<std::FILE, FileCloser> m_file;
+  std::size_t m_offset = 0;
+  bool m_ok = true;
+};
+
+std::uint32_t entity_ref(Entity e) { return e.id(); }
+
+// The symbol table is written in id order, so loading can re-intern the
+// strings and get the same Symbols back.
+void write_symbols(Writer &out, const SymbolTable &symbols) {
+  std::vector<std::uint32_t> offsets;
+  offsets.reserve(symbols.size() + 1);
+  std::uint32_t offset = 0;
+  for (std::uint32_t i = 0; i < symbols.size(); ++i) {
+    offsets.push_back(offset);
+    offset += static_cast<std::uint32_t>(symbols.name(Symbol{i}).size());
+  }
+  offsets.push_back(offset);
+
+  out.section(SectionTag::Strings, 0, symbols.size(),
+              offsets.size() * sizeof(std::uint32_t) + offset);
+  out.array(std::span<const std::uint32_t>(offsets));
+  for (std::uint32_t i = 0; i < symbols.size(); ++i) {
+    const std::string_view name = symbols.name(Symbol{i});
+    out.bytes(name.data(), name.size());
+  }
+  out.align();
+}
+
+template <typename T>
+void write_raw_section(Writer &out, const World &world, SectionTag tag) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  std::span<const EntityID> ids;
+  std::span<const T> components;
+  if (const auto *storage = world.get_storage<T>()) {
+    ids = storage->entities();
+    components = storage->components();
+  }
+  out.section(tag, sizeof(T), ids.size(),
+              padded(ids.size_bytes()) + components.size_bytes());
+  out.array(ids);
+  out.align();
+  out.array(components);
+  out.align();
+}
+
+template <typename T, typename Record, typename Encode>
+void write_record_section(Writer &out, const World &world, SectionTag tag,
+                          Encode &&encode) {
+  std::span<const EntityID> ids;
+  std::vector<Record> records;
+  if (const auto *storage = world.get_storage<T>()) {
+    ids = storage->entities();
+    records.reserve(ids.size());
+    for (const T &component : storage->components()) {
+      records.push_back(encode(component));
+    }
+  }
+  out.section(tag, sizeof(Record), ids.size(),
+              padded(ids.size_bytes()) + records.size() * sizeof(Record));
+  out.array(ids);
+  out.align();
+  out.array(std::span<const Record>(records));
+  out.align();
+}
+
+// ---------------------------------------------------------------------------
+// Reading
+// ---------------------------------------------------------------------------
+
+struct Section {
+  std::uint32_t element_size = 0;
+  std::uint64_t count = 0;
+  std::span<const std::byte> payload;
+};
+
+template <typename T> T read_at(std::span<const std::byte> bytes, std::size_t offset) {
+  T value;
+  std::memcpy(&value, bytes.data() + offset, sizeof(T));
+  return value;
+}
+
+// Splits a component section into its id array and element array.
+// Returns false if the declared sizes do not fit the payload.
+bool split_component_section(const Section &section, std::size_t element_size,
+                             std::span<const std::byte> &ids,
+                             std::span<const std::byte> &elements) {
+  if (section.element_size != element_size ||
+      section.count > section.payload.size() / sizeof(EntityID) ||
+      section.count > section.payload.size() / element_size)
+    return false;
+  const std::size_t ids_size = section.count * sizeof(EntityID);
+  const std::size_t elements_size = section.count * element_size;
+  if (padded(ids_size) + elements_size > section.payload.size())
+    return false;
+  ids = section.payload.subspan(0, ids_size);
+  elements = section.payload.subspan(padded(ids_size), elements_size);
+  return true;
+}
+
+// Re-interns the saved symbol table into `world`. Fails unless every string
+// gets back its saved id, i.e. the table starts with "" and has no repeats.
+bool load_symbols(World &world, const Section &section) {
+  // count + 1 offsets.
+  if (section.count >= section.payload.size() / sizeof(std::uint32_t))
+    return false;
+  const std::size_t offsets_size = (section.count + 1) * sizeof(std::uint32_t);
+  const auto offsets = section.payload.subspan(0, offsets_size);
+  const auto chars = section.payload.subspan(offsets_size);
+  std::uint32_t begin = read_at<std::uint32_t>(offsets, 0);
+  for (std::size_t i = 0; i < section.count; ++i) {
+    const auto end =
+        read_at<std::uint32_t>(offsets, (i + 1) * sizeof(std::uint32_t));
+    if (end < begin || end > chars.size())
+      return false;
+    std::string text(end - begin, '\0');
+    std::memcpy(text.data(), chars.data() + begin, text.size());
+    if (world.intern(text).id != i)
+      return false;
+    begin = end;
+  }
+  return true;
+}
+
+// Pool of fixed-size values referenced by [first, first + count) ranges.
+template <typename T> class Pool {
+public:
+  bool parse(const Section &section) {
+    if (section.element_size != sizeof(T) ||
+        section.count > section.payload.size() / sizeof(T))
+      return false;
+    m_bytes = section.payload.subspan(0, section.count * sizeof(T));
+    return true;
+  }
+
+  std::optional<std::vector<T>> range(std::uint32_t first,
+                                      std::uint32_t count) const {
+    const std::size_t end = static_cast<std::size_t>(first) + count;
+    if (end * sizeof(T) > m_bytes.size())
+      return std::nullopt;
+    std::vector<T> values(count);
+    if (count > 0) {
+      std::memcpy(values.data(), m_bytes.data() + first * sizeof(T),
+                  count * sizeof(T));
+    }
+    return values;
+  }
+
+private:
+  std::span<const std::byte> m_bytes;
+};
+
+std::vector<Entity> to_entities(const std::vector<EntityID> &ids) {
+  std::vector<Entity> entities;
+  entities.reserve(ids.size());
+  for (EntityID id : ids) {
+    entities.emplace_back(id);
+  }
+  return entities;
+}
+
+template <typename T>
+bool load_raw_section(World &world, const Section *section) {
+  if (!section)
+    return true;
+  std::span<const std::byte> ids;
+  std::span<const std::byte> elements;
+  if (!split_component_section(*section, sizeof(T), ids, elements))
+    return false;
+  for (std::size_t i = 0; i < section->count; ++i) {
+    if (!world.alive(Entity(read_at<EntityID>(ids, i * sizeof(EntityID)))))
+      return false;
+  }
+  try {
+    world.emplace_bytes<T>(ids, elements);
+  } catch (const std::invalid_argument &) {
+    return false;
+  }
+  return true;
+}
+
+// Decodes every record of a section with `decode(record) -> optional<T>`
+// and emplaces the results in one batch.
+template <typename T, typename Record, typename Decode>
+bool load_record_section(World &world, const Section *section,
+                         Decode &&decode) {
+  if (!section)
+    return true;
+  std::span<const std::byte> id_bytes;
+  std::span<const std::byte> record_bytes;
+  if (!split_component_section(*section, sizeof(Record), id_bytes,
+                               record_bytes))
+    return false;
+
+  std::vector<Entity> entities;
+  std::vector<T> components;
+  entities.reserve(section->count);
+  components.reserve(section->count);
+  for (std::size_t i = 0; i < section->count; ++i) {
+    Entity entity(read_at<EntityID>(id_bytes, i * sizeof(EntityID)));
+    if (!world.alive(entity))
+      return false;
+    std::optional<T> component =
+        decode(read_at<Record>(record_bytes, i * sizeof(Record)));
+    if (!component)
+      return false;
+    entities.push_back(entity);
+    components.push_back(std::move(*component));
+  }
+
+  world.emplace_many<T>(entities, components);
+  // Repeated ids collapse into one component.
+  return world.get_storage<T>()->size() == entities.size();
+}
+
+} // namespace
+
+const char *to_string(BinaryError error) {
+  switch (error) {
+  case BinaryError::OpenFailed:
+    return "could not open file";
+  case BinaryError::WriteFailed:
+    return "write failed";
+  case BinaryError::BadMagic:
+    return "not a Netra design file";
+  case BinaryError::UnsupportedVersion:
+    return "unsupported format version or byte order";
+  case BinaryError::Truncated:
+    return "file is truncated";
+  case BinaryError::Corrupt:
+    return "file contents are inconsistent";
+  }
+  return "unknown error";
+}
+
+std::expected<void, BinaryError>
+save_binary(const World &world, const std::filesystem::path &path) {
+  std::FILE *raw = std::fopen(path.string().c_str(), "wb");
+  if (!raw)
+    return std::unexpected(BinaryError::OpenFailed);
+  Writer out(raw);
+
+  constexpr std::uint32_t k_section_count = 17;
+  out.value(FileHeader{k_magic, k_version, k_byte_order, world.id_bound(),
+                       k_section_count});
+
+  // 1. Entity table.
+  const auto alive = world.alive_ids();
+  out.section(SectionTag::Alive, sizeof(EntityID), alive.size(),
+              alive.size_bytes());
+  out.array(alive);
+  out.align();
+
+  // 2. Raw sections.
+  write_raw_section<ModuleExtent>(out, world, SectionTag::ModuleExtent);
+  write_raw_section<ModulePixelPosition>(out, world,
+                                         SectionTag::ModulePixelPosition);
+  write_raw_section<PortOffset>(out, world, SectionTag::PortOffset);
+  write_raw_section<PortVisual>(out, world, SectionTag::PortVisual);
+  write_raw_section<PortGridPosition>(out, world,
+                                      SectionTag::PortGridPosition);
+  write_raw_section<WireJunction>(out, world, SectionTag::WireJunction);
+
+  // 3. Record sections; lists are collected on the way.
+  std::vector<EntityID> entity_pool;
+  std::vector<GridCoord> coord_pool;
+
+  auto push_entities = [&entity_pool](const std::vector<Entity> &list) {
+    const auto first = static_cast<std::uint32_t>(entity_pool.size());
+    for (Entity e : list) {
+      entity_pool.push_back(e.id());
+    }
+    return first;
+  };
+
+  write_record_section<ModuleDef, ModuleDefRecord>(
+      out, world, SectionTag::ModuleDef, [&](const ModuleDef &def) {
+        return ModuleDefRecord{def.name.id,
+                               entity_ref(def.internal_root),
+                               static_cast<std::uint8_t>(def.is_primitive),
+                               {}};
+      });
+  write_record_section<ModuleInst, ModuleInstRecord>(
+      out, world, SectionTag::ModuleInst, [&](const ModuleInst &inst) {
+        return ModuleInstRecord{inst.instance_name.id,
+                                entity_ref(inst.definition)};
+      });
+  write_record_section<Port, PortRecord>(
+      out, world, SectionTag::Port, [&](const Port &port) {
+        return PortRecord{port.name.id, port.width,
+                          entity_ref(port.owner),
+                          entity_ref(port.connected_signal),
+                          static_cast<std::uint8_t>(port.direction),
+                          {}};
+      });
+  write_record_section<Signal, SignalRecord>(
+      out, world, SectionTag::Signal, [&](const Signal &signal) {
+        const auto first = push_entities(signal.connected_ports);
+        return SignalRecord{
+            signal.name.id, signal.width, entity_ref(signal.scope),
+            first, static_cast<std::uint32_t>(signal.connected_ports.size())};
+      });
+  write_record_section<Hierarchy, HierarchyRecord>(
+      out, world, SectionTag::Hierarchy, [&](const Hierarchy &hier) {
+        const auto first = push_entities(hier.children);
+        return HierarchyRecord{
+            entity_ref(hier.parent), first,
+            static_cast<std::uint32_t>(hier.children.size())};
+      });
+  write_record_section<ShaderKey, ShaderKeyRecord>(
+      out, world, SectionTag::ShaderKey, [&](const ShaderKey &key) {
+        return ShaderKeyRecord{key.key.id};
+      });
+  write_record_section<Wire, WireRecord>(
+      out, world, SectionTag::Wire, [&](const Wire &wire) {
+        const auto first = static_cast<std::uint32_t>(coord_pool.size());
+        coord_pool.insert(coord_pool.end(), wire.points.begin(),
+                          wire.points.end());
+        return WireRecord{entity_ref(wire.signal),
+                          entity_ref(wire.from_endpoint),
+                          entity_ref(wire.to_endpoint), first,
+                          static_cast<std::uint32_t>(wire.points.size())};
+      });
+
+  // 4. Shared tables.
+  write_symbols(out, world.symbols());
+  out.section(SectionTag::EntityPool, sizeof(EntityID), entity_pool.size(),
+              entity_pool.size() * sizeof(EntityID));
+  out.array(std::span<const EntityID>(entity_pool));
+  out.align();
+  out.section(SectionTag::CoordPool, sizeof(GridCoord), coord_pool.size(),
+              coord_pool.size() * sizeof(GridCoord));
+  out.array(std::span<const GridCoord>(coord_pool));
+  out.align();
+
+  if (!out.finish())
+    return std::unexpected(BinaryError::WriteFailed);
+  return {};
+}
+
+std::expected<World, BinaryError>
+load_binary(const std::filesystem::path &path) {
+  auto file = MappedFile::open(path);
+  if (!file)
+    return std::unexpected(BinaryError::OpenFailed);
+  const auto bytes = file->bytes();
+
+  if (bytes.size() < sizeof(FileHeader))
+    return std::unexpected(BinaryError::Truncated);
+  const auto header = read_at<FileHeader>(bytes, 0);
+  if (header.magic != k_magic)
+    return std::unexpected(BinaryError::BadMagic);
+  if (header.version != k_version || header.byte_order != k_byte_order)
+    return std::unexpected(BinaryError::UnsupportedVersion);
+
+  // Pass 1: index sections by tag. Unknown tags are skipped.
+  std::unordered_map<std::uint32_t, Section> sections;
+  std::size_t offset = sizeof(FileHeader);
+  for (std::uint32_t i = 0; i < header.section_count; ++i) {
+    if (offset + sizeof(SectionHeader) > bytes.size())
+      return std::unexpected(BinaryError::Truncated);
+    const auto section = read_at<SectionHeader>(bytes, offset);
+    offset += sizeof(SectionHeader);
+    if (section.payload_size > bytes.size() - offset)
+      return std::unexpected(BinaryError::Truncated);
+    sections[section.tag] =
+        Section{section.element_size, section.count,
+                bytes.subspan(offset, section.payload_size)};
+    offset += section.payload_size;
+  }
+  auto find = [&sections](SectionTag tag) -> const Section * {
+    auto it = sections.find(static_cast<std::uint32_t>(tag));
+    return it == sections.end() ? nullptr : &it->second;
+  };
+
+  // Pass 2: entity table, recreating exactly the saved id range.
+  World world;
+  const Section *alive_section = find(SectionTag::Alive);
+  if (!alive_section || alive_section->element_size != sizeof(EntityID) ||
+      alive_section->count >
+          alive_section->payload.size() / sizeof(EntityID) ||
+      header.id_bound >
+          alive_section->count + bytes.size() * k_max_free_ids_per_byte)
+    return std::unexpected(BinaryError::Corrupt);
+
+  auto all = world.create_many(header.id_bound);
+  std::vector<bool> is_alive(header.id_bound, false);
+  for (std::size_t i = 0; i < alive_section->count; ++i) {
+    const auto id =
+        read_at<EntityID>(alive_section->payload, i * sizeof(EntityID));
+    if (id >= header.id_bound)
+      return std::unexpected(BinaryError::Corrupt);
+    is_alive[id] = true;
+  }
+  std::erase_if(all, [&is_alive](Entity e) { return is_alive[e.id()]; });
+  world.destroy_many(all);
+
+  // Shared tables.
+  Pool<EntityID> entity_pool;
+  Pool<GridCoord> coord_pool;
+  const Section *strings_section = find(SectionTag::Strings);
+  const Section *entity_pool_section = find(SectionTag::EntityPool);
+  const Section *coord_pool_section = find(SectionTag::CoordPool);
+  if ((strings_section && !load_symbols(world, *strings_section)) ||
+      (entity_pool_section && !entity_pool.parse(*entity_pool_section)) ||
+      (coord_pool_section && !coord_pool.parse(*coord_pool_section)))
+    return std::unexpected(BinaryError::Corrupt);
+
+  // Raw components: straight from the mapping.
+  const bool raw_ok =
+      load_raw_section<ModuleExtent>(world, find(SectionTag::ModuleExtent)) &&
+      load_raw_section<ModulePixelPosition>(
+          world, find(SectionTag::ModulePixelPosition)) &&
+      load_raw_section<PortOffset>(world, find(SectionTag::PortOffset)) &&
+      load_raw_section<PortVisual>(world, find(SectionTag::PortVisual)) &&
+      load_raw_section<PortGridPosition>(world,
+                                         find(SectionTag::PortGridPosition)) &&
+      load_raw_section<WireJunction>(world, find(SectionTag::WireJunction));
+  if (!raw_ok)
+    return std::unexpected(BinaryError::Corrupt);
+
+  // Record components.
+  auto known = [&world](std::uint32_t symbol) {
+    return world.symbols().contains(Symbol{symbol});
+  };
+  const bool records_ok =
+      load_record_section<ModuleDef, ModuleDefRecord>(
+          world, find(SectionTag::ModuleDef),
+          [&](const ModuleDefRecord &r) -> std::optional<ModuleDef> {
+            if (!known(r.name))
+              return std::nullopt;
+            return ModuleDef{Symbol{r.name}, r.is_primitive != 0,
+                             Entity(r.internal_root)};
+          }) &&
+      load_record_section<ModuleInst, ModuleInstRecord>(
+          world, find(SectionTag::ModuleInst),
+          [&](const ModuleInstRecord &r) -> std::optional<ModuleInst> {
+            if (!known(r.instance_name))
+              return std::nullopt;
+            return ModuleInst{Symbol{r.instance_name}, Entity(r.definition)};
+          }) &&
+      load_record_section<Port, PortRecord>(
+          world, find(SectionTag::Port),
+          [&](const PortRecord &r) -> std::optional<Port> {
+            if (!known(r.name) ||
+                r.direction > static_cast<std::uint8_t>(PortDirection::InOut))
+              return std::nullopt;
+            return Port{Symbol{r.name}, static_cast<PortDirection>(r.direction),
+                        r.width, Entity(r.owner), Entity(r.connected_signal)};
+          }) &&
+      load_record_section<Signal, SignalRecord>(
+          world, find(SectionTag::Signal),
+          [&](const SignalRecord &r) -> std::optional<Signal> {
+            auto ports = entity_pool.range(r.ports_first, r.ports_count);
+            if (!known(r.name) || !ports)
+              return std::nullopt;
+            return Signal{Symbol{r.name}, r.width, Entity(r.scope),
+                          to_entities(*ports)};
+          }) &&
+      load_record_section<Hierarchy, HierarchyRecord>(
+          world, find(SectionTag::Hierarchy),
+          [&](const HierarchyRecord &r) -> std::optional<Hierarchy> {
+            auto children = entity_pool.range(r.children_first, r.children_count);
+            if (!children)
+              return std::nullopt;
+            return Hierarchy{Entity(r.parent), to_entities(*children)};
+          }) &&
+      load_record_section<ShaderKey, ShaderKeyRecord>(
+          world, find(SectionTag::ShaderKey),
+          [&](const ShaderKeyRecord &r) -> std::optional<ShaderKey> {
+            if (!known(r.key))
+              return std::nullopt;
+            return ShaderKey{Symbol{r.key}};
+          }) &&
+      load_record_section<Wire, WireRecord>(
+          world, find(SectionTag::Wire),
+          [&](const WireRecord &r) -> std::optional<Wire> {
+            auto points = coord_pool.range(r.points_first, r.points_count);
+            if (!points)
+              return std::nullopt;
+            return Wire{Entity(r.signal), Entity(r.from_endpoint),
+                        Entity(r.to_endpoint), std::move(*points)};
+          });
+  if (!records_ok)
+    return std::unexpected(BinaryError::Corrupt);
+
+  return world;
+}
+
+} // namespace netra::io
@@ -0,0 +1,624 @@
+#include "io/design_text.hpp"
+
+#include <components/components.hpp>
+#include <components/render_components.hpp>
+#include <io/buffered_writer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <system_error>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace netra::io {
+
+namespace {
+
+constexpr std::string_view k_header = "netra-design";
+constexpr std::uint32_t k_version = 1;
+constexpr std::size_t k_buffer_size = 64 * 1024;
+// Ids below 'bound' that no 'entity' line declares take no space in the
+// file, so, as for binary designs, at most this many are allowed per file
+// byte: a bad 'bound' cannot demand gigabytes.
+constexpr std::uint64_t k_max_free_ids_per_byte = 64;
+
+struct FileCloser {
+  void operator()(std::FILE *file) const { std::fclose(file); }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+constexpr std::array<std::string_view, 3> k_directions{"in", "out", "inout"};
+constexpr std::array<std::string_view, 4> k_sides{"left", "right", "top",
+                                                  "bottom"};
+
+// ---------------------------------------------------------------------------
+// Writing
+// ---------------------------------------------------------------------------
+
+// Design-text tokens on top of BufferedWriter.
+class TextWriter {
+public:
+  explicit TextWriter(BufferedWriter out) : m_out(std::move(out)) {}
+
+  TextWriter &put(std::string_view text) {
+    m_out.put(text);
+    return *this;
+  }
+
+  TextWriter &put(char c) {
+    m_out.put(c);
+    return *this;
+  }
+
+  template <typename T> TextWriter &number(T value) {
+    m_out.number(value);
+    return *this;
+  }
+
+  TextWriter &entity(Entity e) {
+    return e.valid() ? number(e.id()) : put('-');
+  }
+
+  TextWriter &quoted(std::string_view text) {
+    put('"');
+    for (char c : text) {
+      switch (c) {
+      case '"':
+        put("\\\"");
+        break;
+      case '\\':
+        put("\\\\");
+        break;
+      case '\n':
+        put("\\n");
+        break;
+      case '\t':
+        put("\\t");
+        break;
+      default:
+        put(c);
+      }
+    }
+    return put('"');
+  }
+
+  // Starts a component line inside the current entity block.
+  TextWriter &line(std::string_view keyword) { return put("  ").put(keyword); }
+
+  TextWriter &end_line() { return put('\n'); }
+
+  bool finish() { return m_out.finish(); }
+
+private:
+  BufferedWriter m_out;
+};
+
+// ---------------------------------------------------------------------------
+// Reading
+// ---------------------------------------------------------------------------
+
+// Yields the lines of a file through a reusable buffer. A returned view is
+// valid until the next call.
+class LineReader {
+public:
+  explicit LineReader(FilePtr file)
+      : m_file(std::move(file)), m_buffer(k_buffer_size) {}
+
+  std::optional<std::string_view> next() {
+    while (true) {
+      const char *begin = m_buffer.data() + m_begin;
+      const char *end = m_buffer.data() + m_end;
+      if (const char *newline = std::find(begin, end, '\n'); newline != end) {
+        m_begin += static_cast<std::size_t>(newline - begin) + 1;
+        return strip_cr(std::string_view(begin, newline - begin));
+      }
+      if (m_eof) {
+        if (begin == end)
+          return std::nullopt;
+        m_begin = m_end;
+        return strip_cr(std::string_view(begin, end - begin));
+      }
+      refill();
+    }
+  }
+
+  bool failed() const { return std::ferror(m_file.get()) != 0; }
+
+private:
+  static std::string_view strip_cr(std::string_view line) {
+    if (!line.empty() && line.back() == '\r')
+      line.remove_suffix(1);
+    return line;
+  }
+
+  // Moves the partial line to the front and reads after it, growing the
+  // buffer only when a single line does not fit.
+  void refill() {
+    const std::size_t pending = m_end - m_begin;
+    if (pending > 0 && m_begin > 0)
+      std::memmove(m_buffer.data(), m_buffer.data() + m_begin, pending);
+    m_begin = 0;
+    m_end = pending;
+    if (m_end == m_buffer.size())
+      m_buffer.resize(m_buffer.size() * 2);
+    const std::size_t read = std::fread(m_buffer.data() + m_end, 1,
+                                        m_buffer.size() - m_end, m_file.get());
+    m_end += read;
+    m_eof = read == 0;
+  }
+
+  FilePtr m_file;
+  std::vector<char> m_buffer;
+  std::size_t m_begin = 0;
+  std::size_t m_end = 0;
+  bool m_eof = false;
+};
+
+// Whitespace-separated tokens of one line. Every read returns false on a
+// malformed or missing token.
+class Tokens {
+public:
+  explicit Tokens(std::string_view line) : m_rest(line) {}
+
+  bool done() {
+    skip_space();
+    return m_rest.empty();
+  }
+
+  std::string_view word() {
+    skip_space();
+    const auto end = m_rest.find_first_of(" \t");
+    const auto token = m_rest.substr(0, end);
+    m_rest.remove_prefix(token.size());
+    return token;
+  }
+
+  template <typename T> bool number(T &out) {
+    skip_space();
+    const char *first = m_rest.data();
+    const char *last = first + m_rest.size();
+    auto [ptr, ec] = std::from_chars(first, last, out);
+    if (ec != std::errc{} || (ptr != last && *ptr != ' ' && *ptr != '\t' &&
+                              *ptr != ','))
+      return false;
+    m_rest.remove_prefix(static_cast<std::size_t>(ptr - first));
+    return true;
+  }
+
+  bool entity(Entity &out) {
+    skip_space();
+    if (m_rest.starts_with('-') &&
+        (m_rest.size() == 1 || m_rest[1] == ' ' || m_rest[1] == '\t')) {
+      m_rest.remove_prefix(1);
+      out = Entity{};
+      return true;
+    }
+    EntityID id = 0;
+    if (!number(id) || id == NullEntity)
+      return false;
+    out = Entity(id);
+    return true;
+  }
+
+  bool coord(GridCoord &out) {
+    if (!number(out.x) || !m_rest.starts_with(','))
+      return false;
+    m_rest.remove_prefix(1);
+    return number(out.y);
+  }
+
+  bool quoted(std::string &out) {
+    skip_space();
+    if (!m_rest.starts_with('"'))
+      return false;
+    m_rest.remove_prefix(1);
+    out.clear();
+    while (!m_rest.empty()) {
+      const char c = m_rest.front();
+      m_rest.remove_prefix(1);
+      if (c == '"')
+        return true;
+      if (c != '\\') {
+        out.push_back(c);
+        continue;
+      }
+      if (m_rest.empty())
+        return false;
+      const char escaped = m_rest.front();
+      m_rest.remove_prefix(1);
+      switch (escaped) {
+      case '"':
+      case '\\':
+        out.push_back(escaped);
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      default:
+        return false;
+      }
+    }
+    return false; // unterminated
+  }
+
+  template <std::size_t N>
+  bool keyword(const std::array<std::string_view, N> &names,
+               std::uint8_t &out) {
+    const auto token = word();
+    const auto it = std::find(names.begin(), names.end(), token);
+    if (it == names.end())
+      return false;
+    out = static_cast<std::uint8_t>(it - names.begin());
+    return true;
+  }
+
+  bool entities(std::vector<Entity> &out) {
+    out.clear();
+    while (!done()) {
+      Entity e;
+      if (!entity(e))
+        return false;
+      out.push_back(e);
+    }
+    return true;
+  }
+
+private:
+  void skip_space() {
+    const auto start = m_rest.find_first_not_of(" \t");
+    m_rest.remove_prefix(start == std::string_view::npos ? m_rest.size()
+                                                         : start);
+  }
+
+  std::string_view m_rest;
+};
+
+template <typename T> struct Batch {
+  std::vector<Entity> entities;
+  std::vector<T> components;
+
+  void add(Entity e, T component) {
+    entities.push_back(e);
+    components.push_back(std::move(component));
+  }
+
+  void flush(World &world) const {
+    if (!entities.empty())
+      world.emplace_many<T>(entities, components);
+  }
+};
+
+// Components collected while parsing and emplaced in one batch per type.
+// The tuple order is also the bit index used to reject duplicates within an
+// entity block.
+using Batches =
+    std::tuple<Batch<ModuleDef>, Batch<ModuleInst>, Batch<Port>,
+               Batch<Signal>, Batch<Hierarchy>, Batch<ShaderKey>, Batch<Wire>,
+               Batch<ModuleExtent>, Batch<ModulePixelPosition>,
+               Batch<PortOffset>, Batch<PortVisual>, Batch<PortGridPosition>,
+               Batch<WireJunction>>;
+
+template <typename T, typename Tuple, std::size_t I = 0>
+constexpr std::size_t batch_index() {
+  if constexpr (std::is_same_v<std::tuple_element_t<I, Tuple>, Batch<T>>)
+    return I;
+  else
+    return batch_index<T, Tuple, I + 1>();
+}
+
+// Parses the rest of a component line into the batch for its type and sets
+// `kind` to that batch's index. Names are interned into `world`. Returns
+// false on malformed input.
+bool parse_component(std::string_view keyword, Tokens &tokens, World &world,
+                     Entity entity, Batches &batches, std::size_t &kind) {
+  auto add = [&]<typename T>(T component) {
+    kind = batch_index<T, Batches>();
+    std::get<Batch<T>>(batches).add(entity, std::move(component));
+    return true;
+  };
+  auto name = [&](Symbol &out) {
+    std::string text;
+    if (!tokens.quoted(text))
+      return false;
+    out = world.intern(text);
+    return true;
+  };
+
+  if (keyword == "def") {
+    ModuleDef def;
+    const bool ok = name(def.name);
+    const auto kind_word = tokens.word();
+    if (!ok || (kind_word != "primitive" && kind_word != "composite") ||
+        !tokens.entity(def.internal_root))
+      return false;
+    def.is_primitive = kind_word == "primitive";
+    return tokens.done() && add(std::move(def));
+  }
+  if (keyword == "inst") {
+    ModuleInst inst;
+    return name(inst.instance_name) &&
+           tokens.entity(inst.definition) && tokens.done() &&
+           add(std::move(inst));
+  }
+  if (keyword == "port") {
+    Port port;
+    std::uint8_t direction = 0;
+    if (!name(port.name) || !tokens.keyword(k_directions, direction))
+      return false;
+    port.direction = static_cast<PortDirection>(direction);
+    return tokens.number(port.width) && tokens.entity(port.owner) &&
+           tokens.entity(port.connected_signal) && tokens.done() &&
+           add(std::move(port));
+  }
+  if (keyword == "signal") {
+    Signal signal;
+    return name(signal.name) && tokens.number(signal.width) &&
+           tokens.entity(signal.scope) &&
+           tokens.entities(signal.connected_ports) && add(std::move(signal));
+  }
+  if (keyword == "hierarchy") {
+    Hierarchy hier;
+    return tokens.entity(hier.parent) && tokens.entities(hier.children) &&
+           add(std::move(hier));
+  }
+  if (keyword == "shader") {
+    ShaderKey key;
+    return name(key.key) && tokens.done() && add(std::move(key));
+  }
+  if (keyword == "wire") {
+    Wire wire;
+    if (!tokens.entity(wire.signal) || !tokens.entity(wire.from_endpoint) ||
+        !tokens.entity(wire.to_endpoint))
+      return false;
+    while (!tokens.done()) {
+      GridCoord point;
+      if (!tokens.coord(point))
+        return false;
+      wire.points.push_back(point);
+    }
+    return add(std::move(wire));
+  }
+  if (keyword == "extent") {
+    ModuleExtent extent;
+    return tokens.number(extent.width) && tokens.number(extent.height) &&
+           tokens.done() && add(extent);
+  }
+  if (keyword == "pixel") {
+    ModulePixelPosition pos;
+    return tokens.number(pos.x) && tokens.number(pos.y) && tokens.done() &&
+           add(pos);
+  }
+  if (keyword == "offset") {
+    PortOffset offset;
+    return tokens.number(offset.x) && tokens.number(offset.y) &&
+           tokens.done() && add(offset);
+  }
+  if (keyword == "side") {
+    std::uint8_t side = 0;
+    return tokens.keyword(k_sides, side) && tokens.done() &&
+           add(PortVisual{static_cast<PortSide>(side)});
+  }
+  if (keyword == "grid") {
+    PortGridPosition grid;
+    return tokens.number(grid.position.x) && tokens.number(grid.position.y) &&
+           tokens.done() && add(grid);
+  }
+  if (keyword == "junction") {
+    WireJunction junction;
+    return tokens.number(junction.point_index) && tokens.done() &&
+           add(junction);
+  }
+  return false;
+}
+
+std::unexpected<TextError> error_at(std::size_t line, std::string message) {
+  return std::unexpected(TextError{line, std::move(message)});
+}
+
+} // namespace
+
+std::expected<void, TextError> save_text(const World &world,
+                                         const std::filesystem::path &path) {
+  auto file = BufferedWriter::open(path);
+  if (!file)
+    return error_at(0, "could not open " + path.string());
+  TextWriter out(std::move(*file));
+
+  out.put(k_header).put(' ').number(k_version).end_line();
+  out.put("bound ").number(world.id_bound()).end_line();
+
+  const auto *defs = world.get_storage<ModuleDef>();
+  const auto *insts = world.get_storage<ModuleInst>();
+  const auto *ports = world.get_storage<Port>();
+  const auto *signals = world.get_storage<Signal>();
+  const auto *hierarchies = world.get_storage<Hierarchy>();
+  const auto *shaders = world.get_storage<ShaderKey>();
+  const auto *wires = world.get_storage<Wire>();
+  const auto *extents = world.get_storage<ModuleExtent>();
+  const auto *pixels = world.get_storage<ModulePixelPosition>();
+  const auto *offsets = world.get_storage<PortOffset>();
+  const auto *visuals = world.get_storage<PortVisual>();
+  const auto *grids = world.get_storage<PortGridPosition>();
+  const auto *junctions = world.get_storage<WireJunction>();
+
+  auto find = [](const auto *storage, EntityID id) {
+    return storage ? storage->get(id) : nullptr;
+  };
+
+  std::vector<EntityID> ids(world.alive_ids().begin(),
+                            world.alive_ids().end());
+  std::sort(ids.begin(), ids.end());
+
+  for (EntityID id : ids) {
+    out.put("entity ").number(id).end_line();
+
+    if (const auto *def = find(defs, id)) {
+      out.line("def ").quoted(world.name(def->name));
+      out.put(def->is_primitive ? " primitive " : " composite ")
+          .entity(def->internal_root)
+          .end_line();
+    }
+    if (const auto *inst = find(insts, id)) {
+      out.line("inst ").quoted(world.name(inst->instance_name)).put(' ');
+      out.entity(inst->definition).end_line();
+    }
+    if (const auto *port = find(ports, id)) {
+      out.line("port ").quoted(world.name(port->name)).put(' ');
+      out.put(k_directions[static_cast<std::size_t>(port->direction)]).put(' ');
+      out.number(port->width).put(' ').entity(port->owner).put(' ');
+      out.entity(port->connected_signal).end_line();
+    }
+    if (const auto *signal = find(signals, id)) {
+      out.line("signal ").quoted(world.name(signal->name)).put(' ');
+      out.number(signal->width).put(' ').entity(signal->scope);
+      for (Entity port : signal->connected_ports)
+        out.put(' ').entity(port);
+      out.end_line();
+    }
+    if (const auto *hier = find(hierarchies, id)) {
+      out.line("hierarchy ").entity(hier->parent);
+      for (Entity child : hier->children)
+        out.put(' ').entity(child);
+      out.end_line();
+    }
+    if (const auto *shader = find(shaders, id)) {
+      out.line("shader ").quoted(world.name(shader->key)).end_line();
+    }
+    if (const auto *wire = find(wires, id)) {
+      out.line("wire ").entity(wire->signal).put(' ');
+      out.entity(wire->from_endpoint).put(' ').entity(wire->to_endpoint);
+      for (const GridCoord &p : wire->points)
+        out.put(' ').number(p.x).put(',').number(p.y);
+      out.end_line();
+    }
+    if (const auto *extent = find(extents, id)) {
+      out.line("extent ").number(extent->width).put(' ');
+      out.number(extent->height).end_line();
+    }
+    if (const auto *pixel = find(pixels, id)) {
+      out.line("pixel ").number(pixel->x).put(' ').number(pixel->y).end_line();
+    }
+    if (const auto *offset = find(offsets, id)) {
+      out.line("offset ").number(offset->x).put(' ');
+      out.number(offset->y).end_line();
+    }
+    if (const auto *visual = find(visuals, id)) {
+      out.line("side ")
+          .put(k_sides[static_cast<std::size_t>(visual->side)])
+          .end_line();
+    }
+    if (const auto *grid = find(grids, id)) {
+      out.line("grid ").number(grid->position.x).put(' ');
+      out.number(grid->position.y).end_line();
+    }
+    if (const auto *junction = find(junctions, id)) {
+      out.line("junction ").number(junction->point_index).end_line();
+    }
+  }
+
+  if (!out.finish())
+    return error_at(0, "write failed");
+  return {};
+}
+
+std::expected<World, TextError>
+load_text(const std::filesystem::path &path) {
+  FilePtr file(std::fopen(path.string().c_str(), "rb"));
+  if (!file)
+    return error_at(0, "could not open " + path.string());
+  std::error_code size_error;
+  const std::uintmax_t file_size = std::filesystem::file_size(path, size_error);
+  if (size_error)
+    return error_at(0, "could not size " + path.string());
+  LineReader reader(std::move(file));
+
+  std::size_t line_number = 0;
+  bool header_seen = false;
+  std::optional<EntityID> bound;
+  std::vector<bool> declared;  // ids seen in 'entity' lines
+  Entity current;              // entity block being parsed
+  std::uint32_t current_kinds = 0; // component kinds seen in the block
+  Batches batches;
+  // Entities are created once 'bound' and the declared ids are known, but
+  // names are interned while parsing.
+  World world;
+
+  while (auto line = reader.next()) {
+    ++line_number;
+    Tokens tokens(*line);
+    if (tokens.done())
+      continue;
+    const auto keyword = tokens.word();
+    if (keyword.starts_with('#'))
+      continue;
+
+    if (!header_seen) {
+      std::uint32_t version = 0;
+      if (keyword != k_header || !tokens.number(version) || !tokens.done())
+        return error_at(line_number, "expected 'netra-design <version>'");
+      if (version != k_version)
+        return error_at(line_number, "unsupported version");
+      header_seen = true;
+      continue;
+    }
+
+    if (keyword == "bound") {
+      EntityID value = 0;
+      if (bound || !tokens.number(value) || !tokens.done() ||
+          value > file_size * k_max_free_ids_per_byte)
+        return error_at(line_number, "malformed 'bound'");
+      bound = value;
+      declared.assign(value, false);
+      continue;
+    }
+    if (!bound)
+      return error_at(line_number, "'bound' must precede entities");
+
+    if (keyword == "entity") {
+      EntityID id = 0;
+      if (!tokens.number(id) || !tokens.done() || id >= *bound)
+        return error_at(line_number, "malformed 'entity'");
+      if (declared[id])
+        return error_at(line_number, "entity declared twice");
+      declared[id] = true;
+      current = Entity(id);
+      current_kinds = 0;
+      continue;
+    }
+    if (!current)
+      return error_at(line_number, "component outside an entity block");
+
+    std::size_t kind = 0;
+    if (!parse_component(keyword, tokens, world, current, batches, kind))
+      return error_at(line_number,
+                      "malformed '" + std::string(keyword) + "'");
+    if (current_kinds & (1u << kind))
+      return error_at(line_number, "component repeated in entity block");
+    current_kinds |= 1u << kind;
+  }
+  if (reader.failed())
+    return error_at(line_number, "read failed");
+  if (!header_seen || !bound)
+    return error_at(line_number, "missing header or 'bound'");
+
+  auto all = world.create_many(*bound);
+  std::erase_if(all, [&declared](Entity e) { return declared[e.id()]; });
+  world.destroy_many(all);
+
+  std::apply([&world](const auto &...batch) { (batch.flush(world), ...); },
+             batches);
+  return world;
+}
+
+} // namespace netra::io
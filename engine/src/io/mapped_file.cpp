@@ -0,0 +1,98 @@
+#include "io/mapped_file.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NETRA_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define NETRA_HAS_MMAP 0
+#endif
+
+namespace netra::io {
+
+std::optional<MappedFile> MappedFile::open(const std::filesystem::path &path) {
+  MappedFile file;
+#if NETRA_HAS_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return std::nullopt;
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    return std::nullopt;
+  }
+  const auto size = static_cast<std::size_t>(info.st_size);
+  if (size > 0) {
+    void *region = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (region == MAP_FAILED) {
+      ::close(fd);
+      return std::nullopt;
+    }
+    file.m_region = region;
+    file.m_size = size;
+  }
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+#else
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in)
+    return std::nullopt;
+  file.m_fallback.resize(static_cast<std::size_t>(in.tellg()));
+  in.seekg(0);
+  if (!in.read(file.m_fallback.data(),
+               static_cast<std::streamsize>(file.m_fallback.size()))) {
+    return std::nullopt;
+  }
+#endif
+  return file;
+}
+
+MappedFile::~MappedFile() { release(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_region(std::exchange(other.m_region, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_fallback(std::move(other.m_fallback)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    release();
+    m_region = std::exchange(other.m_region, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_fallback = std::move(other.m_fallback);
+  }
+  return *this;
+}
+
+std::span<const std::byte> MappedFile::bytes() const {
+  if (m_region) {
+    return {static_cast<const std::byte *>(m_region), m_size};
+  }
+  return std::as_bytes(std::span<const char>(m_fallback));
+}
+
+std::string_view MappedFile::text() const {
+  if (m_region) {
+    return {static_cast<const char *>(m_region), m_size};
+  }
+  return {m_fallback.data(), m_fallback.size()};
+}
+
+void MappedFile::release() {
+#if NETRA_HAS_MMAP
+  if (m_region) {
+    ::munmap(m_region, m_size);
+  }
+#endif
+  m_region = nullptr;
+  m_size = 0;
+  m_fallback.clear();
+}
+
+} // namespace netra::io
@@ -0,0 +1,612 @@
+#include "io/netlist_export.hpp"
+
+#include <components/components.hpp>
+#include <io/buffered_writer.hpp>
+#include <systems/simulation.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace netra::io {
+
+namespace {
+
+// Largest XOR/XNOR written as a BLIF truth table (2^n rows).
+constexpr std::size_t k_max_parity_inputs = 16;
+
+// Items bucketed by an entity key with one counting sort. Items keep their
+// input order within a bucket; invalid keys share a trailing bucket.
+class Groups {
+public:
+  Groups(EntityID id_bound, std::span<const EntityID> keys,
+         std::span<const EntityID> items)
+      : m_bound(id_bound), m_offsets(static_cast<std::size_t>(id_bound) + 2, 0),
+        m_items(items.size()) {
+    for (EntityID key : keys)
+      ++m_offsets[slot(key) + 1];
+    for (std::size_t i = 1; i < m_offsets.size(); ++i)
+      m_offsets[i] += m_offsets[i - 1];
+    std::vector<std::uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    for (std::size_t i = 0; i < items.size(); ++i)
+      m_items[cursor[slot(keys[i])]++] = items[i];
+  }
+
+  std::span<const EntityID> operator[](Entity key) const {
+    const auto s = slot(key.id());
+    return std::span<const EntityID>(m_items).subspan(
+        m_offsets[s], m_offsets[s + 1] - m_offsets[s]);
+  }
+
+private:
+  std::size_t slot(EntityID key) const {
+    return key < m_bound ? key : m_bound;
+  }
+
+  EntityID m_bound;
+  std::vector<std::uint32_t> m_offsets;
+  std::vector<EntityID> m_items;
+};
+
+// Unique names within one namespace (a module, or the set of modules).
+class NameScope {
+public:
+  std::string claim(std::string_view base, EntityID id) {
+    std::string name;
+    for (char c : base)
+      name.push_back(c == ' ' || c == '\t' || c == '\n' ? '_' : c);
+    if (name.empty())
+      name = "n";
+    if (m_used.insert(name).second)
+      return name;
+
+    std::string candidate = name + "_" + std::to_string(id);
+    for (std::size_t k = 1; !m_used.insert(candidate).second; ++k)
+      candidate = name + "_" + std::to_string(id) + "_" + std::to_string(k);
+    return candidate;
+  }
+
+private:
+  std::unordered_set<std::string> m_used;
+};
+
+// ---------------------------------------------------------------------------
+// Netlist model shared by both writers
+// ---------------------------------------------------------------------------
+
+struct Net {
+  std::string name;
+  std::uint32_t width = 1;
+  bool driven = false;
+  bool read = false;
+  std::optional<bool> constant;
+};
+
+struct Pin {
+  std::string_view name; // owned by the World's symbol table
+  PortDirection direction;
+  std::uint32_t net;
+};
+
+struct Instance {
+  std::string name;
+  std::string type; // module or cell name; unused for gates
+  std::optional<GateType> gate;
+  std::vector<Pin> pins;
+};
+
+struct InterfacePort {
+  std::uint32_t net;
+  PortDirection direction;
+};
+
+// `to` is driven by `from` (two interface ports on one Signal).
+struct Alias {
+  std::uint32_t to;
+  std::uint32_t from;
+};
+
+struct Module {
+  std::string name;
+  std::vector<InterfacePort> ports;
+  std::vector<Alias> aliases;
+  std::vector<Net> nets;
+  std::vector<Instance> instances;
+};
+
+struct Context {
+  const World &world;
+  const ComponentStorage<Port> *ports;
+  Groups ports_by_owner;
+  Groups instances_by_parent;
+  std::unordered_map<EntityID, std::string> module_names;
+};
+
+std::optional<GateType> gate_of(const World &world, const ModuleDef &def) {
+  if (!def.is_primitive)
+    return std::nullopt;
+  const GateType type = gate_type_of(world.name(def.name));
+  if (type == GateType::INVALID)
+    return std::nullopt;
+  return type;
+}
+
+std::optional<bool> constant_of(std::string_view name) {
+  if (name == "1'b0")
+    return false;
+  if (name == "1'b1")
+    return true;
+  return std::nullopt;
+}
+
+class ModuleBuilder {
+public:
+  ModuleBuilder(const Context &ctx, std::string name) : m_ctx(ctx) {
+    m_module.name = std::move(name);
+  }
+
+  // Interface ports of a def, each naming its net.
+  void add_interface(Entity def) {
+    for (EntityID id : m_ctx.ports_by_owner[def]) {
+      const Port &port = *m_ctx.ports->get(id);
+      const auto net = new_net(name(port.name), id, port.width);
+      if (auto *existing = signal_slot(port.connected_signal)) {
+        if (*existing != k_no_net)
+          m_module.aliases.push_back(
+              port.direction == PortDirection::In ? Alias{*existing, net}
+                                                  : Alias{net, *existing});
+        else
+          *existing = net;
+      }
+      auto &n = m_module.nets[net];
+      n.driven = n.driven || port.direction != PortDirection::Out;
+      n.read = n.read || port.direction != PortDirection::In;
+      m_module.ports.push_back(InterfacePort{net, port.direction});
+    }
+  }
+
+  std::optional<ExportError> add_instance(EntityID id) {
+    const Entity entity(id);
+    const auto &inst = *m_ctx.world.get<ModuleInst>(entity);
+    const auto *def = m_ctx.world.get<ModuleDef>(inst.definition);
+    if (!def)
+      return ExportError{"instance '" + std::string(name(inst.instance_name)) +
+                         "' has no module definition"};
+
+    Instance out;
+    out.name = m_names.claim(name(inst.instance_name), id);
+    const auto pins = m_ctx.ports_by_owner[entity];
+    out.pins.reserve(pins.size());
+    std::size_t inputs = 0;
+    std::size_t outputs = 0;
+    for (EntityID port_id : pins) {
+      const Port &port = *m_ctx.ports->get(port_id);
+      const auto net = pin_net(port, out.name, port_id);
+      auto &n = m_module.nets[net];
+      n.driven = n.driven || port.direction != PortDirection::In;
+      n.read = n.read || port.direction != PortDirection::Out;
+      inputs += port.direction == PortDirection::In;
+      outputs += port.direction == PortDirection::Out;
+      out.pins.push_back(Pin{name(port.name), port.direction, net});
+    }
+
+    out.gate = gate_of(m_ctx.world, *def);
+    const bool single_input =
+        out.gate == GateType::NOT || out.gate == GateType::BUF;
+    if (out.gate && (outputs != 1 || inputs + outputs != pins.size() ||
+                     (single_input ? inputs != 1 : inputs < 2)))
+      out.gate.reset(); // unusual pin-out: fall back to a cell instance
+    if (!out.gate) {
+      auto it = m_ctx.module_names.find(inst.definition.id());
+      out.type = it != m_ctx.module_names.end() ? it->second
+                                                 : std::string(name(def->name));
+    }
+    m_module.instances.push_back(std::move(out));
+    return std::nullopt;
+  }
+
+  // Top-level interface: undriven nets in, unread nets out.
+  void infer_interface() {
+    for (std::uint32_t n = 0; n < m_module.nets.size(); ++n) {
+      const auto &net = m_module.nets[n];
+      if (net.constant)
+        continue;
+      if (!net.driven)
+        m_module.ports.push_back(InterfacePort{n, PortDirection::In});
+      else if (!net.read)
+        m_module.ports.push_back(InterfacePort{n, PortDirection::Out});
+    }
+  }
+
+  Module take() { return std::move(m_module); }
+
+private:
+  static constexpr std::uint32_t k_no_net = UINT32_MAX;
+
+  std::string_view name(Symbol symbol) const {
+    return m_ctx.world.name(symbol);
+  }
+
+  std::uint32_t new_net(std::string_view base, EntityID id,
+                        std::uint32_t width) {
+    Net net;
+    net.name = m_names.claim(base, id);
+    net.width = width;
+    m_module.nets.push_back(std::move(net));
+    return static_cast<std::uint32_t>(m_module.nets.size() - 1);
+  }
+
+  // Net slot of a Signal, or null for ports with no signal.
+  std::uint32_t *signal_slot(Entity signal) {
+    if (!m_ctx.world.has<Signal>(signal))
+      return nullptr;
+    return &m_net_of_signal.try_emplace(signal.id(), k_no_net).first->second;
+  }
+
+  std::uint32_t pin_net(const Port &port, std::string_view instance,
+                        EntityID port_id) {
+    auto *slot = signal_slot(port.connected_signal);
+    if (!slot) {
+      // Unconnected pin: a net of its own.
+      return new_net(std::string(instance) + "_" + std::string(name(port.name)),
+                     port_id,
+                     port.width);
+    }
+    if (*slot == k_no_net) {
+      const auto &signal = *m_ctx.world.get<Signal>(port.connected_signal);
+      const auto signal_name = name(signal.name);
+      *slot = new_net(signal_name, port.connected_signal.id(), signal.width);
+      m_module.nets[*slot].constant = constant_of(signal_name);
+    }
+    return *slot;
+  }
+
+  const Context &m_ctx;
+  Module m_module;
+  NameScope m_names;
+  std::unordered_map<EntityID, std::uint32_t> m_net_of_signal;
+};
+
+// Modules in output order: the synthesized top, then defs nothing
+// instantiates, then the rest; ties by entity id.
+std::expected<std::vector<Module>, ExportError>
+collect_modules(const World &world, std::string_view top_name) {
+  const ComponentStorage<Port> no_ports;
+  const auto *ports = world.get_storage<Port>();
+  if (!ports)
+    ports = &no_ports;
+
+  std::vector<EntityID> port_owners;
+  port_owners.reserve(ports->size());
+  for (const Port &port : ports->components())
+    port_owners.push_back(port.owner.id());
+
+  std::vector<EntityID> instances;
+  std::vector<EntityID> parents;
+  std::vector<bool> instantiated(world.id_bound(), false);
+  if (const auto *insts = world.get_storage<ModuleInst>()) {
+    instances.assign(insts->entities().begin(), insts->entities().end());
+    for (std::size_t i = 0; i < instances.size(); ++i) {
+      const auto *hier = world.get<Hierarchy>(Entity(instances[i]));
+      parents.push_back(hier ? hier->parent.id() : NullEntity);
+      const auto def = insts->components()[i].definition.id();
+      if (def < instantiated.size())
+        instantiated[def] = true;
+    }
+  }
+
+  Context ctx{world, ports,
+              Groups(world.id_bound(), port_owners, ports->entities()),
+              Groups(world.id_bound(), parents, instances),
+              {}};
+
+  std::vector<EntityID> defs;
+  if (const auto *storage = world.get_storage<ModuleDef>()) {
+    for (std::size_t i = 0; i < storage->size(); ++i)
+      if (!storage->components()[i].is_primitive)
+        defs.push_back(storage->entities()[i]);
+  }
+  std::sort(defs.begin(), defs.end());
+  std::stable_partition(defs.begin(), defs.end(),
+                        [&](EntityID id) { return !instantiated[id]; });
+
+  NameScope module_names;
+  for (EntityID id : defs)
+    ctx.module_names.emplace(
+        id, module_names.claim(
+                world.name(world.get<ModuleDef>(Entity(id))->name), id));
+
+  std::vector<Module> modules;
+  const auto top_level = ctx.instances_by_parent[Entity{}];
+  if (!top_level.empty()) {
+    ModuleBuilder top(ctx, module_names.claim(top_name, 0));
+    for (EntityID id : top_level)
+      if (auto error = top.add_instance(id))
+        return std::unexpected(std::move(*error));
+    top.infer_interface();
+    modules.push_back(top.take());
+  }
+  for (EntityID id : defs) {
+    ModuleBuilder module(ctx, ctx.module_names.at(id));
+    module.add_interface(Entity(id));
+    for (EntityID inst : ctx.instances_by_parent[Entity(id)])
+      if (auto error = module.add_instance(inst))
+        return std::unexpected(std::move(*error));
+    modules.push_back(module.take());
+  }
+  return modules;
+}
+
+// ---------------------------------------------------------------------------
+// Verilog
+// ---------------------------------------------------------------------------
+
+bool is_verilog_keyword(std::string_view name) {
+  static constexpr std::array<std::string_view, 20> k_keywords{
+      "module", "endmodule", "input",  "output", "inout", "wire", "reg",
+      "assign", "and",       "or",     "nand",   "nor",   "xor",  "xnor",
+      "not",    "buf",       "supply0", "supply1", "begin", "end"};
+  return std::find(k_keywords.begin(), k_keywords.end(), name) !=
+         k_keywords.end();
+}
+
+bool is_simple_identifier(std::string_view name) {
+  if (name.empty() || !(std::isalpha(static_cast<unsigned char>(name[0])) ||
+                        name[0] == '_'))
+    return false;
+  return std::all_of(name.begin(), name.end(), [](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+  });
+}
+
+void put_identifier(BufferedWriter &out, std::string_view name) {
+  if (is_simple_identifier(name) && !is_verilog_keyword(name))
+    out.put(name);
+  else
+    out.put('\\').put(name).put(' ');
+}
+
+void put_net(BufferedWriter &out, const Net &net) {
+  if (net.constant)
+    out.put(*net.constant ? "1'b1" : "1'b0");
+  else
+    put_identifier(out, net.name);
+}
+
+void put_range(BufferedWriter &out, std::uint32_t width) {
+  if (width > 1)
+    out.put('[').number(width - 1).put(":0] ");
+}
+
+void write_verilog_module(BufferedWriter &out, const Module &module) {
+  out.put("module ");
+  put_identifier(out, module.name);
+  out.put('(');
+  for (std::size_t i = 0; i < module.ports.size(); ++i) {
+    if (i > 0)
+      out.put(", ");
+    put_identifier(out, module.nets[module.ports[i].net].name);
+  }
+  out.put(");\n");
+
+  std::vector<bool> is_port(module.nets.size(), false);
+  for (const auto &port : module.ports) {
+    static constexpr std::array<std::string_view, 3> k_directions{
+        "  input ", "  output ", "  inout "};
+    const auto &net = module.nets[port.net];
+    is_port[port.net] = true;
+    out.put(k_directions[static_cast<std::size_t>(port.direction)]);
+    put_range(out, net.width);
+    put_identifier(out, net.name);
+    out.put(";\n");
+  }
+  for (std::size_t n = 0; n < module.nets.size(); ++n) {
+    const auto &net = module.nets[n];
+    if (is_port[n] || net.constant)
+      continue;
+    out.put("  wire ");
+    put_range(out, net.width);
+    put_identifier(out, net.name);
+    out.put(";\n");
+  }
+  for (const auto &alias : module.aliases) {
+    out.put("  assign ");
+    put_net(out, module.nets[alias.to]);
+    out.put(" = ");
+    put_net(out, module.nets[alias.from]);
+    out.put(";\n");
+  }
+
+  for (const auto &inst : module.instances) {
+    out.put("  ");
+    if (inst.gate) {
+      // Verilog's gate keywords are the built-in gate names in lower case.
+      for (const char c : gate_name(*inst.gate))
+        out.put(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+      out.put(' ');
+      put_identifier(out, inst.name);
+      // Gate terminals: output first, then inputs.
+      out.put('(');
+      bool first = true;
+      for (auto direction : {PortDirection::Out, PortDirection::In}) {
+        for (const auto &pin : inst.pins) {
+          if (pin.direction != direction)
+            continue;
+          if (!first)
+            out.put(", ");
+          first = false;
+          put_net(out, module.nets[pin.net]);
+        }
+      }
+      out.put(");\n");
+      continue;
+    }
+    put_identifier(out, inst.type);
+    out.put(' ');
+    put_identifier(out, inst.name);
+    out.put('(');
+    for (std::size_t i = 0; i < inst.pins.size(); ++i) {
+      out.put(i > 0 ? ", ." : ".");
+      put_identifier(out, inst.pins[i].name);
+      out.put('(');
+      put_net(out, module.nets[inst.pins[i].net]);
+      out.put(')');
+    }
+    out.put(");\n");
+  }
+  out.put("endmodule\n\n");
+}
+
+// ---------------------------------------------------------------------------
+// BLIF
+// ---------------------------------------------------------------------------
+
+std::optional<ExportError> check_blif(const Module &module) {
+  for (const auto &net : module.nets)
+    if (net.width > 1)
+      return ExportError{"BLIF export: net '" + net.name + "' in module '" +
+                         module.name + "' is wider than one bit"};
+  for (const auto &port : module.ports)
+    if (port.direction == PortDirection::InOut)
+      return ExportError{"BLIF export: module '" + module.name +
+                         "' has an inout port"};
+  for (const auto &inst : module.instances)
+    if (inst.gate == GateType::XOR || inst.gate == GateType::XNOR)
+      if (inst.pins.size() - 1 > k_max_parity_inputs)
+        return ExportError{"BLIF export: '" + inst.name +
+                           "' has too many inputs for a truth table"};
+  return std::nullopt;
+}
+
+// Single-output cover of a gate over n inputs.
+void write_cover(BufferedWriter &out, GateType gate, std::size_t n) {
+  std::string row(n, '-');
+  switch (gate) {
+  case GateType::AND:
+  case GateType::NOR:
+    row.assign(n, gate == GateType::AND ? '1' : '0');
+    out.put(row).put(" 1\n");
+    break;
+  case GateType::OR:
+  case GateType::NAND:
+    for (std::size_t i = 0; i < n; ++i) {
+      row.assign(n, '-');
+      row[i] = gate == GateType::OR ? '1' : '0';
+      out.put(row).put(" 1\n");
+    }
+    break;
+  case GateType::XOR:
+  case GateType::XNOR:
+    for (std::size_t mask = 0; mask < (std::size_t{1} << n); ++mask) {
+      const bool odd = std::popcount(mask) % 2 == 1;
+      if (odd != (gate == GateType::XOR))
+        continue;
+      for (std::size_t i = 0; i < n; ++i)
+        row[i] = (mask >> (n - 1 - i)) & 1 ? '1' : '0';
+      out.put(row).put(" 1\n");
+    }
+    break;
+  case GateType::NOT:
+    out.put("0 1\n");
+    break;
+  case GateType::BUF:
+    out.put("1 1\n");
+    break;
+  case GateType::INVALID:
+  case GateType::COUNT:
+    break;
+  }
+}
+
+void write_blif_model(BufferedWriter &out, const Module &module) {
+  out.put(".model ").put(module.name).put('\n');
+  for (auto direction : {PortDirection::In, PortDirection::Out}) {
+    out.put(direction == PortDirection::In ? ".inputs" : ".outputs");
+    for (const auto &port : module.ports)
+      if (port.direction == direction)
+        out.put(' ').put(module.nets[port.net].name);
+    out.put('\n');
+  }
+
+  for (const auto &net : module.nets) {
+    if (!net.constant)
+      continue;
+    out.put(".names ").put(net.name).put('\n');
+    if (*net.constant)
+      out.put("1\n");
+  }
+  for (const auto &alias : module.aliases) {
+    out.put(".names ").put(module.nets[alias.from].name).put(' ');
+    out.put(module.nets[alias.to].name).put("\n1 1\n");
+  }
+
+  for (const auto &inst : module.instances) {
+    if (inst.gate) {
+      out.put(".names");
+      std::size_t inputs = 0;
+      const Pin *output = nullptr;
+      for (const auto &pin : inst.pins) {
+        if (pin.direction == PortDirection::Out) {
+          output = &pin;
+          continue;
+        }
+        out.put(' ').put(module.nets[pin.net].name);
+        ++inputs;
+      }
+      out.put(' ').put(module.nets[output->net].name).put('\n');
+      write_cover(out, *inst.gate, inputs);
+      continue;
+    }
+    out.put(".subckt ").put(inst.type);
+    for (const auto &pin : inst.pins)
+      out.put(' ').put(pin.name).put('=').put(module.nets[pin.net].name);
+    out.put('\n');
+  }
+  out.put(".end\n\n");
+}
+
+template <typename WriteModule>
+std::expected<void, ExportError>
+write_netlist(const std::vector<Module> &modules,
+              const std::filesystem::path &path, WriteModule &&write_module) {
+  auto out = BufferedWriter::open(path);
+  if (!out)
+    return std::unexpected(ExportError{"could not open " + path.string()});
+  for (const auto &module : modules)
+    write_module(*out, module);
+  if (!out->finish())
+    return std::unexpected(ExportError{"write failed"});
+  return {};
+}
+
+} // namespace
+
+std::expected<void, ExportError>
+export_verilog(const World &world, const std::filesystem::path &path,
+               std::string_view top_name) {
+  auto modules = collect_modules(world, top_name);
+  if (!modules)
+    return std::unexpected(std::move(modules.error()));
+  return write_netlist(*modules, path, write_verilog_module);
+}
+
+std::expected<void, ExportError>
+export_blif(const World &world, const std::filesystem::path &path,
+            std::string_view top_name) {
+  auto modules = collect_modules(world, top_name);
+  if (!modules)
+    return std::unexpected(std::move(modules.error()));
+  for (const auto &module : *modules)
+    if (auto error = check_blif(module))
+      return std::unexpected(std::move(*error));
+  return write_netlist(*modules, path, write_blif_model);
+}
+
+} // namespace netra::io
@@ -0,0 +1,1026 @@
+#include "io/verilog_import.hpp"
+
+#include <components/components.hpp>
+#include <io/mapped_file.hpp>
+#include <systems/simulation.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace netra::io {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Lexer
+// ---------------------------------------------------------------------------
+
+enum class TokenKind : std::uint8_t { End, Identifier, Number, Punct };
+
+struct Token {
+  TokenKind kind = TokenKind::End;
+  std::string_view text;
+  std::size_t line = 1;
+  bool escaped = false; // \escaped identifier, never a keyword
+};
+
+bool is_ident_start(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool is_ident_char(char c) {
+  return is_ident_start(c) || (c >= '0' && c <= '9') || c == '$';
+}
+
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+         c == '\v';
+}
+
+// Tokens are views into the source; nothing is copied.
+class Lexer {
+public:
+  explicit Lexer(std::string_view source) : m_src(source) {}
+
+  Token next() {
+    skip_trivia();
+    Token token;
+    token.line = m_line;
+    if (m_pos >= m_src.size())
+      return token;
+
+    const std::size_t start = m_pos;
+    const char c = m_src[m_pos];
+    if (is_ident_start(c)) {
+      while (m_pos < m_src.size() && is_ident_char(m_src[m_pos]))
+        ++m_pos;
+      token.kind = TokenKind::Identifier;
+    } else if (c == '\\') {
+      // Escaped identifier: everything up to the next whitespace.
+      ++m_pos;
+      while (m_pos < m_src.size() && !is_space(m_src[m_pos]))
+        ++m_pos;
+      token.kind = TokenKind::Identifier;
+      token.escaped = true;
+      token.text = m_src.substr(start + 1, m_pos - start - 1);
+      return token;
+    } else if (is_digit(c) || c == '\'') {
+      lex_number();
+      token.kind = TokenKind::Number;
+    } else {
+      ++m_pos;
+      token.kind = TokenKind::Punct;
+    }
+    token.text = m_src.substr(start, m_pos - start);
+    return token;
+  }
+
+private:
+  // [size]'[s]base digits, or a plain decimal.
+  void lex_number() {
+    while (m_pos < m_src.size() &&
+           (is_digit(m_src[m_pos]) || m_src[m_pos] == '_'))
+      ++m_pos;
+    if (m_pos >= m_src.size() || m_src[m_pos] != '\'')
+      return;
+    ++m_pos;
+    if (m_pos < m_src.size() && (m_src[m_pos] == 's' || m_src[m_pos] == 'S'))
+      ++m_pos;
+    if (m_pos < m_src.size())
+      ++m_pos; // base letter
+    while (m_pos < m_src.size() &&
+           (is_ident_char(m_src[m_pos]) || m_src[m_pos] == '?'))
+      ++m_pos;
+  }
+
+  // Whitespace, comments, (* attributes *) and `directives.
+  void skip_trivia() {
+    while (m_pos < m_src.size()) {
+      const char c = m_src[m_pos];
+      if (c == '\n') {
+        ++m_line;
+        ++m_pos;
+      } else if (is_space(c)) {
+        ++m_pos;
+      } else if (starts_with("//") || c == '`') {
+        skip_past("\n");
+      } else if (starts_with("/*")) {
+        skip_past("*/");
+      } else if (starts_with("(*") && !starts_with("(*)")) {
+        skip_past("*)");
+      } else {
+        return;
+      }
+    }
+  }
+
+  bool starts_with(std::string_view s) const {
+    return m_src.substr(m_pos).starts_with(s);
+  }
+
+  void skip_past(std::string_view terminator) {
+    const auto end = m_src.find(terminator, m_pos);
+    const std::size_t stop =
+        end == std::string_view::npos ? m_src.size() : end + terminator.size();
+    m_line += static_cast<std::size_t>(
+        std::count(m_src.begin() + static_cast<std::ptrdiff_t>(m_pos),
+                   m_src.begin() + static_cast<std::ptrdiff_t>(stop), '\n'));
+    m_pos = stop;
+  }
+
+  std::string_view m_src;
+  std::size_t m_pos = 0;
+  std::size_t m_line = 1;
+};
+
+// ---------------------------------------------------------------------------
+// Parsed netlist
+// ---------------------------------------------------------------------------
+
+using NameId = std::uint32_t;
+constexpr NameId k_no_name = std::numeric_limits<NameId>::max();
+constexpr std::uint32_t k_no_net = std::numeric_limits<std::uint32_t>::max();
+
+// Interns identifiers as dense ids. Names are views into the source.
+class Interner {
+public:
+  NameId intern(std::string_view text) {
+    auto [it, inserted] =
+        m_index.try_emplace(text, static_cast<NameId>(m_names.size()));
+    if (inserted)
+      m_names.push_back(text);
+    return it->second;
+  }
+
+  std::string_view name(NameId symbol) const { return m_names[symbol]; }
+  std::size_t size() const { return m_names.size(); }
+
+  void reserve(std::size_t count) {
+    m_index.reserve(count);
+    m_names.reserve(count);
+  }
+
+private:
+  std::unordered_map<std::string_view, NameId> m_index;
+  std::vector<std::string_view> m_names;
+};
+
+constexpr std::size_t k_gate_count = static_cast<std::size_t>(GateType::INVALID);
+
+// Verilog's gate keywords are the built-in gate names in lower case.
+std::optional<GateType> gate_of_keyword(std::string_view word) {
+  for (std::size_t g = 0; g < k_gate_count; ++g) {
+    const auto type = static_cast<GateType>(g);
+    if (std::ranges::equal(word, gate_name(type), [](char w, char n) {
+          return w == std::tolower(static_cast<unsigned char>(n));
+        }))
+      return type;
+  }
+  return std::nullopt;
+}
+
+struct NetDecl {
+  NameId name;
+  std::uint32_t width = 1;
+  std::uint32_t alias;                  // union-find parent
+  std::optional<std::uint64_t> constant; // literal nets only
+};
+
+struct PortDecl {
+  NameId name;
+  std::optional<PortDirection> direction;
+  std::uint32_t net;
+};
+
+struct Connection {
+  NameId port = k_no_name; // k_no_name for positional connections
+  std::uint32_t net = k_no_net;
+};
+
+struct InstanceDecl {
+  NameId type;
+  NameId name;
+  std::optional<GateType> gate;
+  std::uint32_t first_connection;
+  std::uint32_t connection_count;
+  std::size_t line;
+};
+
+struct ModuleDecl {
+  NameId name;
+  std::size_t line;
+  std::vector<PortDecl> ports;
+  std::vector<NetDecl> nets;
+  std::vector<InstanceDecl> instances;
+  std::vector<Connection> connections;
+};
+
+std::uint32_t find_root(std::vector<NetDecl> &nets, std::uint32_t net) {
+  while (nets[net].alias != net) {
+    nets[net].alias = nets[nets[net].alias].alias;
+    net = nets[net].alias;
+  }
+  return net;
+}
+
+// Parses a literal into (width, value). x/z digits read as 0.
+std::optional<std::pair<std::uint32_t, std::uint64_t>>
+parse_literal(std::string_view text) {
+  std::string digits;
+  const auto tick = text.find('\'');
+  std::uint32_t width = 32;
+  unsigned base = 10;
+  std::string_view body = text;
+  if (tick != std::string_view::npos) {
+    if (tick > 0) {
+      for (char c : text.substr(0, tick))
+        if (c != '_')
+          digits.push_back(c);
+      if (std::from_chars(digits.data(), digits.data() + digits.size(), width)
+                  .ec != std::errc{} ||
+          width == 0)
+        return std::nullopt;
+    }
+    body = text.substr(tick + 1);
+    if (!body.empty() && (body.front() == 's' || body.front() == 'S'))
+      body.remove_prefix(1);
+    if (body.empty())
+      return std::nullopt;
+    switch (body.front()) {
+    case 'b':
+    case 'B':
+      base = 2;
+      break;
+    case 'o':
+    case 'O':
+      base = 8;
+      break;
+    case 'd':
+    case 'D':
+      base = 10;
+      break;
+    case 'h':
+    case 'H':
+      base = 16;
+      break;
+    default:
+      return std::nullopt;
+    }
+    body.remove_prefix(1);
+  }
+  if (width > 64)
+    return std::nullopt;
+
+  digits.clear();
+  for (char c : body) {
+    if (c == '_')
+      continue;
+    digits.push_back((c == 'x' || c == 'X' || c == 'z' || c == 'Z' || c == '?')
+                         ? '0'
+                         : c);
+  }
+  std::uint64_t value = 0;
+  if (digits.empty() ||
+      std::from_chars(digits.data(), digits.data() + digits.size(), value, base)
+              .ec != std::errc{})
+    return std::nullopt;
+  return std::pair{width, value};
+}
+
+// ---------------------------------------------------------------------------
+// Parser
+// ---------------------------------------------------------------------------
+
+// Recursive descent over the token stream. Every parse_* returns false after
+// recording the first error.
+class Parser {
+public:
+  explicit Parser(std::string_view source) : m_lexer(source) {
+    // Rough guess of one distinct name per ~32 bytes of netlist, to avoid
+    // rehashing the symbol table through a large import.
+    m_symbols.reserve(source.size() / 32);
+    advance();
+  }
+
+  bool parse() {
+    while (m_token.kind != TokenKind::End) {
+      if (!keyword("module"))
+        return fail("expected 'module'");
+      if (!parse_module())
+        return false;
+    }
+    return true;
+  }
+
+  const VerilogError &error() const { return m_error; }
+  Interner &symbols() { return m_symbols; }
+  std::vector<ModuleDecl> &modules() { return m_modules; }
+  std::unordered_map<NameId, std::size_t> &module_index() {
+    return m_module_index;
+  }
+
+private:
+  void advance() { m_token = m_lexer.next(); }
+
+  bool fail(std::string message) {
+    m_error = VerilogError{m_token.line, std::move(message)};
+    return false;
+  }
+
+  bool keyword(std::string_view word) const {
+    return m_token.kind == TokenKind::Identifier && !m_token.escaped &&
+           m_token.text == word;
+  }
+
+  bool punct(char c) const {
+    return m_token.kind == TokenKind::Punct && m_token.text.front() == c;
+  }
+
+  bool accept(char c) {
+    if (!punct(c))
+      return false;
+    advance();
+    return true;
+  }
+
+  bool expect(char c) {
+    if (accept(c))
+      return true;
+    return fail(std::string("expected '") + c + "'");
+  }
+
+  bool identifier(NameId &out) {
+    if (m_token.kind != TokenKind::Identifier)
+      return fail("expected an identifier");
+    out = m_symbols.intern(m_token.text);
+    advance();
+    return true;
+  }
+
+  bool integer(std::int64_t &out) {
+    if (m_token.kind != TokenKind::Number)
+      return fail("expected a number");
+    auto literal = parse_literal(m_token.text);
+    if (!literal)
+      return fail("malformed number");
+    out = static_cast<std::int64_t>(literal->second);
+    advance();
+    return true;
+  }
+
+  std::optional<PortDirection> direction_keyword() const {
+    if (keyword("input"))
+      return PortDirection::In;
+    if (keyword("output"))
+      return PortDirection::Out;
+    if (keyword("inout"))
+      return PortDirection::InOut;
+    return std::nullopt;
+  }
+
+  bool net_type_keyword() const {
+    return keyword("wire") || keyword("reg") || keyword("tri") ||
+           keyword("wand") || keyword("wor") || keyword("supply0") ||
+           keyword("supply1") || keyword("logic");
+  }
+
+  std::optional<GateType> gate_keyword() const {
+    if (m_token.kind != TokenKind::Identifier || m_token.escaped)
+      return std::nullopt;
+    return gate_of_keyword(m_token.text);
+  }
+
+  // Skips a balanced ( ... ) group, used for parameters and delays.
+  bool skip_parens() {
+    if (!expect('('))
+      return false;
+    for (int depth = 1; depth > 0; advance()) {
+      if (m_token.kind == TokenKind::End)
+        return fail("unbalanced parentheses");
+      if (punct('('))
+        ++depth;
+      else if (punct(')'))
+        --depth;
+    }
+    return true;
+  }
+
+  // Optional [msb:lsb]; width 1 when absent.
+  bool range(std::uint32_t &width) {
+    width = 1;
+    if (!accept('['))
+      return true;
+    std::int64_t msb = 0;
+    std::int64_t lsb = 0;
+    if (!integer(msb) || !expect(':') || !integer(lsb) || !expect(']'))
+      return false;
+    width = static_cast<std::uint32_t>((msb > lsb ? msb - lsb : lsb - msb) + 1);
+    return true;
+  }
+
+  // Net of `name` in the module being parsed, created on first use.
+  std::uint32_t net_for(ModuleDecl &module, NameId name, std::uint32_t width) {
+    if (name >= m_symbol_net.size())
+      m_symbol_net.resize(name + 1, k_no_net);
+    auto &net = m_symbol_net[name];
+    if (net == k_no_net) {
+      net = static_cast<std::uint32_t>(module.nets.size());
+      module.nets.push_back(NetDecl{name, width, net, std::nullopt});
+    }
+    return net;
+  }
+
+  // identifier or a literal. A select names part of a vector Signal, which
+  // a Port cannot connect to, so it is rejected rather than imported as an
+  // unrelated net.
+  bool net_ref(ModuleDecl &module, std::uint32_t &net) {
+    if (m_token.kind == TokenKind::Number) {
+      auto literal = parse_literal(m_token.text);
+      if (!literal)
+        return fail("unsupported literal '" + std::string(m_token.text) + "'");
+      net = net_for(module, m_symbols.intern(m_token.text), literal->first);
+      module.nets[net].constant = literal->second;
+      advance();
+      return true;
+    }
+    if (m_token.kind != TokenKind::Identifier)
+      return fail("expected a net; expressions and concatenations are not "
+                  "supported");
+    const auto name = m_symbols.intern(m_token.text);
+    advance();
+    if (punct('['))
+      return fail("bit- and part-selects are not supported; name each bit "
+                  "as its own net");
+    net = net_for(module, name, 1);
+    return true;
+  }
+
+  bool parse_module() {
+    advance(); // module
+    ModuleDecl module;
+    module.line = m_token.line;
+    if (!identifier(module.name))
+      return false;
+    if (m_module_index.contains(module.name))
+      return fail("module '" + std::string(m_symbols.name(module.name)) +
+                  "' defined twice");
+    if (punct('#')) {
+      advance();
+      if (!skip_parens())
+        return false;
+    }
+    if (accept('(') && !accept(')')) {
+      if (!parse_port_list(module) || !expect(')'))
+        return false;
+    }
+    if (!expect(';'))
+      return false;
+
+    while (!keyword("endmodule")) {
+      if (m_token.kind == TokenKind::End)
+        return fail("missing 'endmodule'");
+      if (!parse_item(module))
+        return false;
+    }
+    advance();
+    for (const auto &net : module.nets)
+      m_symbol_net[net.name] = k_no_net;
+
+    for (const auto &port : module.ports) {
+      if (!port.direction) {
+        m_error = VerilogError{module.line,
+                               "port '" + std::string(m_symbols.name(port.name)) +
+                                   "' has no direction"};
+        return false;
+      }
+    }
+    m_module_index.emplace(module.name, m_modules.size());
+    m_modules.push_back(std::move(module));
+    return true;
+  }
+
+  bool parse_port_list(ModuleDecl &module) {
+    std::optional<PortDirection> direction;
+    std::uint32_t width = 1;
+    do {
+      // ANSI style: a direction starts a new group of declarations.
+      if (auto dir = direction_keyword()) {
+        direction = dir;
+        advance();
+        if (net_type_keyword())
+          advance();
+        if (!range(width))
+          return false;
+      }
+      NameId name = k_no_name;
+      if (!identifier(name))
+        return false;
+      module.ports.push_back(
+          PortDecl{name, direction, net_for(module, name, width)});
+    } while (accept(','));
+    return true;
+  }
+
+  bool parse_item(ModuleDecl &module) {
+    if (auto direction = direction_keyword())
+      return parse_port_declaration(module, *direction);
+    if (net_type_keyword())
+      return parse_net_declaration(module);
+    if (keyword("assign"))
+      return parse_assign(module);
+    if (keyword("parameter") || keyword("localparam") ||
+        keyword("defparam")) {
+      while (!accept(';')) {
+        if (m_token.kind == TokenKind::End)
+          return fail("expected ';'");
+        advance();
+      }
+      return true;
+    }
+    if (auto gate = gate_keyword())
+      return parse_gate(module, *gate);
+    if (m_token.kind == TokenKind::Identifier && !is_reserved())
+      return parse_instance(module);
+    return fail("unsupported construct '" + std::string(m_token.text) + "'");
+  }
+
+  bool is_reserved() const {
+    return keyword("always") || keyword("initial") || keyword("function") ||
+           keyword("task") || keyword("generate") || keyword("begin") ||
+           keyword("end") || keyword("module");
+  }
+
+  bool parse_port_declaration(ModuleDecl &module, PortDirection direction) {
+    advance();
+    if (net_type_keyword())
+      advance();
+    std::uint32_t width = 1;
+    if (!range(width))
+      return false;
+    do {
+      NameId name = k_no_name;
+      if (!identifier(name))
+        return false;
+      auto port = std::find_if(module.ports.begin(), module.ports.end(),
+                               [name](const PortDecl &p) { return p.name == name; });
+      if (port == module.ports.end())
+        return fail("'" + std::string(m_symbols.name(name)) +
+                    "' is not in the port list");
+      port->direction = direction;
+      module.nets[port->net].width = width;
+    } while (accept(','));
+    return expect(';');
+  }
+
+  bool parse_net_declaration(ModuleDecl &module) {
+    advance();
+    std::uint32_t width = 1;
+    if (!range(width))
+      return false;
+    do {
+      NameId name = k_no_name;
+      if (!identifier(name))
+        return false;
+      const auto net = net_for(module, name, width);
+      module.nets[net].width = width;
+      if (accept('=')) {
+        std::uint32_t source = k_no_net;
+        if (!net_ref(module, source) || !alias(module, net, source))
+          return false;
+      }
+    } while (accept(','));
+    return expect(';');
+  }
+
+  bool parse_assign(ModuleDecl &module) {
+    advance();
+    do {
+      std::uint32_t target = k_no_net;
+      std::uint32_t source = k_no_net;
+      if (!net_ref(module, target) || !expect('=') ||
+          !net_ref(module, source))
+        return false;
+      if (!punct(',') && !punct(';'))
+        return fail("only net-to-net assign is supported");
+      if (!alias(module, target, source))
+        return false;
+    } while (accept(','));
+    return expect(';');
+  }
+
+  // Merges two nets; the earlier-declared one names the Signal. Fails if
+  // both already carry different constants.
+  bool alias(ModuleDecl &module, std::uint32_t a, std::uint32_t b) {
+    a = find_root(module.nets, a);
+    b = find_root(module.nets, b);
+    if (a == b)
+      return true;
+    if (b < a)
+      std::swap(a, b);
+    auto &kept = module.nets[a].constant;
+    const auto &merged = module.nets[b].constant;
+    if (kept && merged && *kept != *merged)
+      return fail("net '" + std::string(m_symbols.name(module.nets[a].name)) +
+                  "' is tied to two different constants");
+    module.nets[b].alias = a;
+    if (merged)
+      kept = merged;
+    return true;
+  }
+
+  bool parse_gate(ModuleDecl &module, GateType gate) {
+    const NameId type = m_symbols.intern(m_token.text);
+    advance();
+    if (accept('#')) {
+      // Delay: #5 or #(1, 2).
+      if (m_token.kind == TokenKind::Number)
+        advance();
+      else if (!skip_parens())
+        return false;
+    }
+    do {
+      InstanceDecl instance{type, k_no_name, gate,
+                            static_cast<std::uint32_t>(module.connections.size()),
+                            0, m_token.line};
+      if (m_token.kind == TokenKind::Identifier) {
+        instance.name = m_symbols.intern(m_token.text);
+        advance();
+      }
+      if (punct('['))
+        return fail("instance arrays are not supported");
+      if (!expect('('))
+        return false;
+      do {
+        Connection connection;
+        if (!net_ref(module, connection.net))
+          return false;
+        module.connections.push_back(connection);
+      } while (accept(','));
+      if (!expect(')'))
+        return false;
+
+      instance.connection_count =
+          static_cast<std::uint32_t>(module.connections.size()) -
+          instance.first_connection;
+      const bool single_input = gate == GateType::NOT || gate == GateType::BUF;
+      if (single_input ? instance.connection_count != 2
+                       : instance.connection_count < 3) {
+        m_error = VerilogError{instance.line,
+                               single_input
+                                   ? "not/buf take one output and one input"
+                                   : "gate needs an output and two or more "
+                                     "inputs"};
+        return false;
+      }
+      module.instances.push_back(instance);
+    } while (accept(','));
+    return expect(';');
+  }
+
+  bool parse_instance(ModuleDecl &module) {
+    const NameId type = m_symbols.intern(m_token.text);
+    advance();
+    if (punct('#')) {
+      advance();
+      if (!skip_parens())
+        return false;
+    }
+    do {
+      InstanceDecl instance{type, k_no_name, std::nullopt,
+                            static_cast<std::uint32_t>(module.connections.size()),
+                            0, m_token.line};
+      if (!identifier(instance.name))
+        return false;
+      if (punct('['))
+        return fail("instance arrays are not supported");
+      if (!expect('('))
+        return false;
+      if (!punct(')') && !parse_connections(module))
+        return false;
+      if (!expect(')'))
+        return false;
+      instance.connection_count =
+          static_cast<std::uint32_t>(module.connections.size()) -
+          instance.first_connection;
+      module.instances.push_back(instance);
+    } while (accept(','));
+    return expect(';');
+  }
+
+  bool parse_connections(ModuleDecl &module) {
+    const bool named = punct('.');
+    do {
+      Connection connection;
+      if (named) {
+        if (!expect('.') || !identifier(connection.port) || !expect('('))
+          return false;
+        if (!punct(')') && !net_ref(module, connection.net))
+          return false;
+        if (!expect(')'))
+          return false;
+      } else if (!punct(',') && !punct(')')) {
+        if (!net_ref(module, connection.net))
+          return false;
+      }
+      module.connections.push_back(connection);
+    } while (accept(','));
+    return true;
+  }
+
+  Lexer m_lexer;
+  Token m_token;
+  VerilogError m_error;
+  Interner m_symbols;
+  std::vector<ModuleDecl> m_modules;
+  std::unordered_map<NameId, std::size_t> m_module_index;
+  // NameId -> net of the current module; reset after each module so the
+  // lookup is an array index instead of a second hash.
+  std::vector<std::uint32_t> m_symbol_net;
+};
+
+// ---------------------------------------------------------------------------
+// Building
+// ---------------------------------------------------------------------------
+
+template <typename T> struct Batch {
+  std::vector<Entity> entities;
+  std::vector<T> components;
+
+  void add(Entity e, T component) {
+    entities.push_back(e);
+    components.push_back(std::move(component));
+  }
+
+  void flush(World &world) const {
+    if (!entities.empty())
+      world.emplace_many<T>(entities, components);
+  }
+};
+
+std::string input_port_name(std::size_t index) {
+  if (index < 26)
+    return std::string(1, static_cast<char>('A' + index));
+  return "I" + std::to_string(index);
+}
+
+// Resolves user-module instance connections to port indices of the
+// instantiated module. Returns the first error, if any.
+std::optional<VerilogError>
+resolve_instances(Parser &parser,
+                  std::vector<std::vector<std::uint32_t>> &bindings) {
+  auto &modules = parser.modules();
+  auto &symbols = parser.symbols();
+  for (auto &module : modules) {
+    for (const auto &instance : module.instances) {
+      if (instance.gate)
+        continue;
+      const auto target = parser.module_index().find(instance.type);
+      if (target == parser.module_index().end())
+        return VerilogError{instance.line,
+                            "unknown module '" +
+                                std::string(symbols.name(instance.type)) + "'"};
+      const auto &ports = modules[target->second].ports;
+
+      // bindings[i][p] = net connected to port p of instance i.
+      auto &binding = bindings.emplace_back(ports.size(), k_no_net);
+      for (std::uint32_t c = 0; c < instance.connection_count; ++c) {
+        const auto &connection =
+            module.connections[instance.first_connection + c];
+        std::size_t port = c;
+        if (connection.port != k_no_name) {
+          auto it = std::find_if(ports.begin(), ports.end(),
+                                 [&](const PortDecl &p) {
+                                   return p.name == connection.port;
+                                 });
+          if (it == ports.end())
+            return VerilogError{
+                instance.line,
+                "module '" + std::string(symbols.name(instance.type)) +
+                    "' has no port '" +
+                    std::string(symbols.name(connection.port)) + "'"};
+          port = static_cast<std::size_t>(it - ports.begin());
+        } else if (port >= ports.size()) {
+          return VerilogError{instance.line, "too many connections"};
+        }
+        binding[port] = connection.net;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<Entity>
+build(World &world, Parser &parser,
+      const std::vector<std::vector<std::uint32_t>> &bindings) {
+  auto &modules = parser.modules();
+  auto &symbols = parser.symbols();
+
+  // Parser names are interned into the World on first use, so names of
+  // nets and modules that end up unused never reach its symbol table.
+  std::vector<std::optional<Symbol>> interned(symbols.size());
+  auto world_name = [&](NameId id) {
+    auto &symbol = interned[id];
+    if (!symbol)
+      symbol = world.intern(symbols.name(id));
+    return *symbol;
+  };
+  std::vector<Symbol> input_names;
+  auto input_name = [&](std::size_t index) {
+    while (input_names.size() <= index)
+      input_names.push_back(world.intern(input_port_name(input_names.size())));
+    return input_names[index];
+  };
+  const Symbol output_name = world.intern("Y");
+
+  // Shared primitive defs, reusing those already in the World.
+  std::array<Entity, k_gate_count> gate_defs{};
+  std::array<bool, k_gate_count> gate_used{};
+  for (const auto &module : modules)
+    for (const auto &instance : module.instances)
+      if (instance.gate)
+        gate_used[static_cast<std::size_t>(*instance.gate)] = true;
+  world.view<ModuleDef>().each([&](Entity entity, ModuleDef &def) {
+    if (!def.is_primitive)
+      return;
+    const GateType type = gate_type_of(world.name(def.name));
+    if (type != GateType::INVALID &&
+        !gate_defs[static_cast<std::size_t>(type)])
+      gate_defs[static_cast<std::size_t>(type)] = entity;
+  });
+
+  // Count every entity up front and create them in one batch.
+  std::size_t total = 0;
+  for (std::size_t g = 0; g < gate_defs.size(); ++g)
+    total += gate_used[g] && !gate_defs[g];
+  for (auto &module : modules) {
+    total += 1 + module.ports.size();
+    for (std::uint32_t n = 0; n < module.nets.size(); ++n)
+      total += find_root(module.nets, n) == n;
+    for (const auto &instance : module.instances) {
+      total += 1;
+      total += instance.gate
+                   ? instance.connection_count
+                   : modules[parser.module_index().at(instance.type)].ports.size();
+    }
+  }
+  const std::vector<Entity> entities = world.create_many(total);
+  auto next = entities.begin();
+
+  Batch<ModuleDef> defs;
+  Batch<ModuleInst> insts;
+  Batch<Port> ports;
+  Batch<Signal> signals;
+  Batch<Hierarchy> hierarchies;
+  Batch<BitValue> values;
+
+  for (std::size_t g = 0; g < gate_defs.size(); ++g) {
+    if (gate_used[g] && !gate_defs[g]) {
+      gate_defs[g] = *next++;
+      defs.add(gate_defs[g],
+               ModuleDef{world.intern(gate_name(static_cast<GateType>(g))),
+                         true});
+    }
+  }
+
+  std::vector<Entity> module_defs;
+  module_defs.reserve(modules.size());
+  for (const auto &module : modules) {
+    module_defs.push_back(*next++);
+    defs.add(module_defs.back(),
+             ModuleDef{world_name(module.name), false});
+  }
+
+  auto binding = bindings.begin();
+  std::vector<Entity> net_signal;
+  std::vector<std::vector<Entity>> net_ports;
+  for (std::size_t m = 0; m < modules.size(); ++m) {
+    auto &module = modules[m];
+    const Entity def = module_defs[m];
+    std::vector<Entity> def_children;
+
+    net_signal.assign(module.nets.size(), Entity{});
+    net_ports.assign(module.nets.size(), {});
+    for (std::uint32_t n = 0; n < module.nets.size(); ++n)
+      if (find_root(module.nets, n) == n)
+        net_signal[n] = *next++;
+    for (std::uint32_t n = 0; n < module.nets.size(); ++n)
+      net_signal[n] = net_signal[find_root(module.nets, n)];
+
+    auto add_port = [&](Symbol name, PortDirection direction,
+                        std::uint32_t width, Entity owner, std::uint32_t net) {
+      const Entity port = *next++;
+      Entity signal;
+      if (net != k_no_net) {
+        signal = net_signal[net];
+        net_ports[find_root(module.nets, net)].push_back(port);
+      }
+      ports.add(port, Port{name, direction, width, owner, signal});
+      return port;
+    };
+
+    for (const auto &port : module.ports) {
+      def_children.push_back(add_port(world_name(port.name), *port.direction,
+                                      module.nets[port.net].width, def,
+                                      port.net));
+    }
+
+    std::size_t unnamed = 0;
+    for (const auto &instance : module.instances) {
+      const Entity inst = *next++;
+      def_children.push_back(inst);
+      std::vector<Entity> children;
+
+      Symbol name;
+      if (instance.name != k_no_name)
+        name = world_name(instance.name);
+      else
+        name = world.intern(std::string(symbols.name(instance.type)) + "_" +
+                            std::to_string(unnamed++));
+
+      if (instance.gate) {
+        const auto g = static_cast<std::size_t>(*instance.gate);
+        insts.add(inst, ModuleInst{name, gate_defs[g]});
+        // Verilog lists the output first; the editor's gates put inputs
+        // first, which is also the order Simulation reads them in.
+        const auto *first = &module.connections[instance.first_connection];
+        for (std::uint32_t i = 1; i < instance.connection_count; ++i) {
+          children.push_back(add_port(input_name(i - 1),
+                                      PortDirection::In, 1, inst, first[i].net));
+        }
+        children.push_back(
+            add_port(output_name, PortDirection::Out, 1, inst, first[0].net));
+      } else {
+        const auto target = parser.module_index().at(instance.type);
+        insts.add(inst, ModuleInst{name, module_defs[target]});
+        const auto &target_module = modules[target];
+        for (std::size_t p = 0; p < target_module.ports.size(); ++p) {
+          const auto &port = target_module.ports[p];
+          children.push_back(add_port(
+              world_name(port.name), *port.direction,
+              target_module.nets[port.net].width, inst, (*binding)[p]));
+        }
+        ++binding;
+      }
+      hierarchies.add(inst, Hierarchy{def, std::move(children)});
+    }
+    hierarchies.add(def, Hierarchy{Entity{}, std::move(def_children)});
+
+    for (std::uint32_t n = 0; n < module.nets.size(); ++n) {
+      if (find_root(module.nets, n) != n)
+        continue;
+      const auto &net = module.nets[n];
+      signals.add(net_signal[n],
+                  Signal{world_name(net.name), net.width, def,
+                         std::move(net_ports[n])});
+      if (net.constant) {
+        BitValue value(net.width);
+        for (std::uint32_t bit = 0; bit < net.width && bit < 64; ++bit)
+          value.set_bit(bit, (*net.constant >> bit) & 1u);
+        values.add(net_signal[n], std::move(value));
+      }
+    }
+  }
+
+  defs.flush(world);
+  insts.flush(world);
+  ports.flush(world);
+  signals.flush(world);
+  hierarchies.flush(world);
+  values.flush(world);
+  return module_defs;
+}
+
+} // namespace
+
+std::expected<std::vector<Entity>, VerilogError>
+import_verilog_source(World &world, std::string_view source) {
+  Parser parser(source);
+  if (!parser.parse())
+    return std::unexpected(parser.error());
+
+  std::vector<std::vector<std::uint32_t>> bindings;
+  if (auto error = resolve_instances(parser, bindings))
+    return std::unexpected(std::move(*error));
+
+  return build(world, parser, bindings);
+}
+
+std::expected<std::vector<Entity>, VerilogError>
+import_verilog(World &world, const std::filesystem::path &path) {
+  auto file = MappedFile::open(path);
+  if (!file)
+    return std::unexpected(
+        VerilogError{0, "could not open " + path.string()});
+  return import_verilog_source(world, file->text());
+}
+
+} // namespace netra::io
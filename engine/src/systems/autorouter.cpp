@@ -0,0 +1,448 @@
+#include <components/components.hpp>
+#include <components/render_components.hpp>
+#include <systems/autorouter.hpp>
+
+#include <core/astar.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+namespace netra {
+
+namespace {
+
+// Nets are batched on a grid of square bins; a batch claims every bin its
+// nets' padded bounding boxes touch.
+constexpr std::int32_t k_bin_cells = 32;
+// Padding around a net's pins that its routes are expected to stay in.
+constexpr std::int32_t k_net_padding = 8;
+
+// What a route takes up, per cell of the area. Wires may cross (the
+// renderer draws a hop), so a cell is not exclusive: two nets overlap when
+// they run along the same edge between two cells, or when one passes
+// through a cell where the other bends.
+enum Resource : std::uint32_t {
+  k_edge_right = 0, // the edge from a cell to its right neighbour
+  k_edge_up = 1,    // the edge from a cell to the one above
+  k_visit = 2,      // the net passes through the cell
+  k_bend = 3,       // the net turns in the cell
+};
+
+std::uint32_t resource(std::uint32_t cell, Resource kind) {
+  return cell * 4 + kind;
+}
+
+struct Net {
+  Entity signal;
+  std::vector<Entity> ports; // one per distinct pin
+  std::vector<GridCoord> pins;
+  std::vector<std::pair<std::size_t, std::size_t>> edges; // into pins
+  GridRect bounds;
+
+  // Current routes, one per edge, and the distinct resources they take
+  // (sorted), as counted in the usage array.
+  std::vector<std::vector<GridCoord>> paths;
+  std::vector<std::uint32_t> taken;
+  bool failed = false;
+
+  // Filled by the parallel part of a round, swapped in afterwards.
+  std::vector<std::vector<GridCoord>> next_paths;
+  std::vector<std::uint32_t> next_taken;
+  bool next_failed = false;
+};
+
+// The part of the grid routes may use: every pin, plus a margin. Cells
+// outside it count as blocked, so obstacles beyond it never matter.
+struct Area {
+  GridCoord origin;
+  std::int32_t width = 0;
+  std::int32_t height = 0;
+
+  bool contains(GridCoord p) const {
+    return p.x >= origin.x && p.y >= origin.y && p.x < origin.x + width &&
+           p.y < origin.y + height;
+  }
+  std::uint32_t index(GridCoord p) const {
+    return static_cast<std::uint32_t>(p.y - origin.y) *
+               static_cast<std::uint32_t>(width) +
+           static_cast<std::uint32_t>(p.x - origin.x);
+  }
+  std::size_t cells() const {
+    return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+  }
+  // The edge resource between two neighbouring cells.
+  std::uint32_t edge(GridCoord a, GridCoord b) const {
+    if (a.y == b.y) {
+      return resource(index(a.x < b.x ? a : b), k_edge_right);
+    }
+    return resource(index(a.y < b.y ? a : b), k_edge_up);
+  }
+};
+
+// Prim's algorithm over Manhattan distances; pins are few per net.
+std::vector<std::pair<std::size_t, std::size_t>>
+spanning_tree(const std::vector<GridCoord> &pins) {
+  std::vector<std::pair<std::size_t, std::size_t>> edges;
+  if (pins.size() < 2) {
+    return edges;
+  }
+  constexpr auto k_far = std::numeric_limits<std::int64_t>::max();
+  std::vector<bool> in_tree(pins.size(), false);
+  std::vector<std::int64_t> distance(pins.size(), k_far);
+  std::vector<std::size_t> nearest(pins.size(), 0);
+  std::size_t added = 0;
+  for (std::size_t step = 0; step < pins.size(); ++step) {
+    in_tree[added] = true;
+    if (step > 0) {
+      edges.emplace_back(nearest[added], added);
+    }
+    std::size_t next = 0;
+    std::int64_t best = k_far;
+    for (std::size_t i = 0; i < pins.size(); ++i) {
+      if (in_tree[i]) {
+        continue;
+      }
+      const std::int64_t d =
+          std::abs(std::int64_t{pins[i].x} - pins[added].x) +
+          std::abs(std::int64_t{pins[i].y} - pins[added].y);
+      if (d < distance[i]) {
+        distance[i] = d;
+        nearest[i] = added;
+      }
+      if (distance[i] < best) {
+        best = distance[i];
+        next = i;
+      }
+    }
+    added = next;
+  }
+  return edges;
+}
+
+std::int64_t bends_of(const std::vector<GridCoord> &path) {
+  std::int64_t bends = 0;
+  for (std::size_t i = 2; i < path.size(); ++i) {
+    const bool was_vertical = path[i - 1].x == path[i - 2].x;
+    const bool is_vertical = path[i].x == path[i - 1].x;
+    bends += was_vertical != is_vertical;
+  }
+  return bends;
+}
+
+// Appends the resources `path` takes. The ends are pins, which no other
+// net may enter anyway.
+void add_resources(const Area &area, const std::vector<GridCoord> &path,
+                   std::vector<std::uint32_t> &taken) {
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    const std::uint32_t cell = area.index(path[i]);
+    taken.push_back(resource(cell, k_visit));
+    if (i > 0) {
+      taken.push_back(area.edge(path[i - 1], path[i]));
+    }
+    if (i > 0 && i + 1 < path.size() &&
+        (path[i - 1].x == path[i].x) != (path[i].x == path[i + 1].x)) {
+      taken.push_back(resource(cell, k_bend));
+    }
+  }
+}
+
+// Groups nets (in order) into batches whose padded bounding boxes claim
+// disjoint bins. Deterministic: depends only on the nets and their order.
+std::vector<std::vector<std::size_t>>
+make_batches(const std::vector<Net> &nets, const std::vector<std::size_t> &todo,
+             const Area &area) {
+  const std::int32_t bins_x = area.width / k_bin_cells + 1;
+  const std::int32_t bins_y = area.height / k_bin_cells + 1;
+  std::vector<std::uint32_t> claimed(
+      static_cast<std::size_t>(bins_x) * static_cast<std::size_t>(bins_y), 0);
+
+  auto bin_range = [&](const Net &net) {
+    auto bin = [&](std::int32_t v, std::int32_t lo, std::int32_t bins) {
+      return std::clamp((v - lo) / k_bin_cells, 0, bins - 1);
+    };
+    return GridRect{
+        {bin(net.bounds.min.x - k_net_padding, area.origin.x, bins_x),
+         bin(net.bounds.min.y - k_net_padding, area.origin.y, bins_y)},
+        {bin(net.bounds.max.x + k_net_padding, area.origin.x, bins_x),
+         bin(net.bounds.max.y + k_net_padding, area.origin.y, bins_y)}};
+  };
+
+  std::vector<std::vector<std::size_t>> batches;
+  std::vector<std::size_t> remaining = todo;
+  std::vector<std::size_t> deferred;
+  for (std::uint32_t round = 1; !remaining.empty(); ++round) {
+    std::vector<std::size_t> &batch = batches.emplace_back();
+    deferred.clear();
+    for (std::size_t n : remaining) {
+      const GridRect bins = bin_range(nets[n]);
+      bool free = true;
+      for (std::int32_t y = bins.min.y; free && y <= bins.max.y; ++y) {
+        for (std::int32_t x = bins.min.x; free && x <= bins.max.x; ++x) {
+          free = claimed[static_cast<std::size_t>(y) * bins_x + x] != round;
+        }
+      }
+      if (!free) {
+        deferred.push_back(n);
+        continue;
+      }
+      for (std::int32_t y = bins.min.y; y <= bins.max.y; ++y) {
+        for (std::int32_t x = bins.min.x; x <= bins.max.x; ++x) {
+          claimed[static_cast<std::size_t>(y) * bins_x + x] = round;
+        }
+      }
+      batch.push_back(n);
+    }
+    remaining.swap(deferred);
+  }
+  return batches;
+}
+
+} // namespace
+
+AutorouteReport autoroute(World &world, LayoutSystem &layout, ThreadPool &pool,
+                          const AutorouteOptions &options) {
+  using clock = std::chrono::steady_clock;
+  const auto started = clock::now();
+  AutorouteReport report;
+
+  // 1. Nets: signals without wires whose ports are placed.
+  std::unordered_set<Entity> wired;
+  world.view<Wire>().each(
+      [&wired](Entity, const Wire &wire) { wired.insert(wire.signal); });
+
+  std::vector<Net> nets;
+  world.view<Signal>().each([&](Entity e, const Signal &signal) {
+    if (wired.contains(e)) {
+      return;
+    }
+    Net net;
+    net.signal = e;
+    for (Entity port : signal.connected_ports) {
+      auto const *pos = world.get<PortGridPosition>(port);
+      if (!pos || std::ranges::find(net.pins, pos->position) != net.pins.end()) {
+        continue;
+      }
+      net.ports.push_back(port);
+      net.pins.push_back(pos->position);
+    }
+    if (net.pins.size() < 2) {
+      return;
+    }
+    net.edges = spanning_tree(net.pins);
+    net.bounds = {net.pins.front(), net.pins.front()};
+    for (const GridCoord &p : net.pins) {
+      net.bounds.min = {std::min(net.bounds.min.x, p.x),
+                        std::min(net.bounds.min.y, p.y)};
+      net.bounds.max = {std::max(net.bounds.max.x, p.x),
+                        std::max(net.bounds.max.y, p.y)};
+    }
+    nets.push_back(std::move(net));
+  });
+  report.nets = nets.size();
+  if (nets.empty()) {
+    report.seconds =
+        std::chrono::duration<double>(clock::now() - started).count();
+    return report;
+  }
+
+  // 2. The routing area and its per-cell counts.
+  const std::shared_ptr<const OccupancyBitmap> obstacles =
+      layout.occupancy_snapshot();
+  GridRect extent = nets.front().bounds;
+  auto include = [&extent](GridCoord p) {
+    extent.min = {std::min(extent.min.x, p.x), std::min(extent.min.y, p.y)};
+    extent.max = {std::max(extent.max.x, p.x), std::max(extent.max.y, p.y)};
+  };
+  for (const Net &net : nets) {
+    include(net.bounds.min);
+    include(net.bounds.max);
+  }
+  const Area area{{extent.min.x - options.margin, extent.min.y - options.margin},
+                  extent.max.x - extent.min.x + 1 + 2 * options.margin,
+                  extent.max.y - extent.min.y + 1 + 2 * options.margin};
+
+  // Nets taking each resource, and rounds each was overused in.
+  std::vector<std::int32_t> usage(area.cells() * 4, 0);
+  std::vector<std::int32_t> history(area.cells() * 4, 0);
+  // A pin is off limits to every other net.
+  std::vector<std::int32_t> pin_owner(area.cells(), -1);
+  for (std::size_t n = 0; n < nets.size(); ++n) {
+    for (const GridCoord &p : nets[n].pins) {
+      pin_owner[area.index(p)] = static_cast<std::int32_t>(n);
+    }
+  }
+
+  // Overused: an edge taken by two nets, or a cell where one net bends and
+  // another passes.
+  auto overused = [&](std::uint32_t r) {
+    const std::uint32_t cell = r / 4;
+    switch (r % 4) {
+    case k_edge_right:
+    case k_edge_up:
+      return usage[r] > 1;
+    default:
+      return usage[resource(cell, k_bend)] > 0 &&
+             usage[resource(cell, k_visit)] > 1;
+    }
+  };
+
+  auto route_net = [&](std::size_t n, OrthogonalRouter &router,
+                       std::int32_t present_factor, PathSearchStats &stats) {
+    Net &net = nets[n];
+    // Routes try the net's padded bounding box first, then the whole area.
+    bool confined = true;
+    const GridRect reach{{net.bounds.min.x - k_net_padding,
+                    net.bounds.min.y - k_net_padding},
+                   {net.bounds.max.x + k_net_padding,
+                    net.bounds.max.y + k_net_padding}};
+    auto blocked = [&](GridCoord p) {
+      if ((confined && !reach.contains(p)) || !area.contains(p)) {
+        return true;
+      }
+      const std::int32_t owner = pin_owner[area.index(p)];
+      return (owner >= 0 && owner != static_cast<std::int32_t>(n)) ||
+             obstacles->test(p);
+    };
+    // Nets other than this one taking r (its own routes are still counted).
+    auto others = [&](std::uint32_t r) {
+      std::int32_t count = usage[r];
+      if (count > 0 && std::ranges::binary_search(net.taken, r)) {
+        --count;
+      }
+      return count;
+    };
+    auto price = [&](std::uint32_t r, std::uint32_t conflicting) {
+      return history[r] + present_factor * others(conflicting);
+    };
+    // Both cells passed `blocked`, so they are inside the area.
+    auto step_cost = [&](GridCoord from, GridCoord to, bool turn) {
+      const std::uint32_t edge = area.edge(from, to);
+      const std::uint32_t from_cell = area.index(from);
+      const std::uint32_t to_cell = area.index(to);
+      int cost = price(edge, edge) +
+                 price(resource(to_cell, k_visit), resource(to_cell, k_bend));
+      if (turn) {
+        cost += price(resource(from_cell, k_bend),
+                      resource(from_cell, k_visit));
+      }
+      return cost;
+    };
+
+    net.next_paths.clear();
+    net.next_taken.clear();
+    net.next_failed = false;
+    for (const auto &[a, b] : net.edges) {
+      confined = true;
+      auto path = router.find_weighted_path(net.pins[a], net.pins[b], blocked,
+                                            step_cost, &stats);
+      if (path.empty()) {
+        confined = false;
+        path = router.find_weighted_path(net.pins[a], net.pins[b], blocked,
+                                         step_cost, &stats);
+      }
+      if (path.empty()) {
+        net.next_failed = true;
+        net.next_paths.clear();
+        net.next_taken.clear();
+        return;
+      }
+      add_resources(area, path, net.next_taken);
+      net.next_paths.push_back(std::move(path));
+    }
+    std::ranges::sort(net.next_taken);
+    const auto [first, last] = std::ranges::unique(net.next_taken);
+    net.next_taken.erase(first, last);
+  };
+
+  // 3. Negotiation rounds.
+  std::vector<std::size_t> todo(nets.size());
+  for (std::size_t n = 0; n < nets.size(); ++n) {
+    todo[n] = n;
+  }
+  std::atomic<std::size_t> expanded{0};
+  // Nothing is penalised for sharing in the first round.
+  std::int32_t present_factor = 0;
+  for (int round = 0; round < options.max_iterations && !todo.empty();
+       ++round) {
+    report.iterations = round + 1;
+    for (const auto &batch : make_batches(nets, todo, area)) {
+      pool.parallel_for(batch.size(), options.chunk,
+                        [&](std::size_t begin, std::size_t end) {
+                          OrthogonalRouter router;
+                          PathSearchStats stats;
+                          for (std::size_t i = begin; i < end; ++i) {
+                            route_net(batch[i], router, present_factor, stats);
+                          }
+                          expanded.fetch_add(stats.expanded,
+                                             std::memory_order_relaxed);
+                        });
+      for (std::size_t n : batch) {
+        Net &net = nets[n];
+        for (std::uint32_t r : net.taken) {
+          --usage[r];
+        }
+        for (std::uint32_t r : net.next_taken) {
+          ++usage[r];
+        }
+        net.paths.swap(net.next_paths);
+        net.taken.swap(net.next_taken);
+        net.failed = net.next_failed;
+      }
+    }
+
+    // Overused resources get dearer for good; their nets go round again.
+    // Only resources some net takes can be overused.
+    report.overflow_cells = 0;
+    todo.clear();
+    std::vector<std::uint32_t> counted;
+    for (std::size_t n = 0; n < nets.size(); ++n) {
+      bool rip_up = false;
+      for (std::uint32_t r : nets[n].taken) {
+        if (!overused(r)) {
+          continue;
+        }
+        rip_up = true;
+        counted.push_back(r);
+      }
+      if (rip_up) {
+        todo.push_back(n);
+      }
+    }
+    std::ranges::sort(counted);
+    const auto [first, last] = std::ranges::unique(counted);
+    counted.erase(first, last);
+    // A bend conflict is counted once, on the cell's visit resource.
+    for (std::uint32_t r : counted) {
+      history[r] = std::min(history[r] + 1, k_max_step_cost);
+      report.overflow_cells += r % 4 != k_bend;
+    }
+    present_factor = std::clamp(present_factor * 2, 1, k_max_step_cost);
+  }
+  report.expanded = expanded.load();
+
+  // 4. Wires for the nets that overlap nothing.
+  for (Net &net : nets) {
+    if (net.failed || std::ranges::any_of(net.taken, overused)) {
+      continue;
+    }
+    ++report.routed_nets;
+    for (std::size_t i = 0; i < net.edges.size(); ++i) {
+      std::vector<GridCoord> &path = net.paths[i];
+      report.wirelength += static_cast<std::int64_t>(path.size()) - 1;
+      report.bends += bends_of(path);
+      const Entity wire = world.create();
+      world.emplace<Wire>(wire, net.signal, net.ports[net.edges[i].first],
+                          net.ports[net.edges[i].second], std::move(path));
+      layout.index_entity(wire);
+      ++report.wires;
+    }
+  }
+  report.seconds = std::chrono::duration<double>(clock::now() - started).count();
+  return report;
+}
+
+} // namespace netra
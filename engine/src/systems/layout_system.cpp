@@ -3,6 +3,11 @@
 #include <systems/layout_system.hpp>
 
 #include <core/astar.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <optional>
 #include <unordered_set>
 
 namespace netra {
@@ -44,31 +49,27 @@ void LayoutSystem::update_module_from_anchor(Entity anchor_port,
   // Update all ports for this module
   update_ports(moduleEntity, module_grid_origin);
 
-  // Refresh spatial index as module moved
-  // Optimization: could just update this module, but rebuild is safer for now
-  rebuild_spatial_index();
+  // Move the module and its ports in the index; nothing else changed.
+  index_entity(moduleEntity);
 }
 
 void LayoutSystem::update_ports(Entity moduleEntity,
                                 GridCoord module_grid_origin) {
-  // Iterate all ports and update those belonging to this module
-  m_world.view<Port, PortOffset>().each(
-      [this, &moduleEntity, &module_grid_origin](
-          Entity port_entity, const Port &port, const PortOffset &offset) {
-        if (!(port.owner == moduleEntity)) {
-          return;
-        }
+  for (Entity port_entity : m_world.related<&Port::owner>(moduleEntity)) {
+    auto const *offset = m_world.get<PortOffset>(port_entity);
+    if (!offset) {
+      continue;
+    }
 
-        GridCoord port_grid_pos{module_grid_origin.x + offset.x,
-                                module_grid_origin.y + offset.y};
+    GridCoord port_grid_pos{module_grid_origin.x + offset->x,
+                            module_grid_origin.y + offset->y};
 
-        if (m_world.has<PortGridPosition>(port_entity)) {
-          auto *pos = m_world.get<PortGridPosition>(port_entity);
-          pos->position = port_grid_pos;
-        } else {
-          m_world.emplace<PortGridPosition>(port_entity, port_grid_pos);
-        }
-      });
+    if (auto *pos = m_world.get<PortGridPosition>(port_entity)) {
+      pos->position = port_grid_pos;
+    } else {
+      m_world.emplace<PortGridPosition>(port_entity, port_grid_pos);
+    }
+  }
 }
 
 void LayoutSystem::update_all() {
@@ -78,14 +79,7 @@ void LayoutSystem::update_all() {
              const ModulePixelPosition &pixel_pos, const ModuleExtent &) {
         // Reverse: pixel position to grid origin
         // grid_origin = pixel_pos / unit_px
-        auto unit_px = m_grid.unit_px();
-        GridCoord module_grid_origin{
-            static_cast<std::int32_t>(pixel_pos.x /
-                                      static_cast<float>(unit_px)),
-            static_cast<std::int32_t>(pixel_pos.y /
-                                      static_cast<float>(unit_px))};
-
-        update_ports(moduleEntity, module_grid_origin);
+        update_ports(moduleEntity, grid_origin(pixel_pos));
       });
 
   rebuild_spatial_index();
@@ -93,109 +87,372 @@ void LayoutSystem::update_all() {
 
 bool LayoutSystem::is_cell_blocked(GridCoord pos, bool checks_module,
                                    bool checks_wire) const {
-  auto it = m_spatial_map.find(pos);
-  if (it == m_spatial_map.end()) {
+  const IndexCell *cell = m_spatial_map.find(pos);
+  if (!cell) {
     return false;
   }
+  return (checks_module && cell->module_blocked()) ||
+         (checks_wire && cell->wire_blocked());
+}
 
-  Entity occupier = it->second;
-  if (!occupier.valid())
-    return false;
+std::vector<Entity> LayoutSystem::wires_at(GridCoord pos) const {
+  std::vector<Entity> wires;
+  for_each_occupant(pos, [&wires](const Occupant &o) {
+    if (o.layer == Layer::Wire &&
+        std::ranges::find(wires, o.entity) == wires.end()) {
+      wires.push_back(o.entity);
+    }
+  });
+  return wires;
+}
 
-  if (checks_module && m_world.has<ModuleInst>(occupier)) {
-    return true;
-  }
+Entity LayoutSystem::module_at(GridCoord pos) const {
+  Entity found;
+  for_each_occupant(pos, [&found](const Occupant &o) {
+    if (o.layer == Layer::Module && !found.valid()) {
+      found = o.entity;
+    }
+  });
+  return found;
+}
 
-  if (checks_wire && m_world.has<Wire>(occupier)) {
-    return true;
-  }
+Entity LayoutSystem::port_at(GridCoord pos) const {
+  Entity found;
+  for_each_occupant(pos, [&found](const Occupant &o) {
+    if (o.layer == Layer::Port && !found.valid()) {
+      found = o.entity;
+    }
+  });
+  return found;
+}
 
-  return false;
+std::vector<Entity> LayoutSystem::entities_in(const GridRect &rect,
+                                              Layer layer) const {
+  std::unordered_set<Entity> seen;
+  std::vector<Entity> found;
+  m_spatial_map.for_each_in(rect, [&](GridCoord, const IndexCell &cell) {
+    if (cell[layer] == 0) {
+      return;
+    }
+    for (std::uint32_t n = cell.first; n != k_no_occupant;
+         n = m_occupant_nodes[n].next) {
+      const Occupant &o = m_occupant_nodes[n].occupant;
+      if (o.layer == layer && seen.insert(o.entity).second) {
+        found.push_back(o.entity);
+      }
+    }
+  });
+  return found;
+}
+
+std::vector<GridCoord> LayoutSystem::route_wire(GridCoord start, GridCoord end,
+                                                PathSearchStats *stats,
+                                                RouteSearch search) const {
+  // The bitmap answers is_cell_blocked(pos, true, true) with one bit
+  // probe. The end is exempt inside the search (ports sit on module edges).
+  return m_router.find_path(start, end, *m_occupancy, stats, search);
 }
 
-std::vector<GridCoord> LayoutSystem::route_wire(GridCoord start,
-                                                GridCoord end) const {
-  // Ensure spatial index is up to date (usually it is, unless we just added
-  // something without update) For now we assume update_event or similar keeps
-  // it fresh, or we rely on update_all() called in loop.
+std::vector<GridCoord> LayoutSystem::preview_route(GridCoord start,
+                                                   GridCoord end,
+                                                   PathSearchStats *stats) const {
+  if (!m_preview_field.has_start() || !(m_preview_field.start() == start) ||
+      m_preview_version != m_index_version) {
+    m_preview_field.reset(start);
+    m_preview_version = m_index_version;
+  }
+  auto path = m_preview_field.path_to(end, *m_occupancy, stats);
+  if (path.empty() && m_preview_field.exhausted()) {
+    // The tree covers a diamond around the start; a long straight route
+    // can be cheap for route_wire's window yet lie beyond it.
+    return route_wire(start, end, stats);
+  }
+  return path;
+}
+
+std::vector<GridCoord>
+LayoutSystem::route_wire_hierarchical(GridCoord start, GridCoord end,
+                                      PathSearchStats *stats,
+                                      RouteSearch search) const {
+  // Corridor tiles between waypoints: short enough that a leg's window
+  // stays small, long enough that the joins rarely cost a detour.
+  constexpr std::size_t k_leg_tiles = 8;
+
+  const std::vector<GridCoord> tiles = m_tiles.find_corridor(start, end);
+  if (tiles.empty()) {
+    return route_wire(start, end, stats, search);
+  }
 
-  // Define obstacle callback
-  auto obstacle_cb = [this](GridCoord pos) {
-    // Block if cell is occupied by generic obstacle
-    // But allow end position (it might be a port, which is technically
-    // "occupied" by module, but AStar excludes end check by default? No, AStar
-    // implementation calls is_blocked(neighbor). Our AStar implementation
-    // checks is_blocked for neighbors unless it is the target. So we just
-    // return true if it's a module/wire.
-    return is_cell_blocked(pos, true, true);
+  // The corridor plus one tile around it, so a route can slip past an
+  // obstacle that straddles a tile edge.
+  std::unordered_set<GridCoord> allowed;
+  for (const GridCoord &t : tiles) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        allowed.insert({t.x + dx, t.y + dy});
+      }
+    }
+  }
+  auto blocked = [&](GridCoord p) {
+    return m_occupancy->test(p) || !allowed.contains(m_tiles.tile_of(p));
   };
 
-  return find_orthogonal_path(start, end, obstacle_cb);
+  // Waypoints: the free cell nearest the centre of every k_leg_tiles-th
+  // corridor tile.
+  std::vector<GridCoord> stops{start};
+  for (std::size_t i = k_leg_tiles; i + 1 < tiles.size(); i += k_leg_tiles) {
+    const GridRect cells = m_tiles.cells_of(tiles[i]);
+    const GridCoord centre{(cells.min.x + cells.max.x) / 2,
+                           (cells.min.y + cells.max.y) / 2};
+    std::optional<GridCoord> best;
+    int best_distance = std::numeric_limits<int>::max();
+    for (std::int32_t y = cells.min.y; y <= cells.max.y; ++y) {
+      for (std::int32_t x = cells.min.x; x <= cells.max.x; ++x) {
+        const int distance = std::abs(x - centre.x) + std::abs(y - centre.y);
+        if (distance < best_distance && !m_occupancy->test({x, y})) {
+          best = GridCoord{x, y};
+          best_distance = distance;
+        }
+      }
+    }
+    if (best) {
+      stops.push_back(*best);
+    }
+  }
+  stops.push_back(end);
+
+  std::vector<GridCoord> path;
+  for (std::size_t i = 1; i < stops.size(); ++i) {
+    auto leg = m_router.find_path(stops[i - 1], stops[i], blocked, stats,
+                                  search);
+    if (leg.empty()) {
+      return route_wire(start, end, stats, search);
+    }
+    path.insert(path.end(), leg.begin() + (path.empty() ? 0 : 1), leg.end());
+  }
+
+  // Legs may double back over each other at a waypoint; cut such loops so
+  // the wire never visits a cell twice.
+  std::unordered_map<GridCoord, std::size_t> seen;
+  std::vector<GridCoord> route;
+  for (const GridCoord &p : path) {
+    if (auto it = seen.find(p); it != seen.end()) {
+      for (std::size_t j = it->second + 1; j < route.size(); ++j) {
+        seen.erase(route[j]);
+      }
+      route.resize(it->second + 1);
+      continue;
+    }
+    seen.emplace(p, route.size());
+    route.push_back(p);
+  }
+  return route;
+}
+
+GridCoord LayoutSystem::grid_origin(const ModulePixelPosition &pixel_pos) const {
+  // grid_origin = pixel_pos / unit_px
+  auto unit_px = static_cast<float>(m_grid.unit_px());
+  return {static_cast<std::int32_t>(pixel_pos.x / unit_px),
+          static_cast<std::int32_t>(pixel_pos.y / unit_px)};
+}
+
+GridRect LayoutSystem::padded_footprint(GridCoord origin,
+                                        const ModuleExtent &ext) {
+  return {{origin.x - 1, origin.y - 1},
+          {origin.x + ext.width, origin.y + ext.height}};
 }
 
 void LayoutSystem::rebuild_spatial_index() {
+  // Here rather than in the constructor so that a rebuild after the
+  // World's contents were replaced registers it again.
+  m_world.index_relation<&Port::owner>();
+  ++m_index_version;
   m_spatial_map.clear();
-  auto &world = const_cast<World &>(
-      m_world); // View iteration needs mutable? No, usually not, but maybe.
-
-  // 1. Add Modules (with padding) and their Ports (as explict connectable
-  // spots? No, actually ports are on the module) Wait, if I pad the module, I
-  // block the ports! Ports are usually at the edge. If I block module + 1 unit
-  // buffer, I block ports. Solution: Block module interior + border, BUT do NOT
-  // block the specific coordinates where ports are located.
-
-  // First, collect all port locations so we don't block them with padding
-  std::unordered_set<GridCoord, GridCoordHash> port_locations;
-  world.view<Port, PortGridPosition>().each(
-      [&port_locations](Entity, Port &, const PortGridPosition &pos) {
-        port_locations.insert(pos.position);
+  m_occupant_nodes.clear();
+  m_free_node = k_no_occupant;
+  m_indexed.clear();
+  m_tiles.clear();
+
+  m_world.view<ModuleInst>().each(
+      [this](Entity e, const ModuleInst &) { add_to_index(e, false); });
+  m_world.view<Port, PortGridPosition>().each(
+      [this](Entity e, const Port &, const PortGridPosition &) {
+        add_to_index(e, false);
       });
+  m_world.view<Wire>().each(
+      [this](Entity e, const Wire &) { add_to_index(e, false); });
+
+  // A new bitmap every time: snapshots handed out earlier stay as they
+  // were.
+  auto bitmap = std::make_shared<OccupancyBitmap>();
+  m_spatial_map.for_each([&bitmap](GridCoord pos, const IndexCell &cell) {
+    if (cell.module_blocked() || cell.wire_blocked()) {
+      bitmap->set(pos);
+    }
+  });
+  m_occupancy = std::move(bitmap);
+}
 
-  world.view<ModuleInst, ModulePixelPosition, ModuleExtent>().each(
-      [this, &port_locations](Entity e, const ModuleInst &,
-                              const ModulePixelPosition &pixel_pos,
-                              const ModuleExtent &ext) {
-        auto unit_px = m_grid.unit_px();
-        GridCoord origin{static_cast<std::int32_t>(pixel_pos.x /
-                                                   static_cast<float>(unit_px)),
-                         static_cast<std::int32_t>(
-                             pixel_pos.y / static_cast<float>(unit_px))};
-
-        // Module Area
-        for (int y = 0; y < ext.height; ++y) {
-          for (int x = 0; x < ext.width; ++x) {
-            m_spatial_map[{origin.x + x, origin.y + y}] = e;
-          }
-        }
+void LayoutSystem::index_entity(Entity e) {
+  ++m_index_version;
+  remove_from_index(e, true);
+  add_to_index(e, true);
+  if (m_world.has<ModuleInst>(e)) {
+    for (Entity port : m_world.related<&Port::owner>(e)) {
+      remove_from_index(port, true);
+      add_to_index(port, true);
+    }
+  }
+}
 
-        // Padding Area (1 unit around) - Optional based on user request
-        // "shouldn't go alongside the border" This implies a buffer. But we
-        // must NOT block ports.
-        for (int y = -1; y <= ext.height; ++y) {
-          for (int x = -1; x <= ext.width; ++x) {
-            // Skip if inside module (already handled)
-            if (x >= 0 && x < ext.width && y >= 0 && y < ext.height)
-              continue;
+void LayoutSystem::unindex_entity(Entity e) {
+  ++m_index_version;
+  remove_from_index(e, true);
+  if (m_world.has<ModuleInst>(e)) {
+    for (Entity port : m_world.related<&Port::owner>(e)) {
+      remove_from_index(port, true);
+    }
+  }
+}
 
-            GridCoord pad_pos{origin.x + x, origin.y + y};
+void LayoutSystem::add_to_index(Entity e, bool bitmap) {
+  IndexedEntity entry;
+  if (m_world.has<ModuleInst>(e)) {
+    auto const *pixel_pos = m_world.get<ModulePixelPosition>(e);
+    auto const *ext = m_world.get<ModuleExtent>(e);
+    if (!pixel_pos || !ext) {
+      return;
+    }
+    entry.footprint = padded_footprint(grid_origin(*pixel_pos), *ext);
+    stamp_module(e, *entry.footprint, true, bitmap);
+    m_tiles.add_blocked(*entry.footprint);
+  } else if (auto const *wire = m_world.get<Wire>(e)) {
+    const std::vector<GridCoord> &points = wire->points;
+    // Which of its neighbours in the wire a point is joined to.
+    auto link = [](GridCoord from, GridCoord to) -> std::uint8_t {
+      if (std::abs(to.x - from.x) + std::abs(to.y - from.y) != 1) {
+        return 0;
+      }
+      return to.y > from.y   ? k_link_up
+             : to.y < from.y ? k_link_down
+             : to.x < from.x ? k_link_left
+                             : k_link_right;
+    };
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      Occupant occupant{e, Layer::Wire, 0};
+      if (i > 0) {
+        occupant.links |= link(points[i], points[i - 1]);
+      }
+      if (i + 1 < points.size()) {
+        occupant.links |= link(points[i], points[i + 1]);
+      }
+      entry.cells.emplace_back(points[i], occupant);
+      m_tiles.add_wire_cell(points[i]);
+    }
+  } else if (auto const *pos = m_world.get<PortGridPosition>(e);
+             pos && m_world.has<Port>(e)) {
+    entry.cells.emplace_back(pos->position, Occupant{e, Layer::Port, 0});
+  } else {
+    return;
+  }
 
-            // If this is a port location, DO NOT block it
-            if (port_locations.contains(pad_pos))
-              continue;
+  for (const auto &[pos, occupant] : entry.cells) {
+    update_cells({pos, pos}, occupant, true, bitmap);
+  }
+  m_indexed.insert_or_assign(e, std::move(entry));
+}
 
-            // Mark as blocked by this module
-            m_spatial_map[pad_pos] = e;
-          }
-        }
-      });
+void LayoutSystem::remove_from_index(Entity e, bool bitmap) {
+  auto it = m_indexed.find(e);
+  if (it == m_indexed.end()) {
+    return;
+  }
+  for (const auto &[pos, occupant] : it->second.cells) {
+    update_cells({pos, pos}, occupant, false, bitmap);
+    if (occupant.layer == Layer::Wire) {
+      m_tiles.add_wire_cell(pos, -1);
+    }
+  }
+  if (it->second.footprint) {
+    stamp_module(e, *it->second.footprint, false, bitmap);
+    m_tiles.add_blocked(*it->second.footprint, -1);
+  }
+  m_indexed.erase(it);
+}
+
+void LayoutSystem::stamp_module(Entity module, const GridRect &footprint,
+                                bool add, bool bitmap) {
+  // The module's cells, and a one-cell ring around them so routes keep
+  // off its border.
+  const GridRect f = footprint;
+  const Occupant body{module, Layer::Module, 0};
+  const Occupant padding{module, Layer::Padding, 0};
+  update_cells({{f.min.x + 1, f.min.y + 1}, {f.max.x - 1, f.max.y - 1}}, body,
+               add, bitmap);
+  update_cells({f.min, {f.max.x, f.min.y}}, padding, add, bitmap);
+  update_cells({{f.min.x, f.max.y}, f.max}, padding, add, bitmap);
+  update_cells({{f.min.x, f.min.y + 1}, {f.min.x, f.max.y - 1}}, padding, add,
+               bitmap);
+  update_cells({{f.max.x, f.min.y + 1}, {f.max.x, f.max.y - 1}}, padding, add,
+               bitmap);
+}
 
-  // 2. Add Existing Wires
-  world.view<Wire>().each([this](Entity e, const Wire &wire) {
-    for (const auto &pt : wire.points) {
-      m_spatial_map[pt] = e;
+void LayoutSystem::update_cells(const GridRect &rect, const Occupant &occupant,
+                                bool add, bool bitmap) {
+  m_spatial_map.update_rect(rect, [&](GridCoord pos, IndexCell &cell) {
+    const bool was_blocked = cell.module_blocked() || cell.wire_blocked();
+    if (add) {
+      std::uint32_t n = m_free_node;
+      if (n != k_no_occupant) {
+        m_free_node = m_occupant_nodes[n].next;
+      } else {
+        n = static_cast<std::uint32_t>(m_occupant_nodes.size());
+        m_occupant_nodes.emplace_back();
+      }
+      m_occupant_nodes[n] = {occupant, cell.first};
+      cell.first = n;
+      ++cell[occupant.layer];
+    } else {
+      // Unlink the first node of this entity on this layer.
+      for (std::uint32_t *link = &cell.first; *link != k_no_occupant;
+           link = &m_occupant_nodes[*link].next) {
+        OccupantNode &node = m_occupant_nodes[*link];
+        if (node.occupant.entity == occupant.entity &&
+            node.occupant.layer == occupant.layer) {
+          const std::uint32_t n = *link;
+          *link = node.next;
+          m_occupant_nodes[n].next = m_free_node;
+          m_free_node = n;
+          --cell[occupant.layer];
+          break;
+        }
+      }
+    }
+    const bool blocked = cell.module_blocked() || cell.wire_blocked();
+    if (!bitmap || blocked == was_blocked) {
+      return;
+    }
+    if (blocked) {
+      writable_occupancy().set(pos);
+    } else {
+      writable_occupancy().reset(pos);
     }
   });
 }
 
+OccupancyBitmap &LayoutSystem::writable_occupancy() {
+  // Snapshots are only handed out on this thread, so a use count of one
+  // means nobody else can be reading the bitmap. A copy shares its tiles
+  // with the snapshot until they are edited.
+  if (m_occupancy.use_count() > 1) {
+    m_occupancy = std::make_shared<OccupancyBitmap>(*m_occupancy);
+  } else {
+    // use_count() is a relaxed load. A worker that dropped its snapshot
+    // released the count after its last read of the bitmap; this fence
+    // pairs with that release, so those reads happen before our writes.
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *m_occupancy;
+}
 
 } // namespace netra
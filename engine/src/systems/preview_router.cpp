@@ -0,0 +1,100 @@
+#include <systems/preview_router.hpp>
+
+#include <utility>
+
+namespace netra {
+
+PreviewRouter::PreviewRouter()
+    : m_worker([this](std::stop_token stop) { worker_loop(stop); }) {}
+
+PreviewRouter::~PreviewRouter() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_cancel.request_stop();
+  }
+  // m_worker's destructor requests stop on the loop and joins.
+}
+
+void PreviewRouter::request(GridCoord start, GridCoord end,
+                            std::shared_ptr<const OccupancyBitmap> obstacles,
+                            std::uint64_t version) {
+  auto same = [&](const std::optional<Request> &r) {
+    return r && r->start == start && r->end == end && r->version == version;
+  };
+  std::lock_guard lock(m_mutex);
+  if (same(m_pending) || (!m_pending && same(m_running))) {
+    return;
+  }
+  m_pending = Request{start, end, std::move(obstacles), version};
+  m_cancel.request_stop();
+  m_wake.notify_one();
+}
+
+std::optional<PreviewRouter::Result> PreviewRouter::latest() const {
+  std::lock_guard lock(m_mutex);
+  return m_latest;
+}
+
+PathSearchStats PreviewRouter::stats() const {
+  std::lock_guard lock(m_mutex);
+  return m_stats;
+}
+
+void PreviewRouter::wait_idle() {
+  std::unique_lock lock(m_mutex);
+  m_idle.wait(lock, [this] { return !m_pending && !m_running; });
+}
+
+void PreviewRouter::worker_loop(std::stop_token stop) {
+  for (;;) {
+    std::stop_token cancel;
+    Request request;
+    {
+      std::unique_lock lock(m_mutex);
+      if (!m_wake.wait(lock, stop, [this] { return m_pending.has_value(); })) {
+        return; // stop requested
+      }
+      request = std::move(*m_pending);
+      m_pending.reset();
+      m_running = request;
+      m_cancel = std::stop_source();
+      cancel = m_cancel.get_token();
+    }
+
+    PathSearchStats stats;
+    std::vector<GridCoord> path = route(request, cancel, stats);
+
+    {
+      std::lock_guard lock(m_mutex);
+      m_stats.expanded += stats.expanded;
+      if (!cancel.stop_requested()) {
+        m_latest = Result{request.start, request.end, request.version,
+                          std::move(path)};
+      }
+      m_running.reset();
+    }
+    m_idle.notify_all();
+  }
+}
+
+std::vector<GridCoord> PreviewRouter::route(const Request &request,
+                                            std::stop_token cancel,
+                                            PathSearchStats &stats) {
+  const OccupancyBitmap &obstacles = *request.obstacles;
+  if (!m_field.has_start() || !(m_field.start() == request.start) ||
+      m_field_version != request.version) {
+    m_field.reset(request.start);
+    m_field_version = request.version;
+  }
+  auto path = m_field.path_to(request.end, obstacles, &stats, cancel);
+  if (path.empty() && m_field.exhausted() && !cancel.stop_requested()) {
+    // Once cancelled, every cell reads as blocked and the search drains.
+    auto blocked = [&](GridCoord p) {
+      return cancel.stop_requested() || obstacles.test(p);
+    };
+    path = m_router.find_path(request.start, request.end, blocked, &stats);
+  }
+  return path;
+}
+
+} // namespace netra
@@ -13,8 +13,8 @@
 namespace netra {
 
 RenderSystem::RenderSystem(World &world, graphics::Grid &grid,
-                           EditorState &editor)
-    : m_world(world), m_grid(grid), m_editor(editor) {}
+                           EditorState &editor, const LayoutSystem &layout)
+    : m_world(world), m_grid(grid), m_editor(editor), m_layout(layout) {}
 
 RenderSystem::~RenderSystem() {
   if (m_gate_vao)
@@ -131,7 +131,23 @@ void RenderSystem::load_gate_shaders(const std::string &shader_dir) {
 
   for (const auto &[key, frag_file] : gate_shaders) {
     std::string frag_src = load_file(shader_dir + frag_file);
-    m_shaders[key] = graphics::Shader(vert_src, frag_src);
+    const Symbol symbol = m_world.intern(key);
+    m_shaders[symbol] = graphics::Shader(vert_src, frag_src);
+    m_shader_names.emplace_back(key, symbol);
+  }
+}
+
+void RenderSystem::rebind_shader_keys() {
+  // Take every shader out before re-keying: a new symbol may equal another
+  // shader's old one.
+  std::vector<decltype(m_shaders)::node_type> nodes;
+  for (auto &[name, symbol] : m_shader_names) {
+    nodes.push_back(m_shaders.extract(symbol));
+    symbol = m_world.intern(name);
+    nodes.back().key() = symbol;
+  }
+  for (auto &node : nodes) {
+    m_shaders.insert(std::move(node));
   }
 }
 
@@ -143,6 +159,7 @@ void RenderSystem::render(glm::vec2 viewport_size, Entity dragging_module) {
 void RenderSystem::render_region(glm::vec2 viewport_size, int x, int y,
                                  int width, int height,
                                  Entity dragging_module) {
+  m_stats = {};
   if (width <= 0 || height <= 0)
     return;
 
@@ -168,6 +185,7 @@ void RenderSystem::render_region(glm::vec2 viewport_size, int x, int y,
 void RenderSystem::render_modules([[maybe_unused]] const glm::mat4 &view_proj,
                                   glm::vec2 viewport_size) {
   glBindVertexArray(m_gate_vao);
+  ++m_stats.vao_binds;
 
   m_world.view<ModuleInst, ModulePixelPosition, ModuleExtent, ShaderKey>().each(
       [this, &viewport_size](
@@ -179,6 +197,7 @@ void RenderSystem::render_modules([[maybe_unused]] const glm::mat4 &view_proj,
 
         const auto &shader = it->second;
         shader.use();
+        ++m_stats.program_binds;
 
         // Convert extent from grid units to pixels
         auto width_px = static_cast<float>(extent.width * m_grid.unit_px());
@@ -193,11 +212,15 @@ void RenderSystem::render_modules([[maybe_unused]] const glm::mat4 &view_proj,
 
         shader.set_vec2("u_position", ndc_pos);
         shader.set_vec2("u_size", ndc_size);
+        m_stats.uniform_sets += 2;
 
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        ++m_stats.draw_calls;
+        m_stats.vertices += 6;
       });
 
   glBindVertexArray(0);
+  ++m_stats.vao_binds;
 }
 
 void RenderSystem::render_ports(const glm::mat4 &view_proj,
@@ -207,6 +230,9 @@ void RenderSystem::render_ports(const glm::mat4 &view_proj,
   m_port_shader.use();
   m_port_shader.set_mat4("u_view_proj", view_proj);
   m_port_shader.set_vec4("u_color", {0.0f, 0.0f, 0.0f, 1.0f});
+  ++m_stats.vao_binds;
+  ++m_stats.program_binds;
+  m_stats.uniform_sets += 2;
 
   auto port_size = static_cast<float>(m_grid.unit_px()) * 0.6f;
 
@@ -223,11 +249,15 @@ void RenderSystem::render_ports(const glm::mat4 &view_proj,
         m_port_shader.set_vec2("u_position", {pixel_pos.x - port_size * 0.5f,
                                               pixel_pos.y - port_size * 0.5f});
         m_port_shader.set_vec2("u_size", {port_size, port_size});
+        m_stats.uniform_sets += 2;
 
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        ++m_stats.draw_calls;
+        m_stats.vertices += 6;
       });
 
   glBindVertexArray(0);
+  ++m_stats.vao_binds;
 }
 void RenderSystem::setup_wire_mesh() {
   glGenVertexArrays(1, &m_line_vao); // Reusing m_line names for wire mesh
@@ -255,19 +285,16 @@ void RenderSystem::render_wires(const glm::mat4 &view_proj,
   // Identity transform, vertices are in world space
   m_wire_shader.set_vec2("u_position", {0.0f, 0.0f});
   m_wire_shader.set_vec2("u_size", {1.0f, 1.0f});
+  ++m_stats.program_binds;
+  m_stats.uniform_sets += 4;
 
   glBindVertexArray(m_line_vao);
+  ++m_stats.vao_binds;
 
-  // Simple buckets: y -> list of HSegments at that y
-  // x -> list of VSegments at that x
-  // Given the grid nature, this is Map<int, vector>.
+  // Committed wires are looked up in the layout index per crossing cell;
+  // only the preview, which is not indexed, is bucketed here:
+  // y -> list of HSegments at that y.
   WireSegments segments;
-  // 1. Collect all segments (Committed + Preview)
-
-  // Committed
-  m_world.view<Wire>().each([this, &segments](Entity e, Wire &wire) {
-    collect_committed_segments(segments, e, wire);
-  });
 
   // Preview only if start_point is valid
   if (m_editor.wiring.active && m_editor.wiring.start_endpoint.valid()) {
@@ -330,7 +357,33 @@ void RenderSystem::render_wires(const glm::mat4 &view_proj,
     }
   };
 
-  auto process_points = [&](const std::vector<GridCoord> &pts, Entity owner) {
+  // A committed wire other than `owner` passing straight through `cell`
+  // horizontally.
+  auto crossed_by_wire = [&](GridCoord cell, Entity owner) {
+    constexpr std::uint8_t across =
+        LayoutSystem::k_link_left | LayoutSystem::k_link_right;
+    bool crossed = false;
+    m_layout.for_each_occupant(cell, [&](const LayoutSystem::Occupant &o) {
+      if (o.layer == LayoutSystem::Layer::Wire && !(o.entity == owner) &&
+          (o.links & across) == across) {
+        crossed = true;
+      }
+    });
+    return crossed;
+  };
+
+  auto process_points = [&](const std::vector<GridCoord> &cells, Entity owner) {
+    // Wires store every cell; keep only the corners so a straight run is one
+    // segment and a crossing falls strictly inside it.
+    std::vector<GridCoord> pts;
+    for (size_t i = 0; i < cells.size(); ++i) {
+      if (i > 0 && i + 1 < cells.size() &&
+          ((cells[i - 1].x == cells[i].x && cells[i].x == cells[i + 1].x) ||
+           (cells[i - 1].y == cells[i].y && cells[i].y == cells[i + 1].y))) {
+        continue;
+      }
+      pts.push_back(cells[i]);
+    }
     if (pts.size() < 2)
       return;
     for (size_t i = 0; i < pts.size() - 1; ++i) {
@@ -349,6 +402,10 @@ void RenderSystem::render_wires(const glm::mat4 &view_proj,
         // Collect crossings
         std::vector<int> crossings;
         for (int y = y_min + 1; y < y_max; ++y) {
+          if (crossed_by_wire({x, y}, owner)) {
+            crossings.push_back(y);
+            continue;
+          }
           if (segments.h_segments.contains(y)) {
             for (const auto &seg : segments.h_segments[y]) {
               // Check overlap
@@ -431,12 +488,17 @@ void RenderSystem::render_wires(const glm::mat4 &view_proj,
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
                  vertices.data(), GL_DYNAMIC_DRAW);
     glDrawArrays(GL_TRIANGLES, 0, static_cast<int>(vertices.size()) / 2);
+    ++m_stats.buffer_uploads;
+    m_stats.uploaded_bytes += vertices.size() * sizeof(float);
+    ++m_stats.draw_calls;
+    m_stats.vertices += vertices.size() / 2;
   }
 
   if (m_editor.wiring.active) {
     vertices.clear();
     m_wire_shader.set_vec4("u_color",
                            {0.5f, 0.8f, 1.0f, 0.8f}); // Preview color
+    ++m_stats.uniform_sets;
 
     std::vector<GridCoord> preview_pts;
     if (m_editor.wiring.start_endpoint.valid()) {
@@ -456,21 +518,15 @@ void RenderSystem::render_wires(const glm::mat4 &view_proj,
       glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
                    vertices.data(), GL_DYNAMIC_DRAW);
       glDrawArrays(GL_TRIANGLES, 0, static_cast<int>(vertices.size() / 2));
+      ++m_stats.buffer_uploads;
+      m_stats.uploaded_bytes += vertices.size() * sizeof(float);
+      ++m_stats.draw_calls;
+      m_stats.vertices += vertices.size() / 2;
     }
   }
 
   glBindVertexArray(0);
-}
-
-void RenderSystem::collect_committed_segments(WireSegments &segments, Entity e,
-                                              const Wire &wire) {
-  std::vector<GridCoord> full_points;
-  if (auto const *pos = m_world.get<PortGridPosition>(wire.from_endpoint))
-      full_points.push_back(pos->position);
-  full_points.insert(full_points.end(), wire.points.begin(), wire.points.end());
-  if (auto const *pos = m_world.get<PortGridPosition>(wire.to_endpoint))
-      full_points.push_back(pos->position);
-  segments.add_segments(full_points, e);
+  ++m_stats.vao_binds;
 }
 
 void RenderSystem::add_orthogonal_wire_vertices(glm::vec2 p1, glm::vec2 p2) {
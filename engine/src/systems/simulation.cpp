@@ -1,12 +1,50 @@
 #include "systems/simulation.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace netra {
 
-Simulation::Simulation(World &world) : m_world(world) {}
+namespace {
+
+// Def names of the built-in gates, indexed by GateType.
+constexpr std::array<std::string_view, static_cast<std::size_t>(GateType::INVALID)>
+    k_gate_names{"AND", "NAND", "OR", "NOR", "XOR", "XNOR", "NOT", "BUF"};
+
+} // namespace
+
+GateType gate_type_of(std::string_view name) {
+  const auto it = std::find(k_gate_names.begin(), k_gate_names.end(), name);
+  if (it == k_gate_names.end())
+    return GateType::INVALID;
+  return static_cast<GateType>(it - k_gate_names.begin());
+}
+
+std::string_view gate_name(GateType type) {
+  if (type >= GateType::INVALID) {
+    throw std::invalid_argument("gate_name: not a gate");
+  }
+  return k_gate_names[static_cast<std::size_t>(type)];
+}
+
+Simulation::Simulation(World &world) : m_world(world) {
+  m_world.index_relation<&Port::owner>();
+}
+
+void Simulation::register_gate(GateType type) {
+  if (type >= GateType::INVALID) {
+    throw std::invalid_argument("Simulation::register_gate: not a gate");
+  }
+  m_gates[static_cast<std::size_t>(type)] = true;
+  m_primitives.erase(m_world.intern(gate_name(type)));
+}
 
 void Simulation::register_primitive(const std::string &name,
                                     BehaviorFunc func) {
-  m_primitives[name] = std::move(func);
+  if (const GateType type = gate_type_of(name); type != GateType::INVALID) {
+    m_gates[static_cast<std::size_t>(type)] = false;
+  }
+  m_primitives[m_world.intern(name)] = std::move(func);
 }
 
 void Simulation::step() {
@@ -15,39 +53,15 @@ void Simulation::step() {
     if (!def || !def->is_primitive)
       return;
 
-    auto it = m_primitives.find(def->name);
-    if (it == m_primitives.end())
+    const GateType type = opcode_of(inst.definition, *def);
+    if (type != GateType::INVALID && m_gates[static_cast<std::size_t>(type)]) {
+      evaluate_gate(type, entity);
       return;
+    }
 
-    std::vector<BitValue> inputs;
-    std::vector<BitValue> outputs;
-    std::vector<Entity> output_ports;
-
-    m_world.view<Port>().each([&](Entity port_entity, Port &port) {
-      if (!(port.owner == entity))
-        return;
-
-      if (port.direction == PortDirection::In) {
-        if (auto *val = m_world.get<BitValue>(port.connected_signal)) {
-          inputs.push_back(*val);
-        } else {
-          inputs.push_back(BitValue(port.width));
-        }
-      } else if (port.direction == PortDirection::Out) {
-        outputs.push_back(BitValue(port.width));
-        output_ports.push_back(port_entity);
-      }
-    });
-
-    it->second(inputs, outputs);
-
-    for (std::size_t i = 0; i < output_ports.size() && i < outputs.size();
-         ++i) {
-      if (auto *port = m_world.get<Port>(output_ports[i])) {
-        if (port->connected_signal.valid()) {
-          m_world.emplace<BitValue>(port->connected_signal, outputs[i]);
-        }
-      }
+    auto it = m_primitives.find(def->name);
+    if (it != m_primitives.end()) {
+      evaluate_custom(it->second, entity);
     }
   });
 }
@@ -58,64 +72,123 @@ void Simulation::run(std::size_t cycles) {
   }
 }
 
+// Resolved from the def name once, then read back from the PrimitiveOp.
+GateType Simulation::opcode_of(Entity def_entity, const ModuleDef &def) {
+  if (const auto *op = m_world.get<PrimitiveOp>(def_entity);
+      op && op->name == def.name) {
+    return op->type;
+  }
+  const GateType type = gate_type_of(m_world.name(def.name));
+  m_world.emplace<PrimitiveOp>(def_entity, type, def.name);
+  return type;
+}
+
+// Folds bit 0 of every input; NOT and BUF read the first input only. The
+// result drives the first output, further outputs are cleared.
+void Simulation::evaluate_gate(GateType type, Entity instance) {
+  std::size_t inputs = 0;
+  std::size_t ones = 0;
+  bool first = false;
+  m_output_ports.clear();
+
+  for (Entity port_entity : m_world.related<&Port::owner>(instance)) {
+    const auto &port = *m_world.get<Port>(port_entity);
+    if (port.direction == PortDirection::In) {
+      const auto *val = m_world.get<BitValue>(port.connected_signal);
+      const bool bit = val && val->get_bit(0);
+      if (inputs == 0)
+        first = bit;
+      ones += bit;
+      ++inputs;
+    } else if (port.direction == PortDirection::Out) {
+      m_output_ports.push_back(port_entity);
+    }
+  }
+
+  const bool unary = type == GateType::NOT || type == GateType::BUF;
+  if (inputs < (unary ? 1u : 2u) || m_output_ports.empty())
+    return;
+
+  bool result = false;
+  switch (type) {
+  case GateType::AND:
+    result = ones == inputs;
+    break;
+  case GateType::NAND:
+    result = ones != inputs;
+    break;
+  case GateType::OR:
+    result = ones != 0;
+    break;
+  case GateType::NOR:
+    result = ones == 0;
+    break;
+  case GateType::XOR:
+    result = (ones & 1u) != 0;
+    break;
+  case GateType::XNOR:
+    result = (ones & 1u) == 0;
+    break;
+  case GateType::NOT:
+    result = !first;
+    break;
+  case GateType::BUF:
+    result = first;
+    break;
+  case GateType::INVALID:
+  case GateType::COUNT:
+    return;
+  }
+
+  for (std::size_t i = 0; i < m_output_ports.size(); ++i) {
+    const auto &port = *m_world.get<Port>(m_output_ports[i]);
+    if (!port.connected_signal.valid())
+      continue;
+    BitValue value(i == 0 ? 1u : port.width);
+    if (i == 0)
+      value.set_bit(0, result);
+    m_world.emplace<BitValue>(port.connected_signal, std::move(value));
+  }
+}
+
+void Simulation::evaluate_custom(const BehaviorFunc &func, Entity instance) {
+  std::vector<BitValue> inputs;
+  std::vector<BitValue> outputs;
+  std::vector<Entity> output_ports;
+
+  for (Entity port_entity : m_world.related<&Port::owner>(instance)) {
+    const auto &port = *m_world.get<Port>(port_entity);
+    if (port.direction == PortDirection::In) {
+      if (auto *val = m_world.get<BitValue>(port.connected_signal)) {
+        inputs.push_back(*val);
+      } else {
+        inputs.push_back(BitValue(port.width));
+      }
+    } else if (port.direction == PortDirection::Out) {
+      outputs.push_back(BitValue(port.width));
+      output_ports.push_back(port_entity);
+    }
+  }
+
+  func(inputs, outputs);
+
+  for (std::size_t i = 0; i < output_ports.size() && i < outputs.size(); ++i) {
+    if (auto *port = m_world.get<Port>(output_ports[i])) {
+      if (port->connected_signal.valid()) {
+        m_world.emplace<BitValue>(port->connected_signal, outputs[i]);
+      }
+    }
+  }
+}
+
 namespace primitives {
 
 void register_basic_gates(Simulation &sim) {
-  sim.register_primitive(
-      "AND", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.size() < 2 || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, in[0].get_bit(0) && in[1].get_bit(0));
-      });
-
-  sim.register_primitive(
-      "OR", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.size() < 2 || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, in[0].get_bit(0) || in[1].get_bit(0));
-      });
-
-  sim.register_primitive(
-      "NOT", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.empty() || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, !in[0].get_bit(0));
-      });
-
-  sim.register_primitive(
-      "NAND", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.size() < 2 || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, !(in[0].get_bit(0) && in[1].get_bit(0)));
-      });
-
-  sim.register_primitive(
-      "NOR", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.size() < 2 || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, !(in[0].get_bit(0) || in[1].get_bit(0)));
-      });
-
-  sim.register_primitive(
-      "XOR", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.size() < 2 || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, in[0].get_bit(0) != in[1].get_bit(0));
-      });
-
-  sim.register_primitive(
-      "XNOR", [](const std::vector<BitValue> &in, std::vector<BitValue> &out) {
-        if (in.size() < 2 || out.empty())
-          return;
-        out[0] = BitValue(1);
-        out[0].set_bit(0, in[0].get_bit(0) == in[1].get_bit(0));
-      });
+  for (auto type : {GateType::AND, GateType::NAND, GateType::OR,
+                    GateType::NOR, GateType::XOR, GateType::XNOR,
+                    GateType::NOT, GateType::BUF}) {
+    sim.register_gate(type);
+  }
 }
 
 } // namespace primitives
@@ -2,8 +2,25 @@
 #include <core/world.hpp>
 #include <components/components.hpp>
 
+#include <array>
+#include <atomic>
+#include <core/thread_pool.hpp>
+#include <stdexcept>
+
 using namespace netra;
 
+namespace {
+
+// Plain trivially-copyable component used by the ECS tests.
+struct Transform {
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t w;
+    std::int32_t h;
+};
+
+} // namespace
+
 TEST(entity_creation) {
     World world;
     
@@ -83,7 +100,7 @@ TEST(component_cleanup_on_destroy) {
     Entity e = world.create();
     
     world.emplace<Transform>(e, 0, 0, 0, 0);
-    world.emplace<ModuleDef>(e, "test", false);
+    world.emplace<ModuleDef>(e, world.intern("test"), false);
     
     world.destroy(e);
     
@@ -126,12 +143,12 @@ TEST(view_multiple_components) {
     Entity e3 = world.create();
     
     world.emplace<Transform>(e1, 1, 0, 0, 0);
-    world.emplace<ModuleInst>(e1, "inst1", Entity{});
+    world.emplace<ModuleInst>(e1, world.intern("inst1"), Entity{});
     
     world.emplace<Transform>(e2, 2, 0, 0, 0);
     // e2 has no ModuleInst
     
-    world.emplace<ModuleInst>(e3, "inst3", Entity{});
+    world.emplace<ModuleInst>(e3, world.intern("inst3"), Entity{});
     // e3 has no Transform
     
     int count = 0;
@@ -140,7 +157,7 @@ TEST(view_multiple_components) {
     world.view<Transform, ModuleInst>().each([&](Entity e, Transform& t, ModuleInst& m) {
         ++count;
         if (t.x != 1) correct = false;
-        if (m.instance_name != "inst1") correct = false;
+        if (m.instance_name != world.intern("inst1")) correct = false;
     });
     
     ASSERT_EQ(count, 1);
@@ -168,3 +185,254 @@ TEST(bitvalue_operations) {
     
     return true;
 }
+
+TEST(create_many_reuses_free_ids_first) {
+    World world;
+    auto first = world.create_many(4);
+    world.destroy(first[1]);
+    world.destroy(first[3]);
+
+    auto batch = world.create_many(3);
+    ASSERT_EQ(batch.size(), 3u);
+    ASSERT_EQ(batch[0].id(), first[3].id());
+    ASSERT_EQ(batch[1].id(), first[1].id());
+    ASSERT_EQ(batch[2].id(), 4u);
+    for (Entity e : batch) {
+        ASSERT(world.alive(e));
+    }
+    ASSERT_EQ(world.entity_count(), 5u);
+
+    // Must not collide with the batch.
+    Entity next = world.create();
+    ASSERT_EQ(next.id(), 5u);
+
+    return true;
+}
+
+TEST(emplace_many_matches_individual_emplace) {
+    World world;
+    auto entities = world.create_many(3);
+    std::array<Transform, 3> values{{{1, 0, 0, 0}, {2, 0, 0, 0}, {3, 0, 0, 0}}};
+
+    world.reserve<Transform>(entities.size());
+    world.emplace_many<Transform>(entities, values);
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        ASSERT_EQ(world.get<Transform>(entities[i])->x, values[i].x);
+    }
+
+    world.emplace_many<Transform>(entities, Transform{7, 7, 7, 7});
+    ASSERT_EQ(world.get_storage<Transform>()->size(), 3u);
+    for (Entity e : entities) {
+        ASSERT_EQ(world.get<Transform>(e)->x, 7);
+    }
+
+    bool threw = false;
+    try {
+        world.emplace_many<Transform>(entities, std::span<const Transform>(values.data(), 2));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT(threw);
+
+    return true;
+}
+
+TEST(destroy_many_strips_components_and_ignores_dead) {
+    World world;
+    auto entities = world.create_many(4);
+    world.emplace_many<Transform>(entities, Transform{1, 1, 1, 1});
+    world.emplace<ModuleDef>(entities[2], world.intern("m"), false);
+    world.destroy(entities[0]);
+
+    std::array<Entity, 3> batch{entities[0], entities[2], entities[2]};
+    world.destroy_many(batch);
+
+    ASSERT(!world.alive(entities[2]));
+    ASSERT(!world.has<Transform>(entities[2]));
+    ASSERT(!world.has<ModuleDef>(entities[2]));
+    ASSERT(world.has<Transform>(entities[1]));
+    ASSERT(world.has<Transform>(entities[3]));
+    ASSERT_EQ(world.entity_count(), 2u);
+
+    // Exactly two ids were freed (0 and 2); a third create must be fresh.
+    auto again = world.create_many(3);
+    ASSERT_EQ(again[2].id(), 4u);
+
+    return true;
+}
+
+TEST(insert_many_batches_grow_geometrically) {
+    ComponentStorage<std::int32_t> storage;
+    std::size_t reallocations = 0;
+    const std::int32_t* data = nullptr;
+    for (EntityID id = 0; id < 1000; ++id) {
+        const std::array<Entity, 1> batch{Entity(id)};
+        storage.insert_many(batch, std::int32_t{7});
+        if (storage.components().data() != data) {
+            data = storage.components().data();
+            ++reallocations;
+        }
+    }
+    ASSERT_EQ(storage.size(), 1000u);
+    ASSERT(reallocations < 20);
+    return true;
+}
+
+TEST(relation_index_tracks_port_owner) {
+    World world;
+    Entity module_a = world.create();
+    Entity module_b = world.create();
+    Entity p1 = world.create();
+    Entity p2 = world.create();
+    Entity p3 = world.create();
+
+    world.emplace<Port>(p1, world.intern("A"), PortDirection::In, 1u, module_a, Entity{});
+    world.index_relation<&Port::owner>();
+    world.emplace<Port>(p2, world.intern("B"), PortDirection::In, 1u, module_a, Entity{});
+    world.emplace<Port>(p3, world.intern("Y"), PortDirection::Out, 1u, module_b, Entity{});
+
+    auto ports_a = world.related<&Port::owner>(module_a);
+    ASSERT_EQ(ports_a.size(), 2u);
+    ASSERT(ports_a[0] == p1);
+    ASSERT(ports_a[1] == p2);
+
+    // Move p2 to module_b through patch.
+    ASSERT(world.patch<Port>(p2, [&](Port& p) { p.owner = module_b; }));
+    ASSERT_EQ(world.related<&Port::owner>(module_a).size(), 1u);
+    ASSERT_EQ(world.related<&Port::owner>(module_b).size(), 2u);
+
+    // Re-emplace replaces the link instead of adding a second one.
+    world.emplace<Port>(p3, world.intern("Y"), PortDirection::Out, 1u, module_a, Entity{});
+    ASSERT_EQ(world.related<&Port::owner>(module_a).size(), 2u);
+    ASSERT_EQ(world.related<&Port::owner>(module_b).size(), 1u);
+
+    world.remove<Port>(p1);
+    world.destroy(p2);
+    ASSERT_EQ(world.related<&Port::owner>(module_a).size(), 1u);
+    ASSERT(world.related<&Port::owner>(module_a)[0] == p3);
+    ASSERT(world.related<&Port::owner>(module_b).empty());
+
+    return true;
+}
+
+TEST(relation_query_without_index_is_rejected) {
+    World world;
+    Entity port = world.create();
+    world.emplace<Port>(port, world.intern("A"), PortDirection::In, 1u, Entity{}, Entity{});
+
+    bool threw = false;
+    try {
+        (void)world.related<&Port::connected_signal>(Entity{0});
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    ASSERT(threw);
+    ASSERT(!world.patch<Signal>(port, [](Signal&) {}));
+
+    return true;
+}
+
+TEST(change_tracking_records_writes_per_storage) {
+    World world;
+    world.track<Transform>();
+    Entity a = world.create();
+    Entity b = world.create();
+
+    world.emplace<Transform>(a, 0, 0, 0, 0);
+    world.emplace<Transform>(a, 1, 0, 0, 0);   // overwrite -> modified
+    ASSERT(world.patch<Transform>(a, [](Transform& t) { t.x = 2; }));
+    world.emplace<ModuleDef>(b, world.intern("untracked"), false);
+
+    const auto& changes = world.changes<Transform>();
+    ASSERT_EQ(changes.added().size(), 1u);
+    ASSERT_EQ(changes.modified().size(), 1u);
+    ASSERT(changes.removed().empty());
+    ASSERT(!world.tracked<ModuleDef>());
+
+    world.clear_changes<Transform>();
+    ASSERT(world.changes<Transform>().empty());
+
+    // Writes through get<T>() are only visible via mark_modified.
+    world.get<Transform>(a)->x = 3;
+    ASSERT(world.changes<Transform>().modified().empty());
+    world.mark_modified<Transform>(a);
+    world.mark_modified<Transform>(b); // b has no Transform: ignored
+    ASSERT_EQ(world.changes<Transform>().modified().size(), 1u);
+
+    world.destroy(a);
+    ASSERT_EQ(world.changes<Transform>().removed().size(), 1u);
+    ASSERT(world.changes<Transform>().removed()[0] == a);
+
+    bool threw = false;
+    try {
+        (void)world.changes<ModuleDef>();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    ASSERT(threw);
+
+    return true;
+}
+
+TEST(par_each_visits_each_matching_entity_once) {
+    World world;
+    ThreadPool pool(4);
+    auto entities = world.create_many(10'000);
+    world.emplace_many<Transform>(entities, Transform{1, 0, 0, 0});
+    for (std::size_t i = 0; i < entities.size(); i += 3) {
+        world.emplace<ModuleDef>(entities[i], world.intern("m"), false);
+    }
+
+    std::atomic<int> visits{0};
+    world.view<Transform, ModuleDef>().par_each(pool,
+        [&](Entity, Transform& t, ModuleDef&) {
+            t.y += 1;
+            visits.fetch_add(1, std::memory_order_relaxed);
+        }, 64);
+
+    ASSERT_EQ(visits.load(), 3334);
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        ASSERT_EQ(world.get<Transform>(entities[i])->y, i % 3 == 0 ? 1 : 0);
+    }
+
+    return true;
+}
+
+TEST(thread_pool_rethrows_and_recovers) {
+    ThreadPool pool(3);
+    bool threw = false;
+    try {
+        pool.parallel_for(1000, 10, [](std::size_t begin, std::size_t) {
+            if (begin == 500) throw std::runtime_error("chunk failed");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSERT(threw);
+
+    std::atomic<std::size_t> total{0};
+    pool.parallel_for(1000, 10, [&](std::size_t begin, std::size_t end) {
+        total.fetch_add(end - begin, std::memory_order_relaxed);
+    });
+    ASSERT_EQ(total.load(), 1000u);
+
+    return true;
+}
+
+TEST(symbols_are_interned_per_world) {
+    World world;
+    const Symbol a = world.intern("A");
+    ASSERT(world.intern("A") == a);
+    ASSERT(world.intern("B") != a);
+    ASSERT(world.name(a) == "A");
+    ASSERT(world.name(Symbol{}).empty());
+    ASSERT(!world.symbols().find("Y").has_value());
+
+    World copy = world.clone();
+    ASSERT(copy.name(a) == "A");
+    ASSERT(copy.intern("A") == a);
+    const Symbol y = copy.intern("Y");
+    ASSERT(copy.name(y) == "Y");
+    ASSERT(!world.symbols().contains(y));
+    return true;
+}
@@ -0,0 +1,739 @@
+#include "test_framework.hpp"
+#include <core/astar.hpp>
+#include <core/occupancy_bitmap.hpp>
+#include <core/route_field.hpp>
+#include <core/routing_tile_map.hpp>
+#include <core/tiled_grid.hpp>
+#include <components/components.hpp>
+#include <components/render_components.hpp>
+#include <graphics/grid.hpp>
+#include <core/thread_pool.hpp>
+#include <systems/autorouter.hpp>
+#include <systems/layout_system.hpp>
+#include <systems/preview_router.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <queue>
+#include <stdexcept>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace netra;
+
+namespace {
+
+// Random obstacles on [0, size)^2; everything outside is blocked.
+struct TestGrid {
+    int size = 0;
+    std::vector<bool> cells;
+
+    bool blocked(GridCoord p) const {
+        if (p.x < 0 || p.y < 0 || p.x >= size || p.y >= size)
+            return true;
+        return cells[static_cast<std::size_t>(p.y * size + p.x)];
+    }
+};
+
+TestGrid random_grid(int size, double density, std::mt19937& rng) {
+    TestGrid grid{size, std::vector<bool>(static_cast<std::size_t>(size * size))};
+    std::bernoulli_distribution obstacle(density);
+    for (std::size_t i = 0; i < grid.cells.size(); ++i)
+        grid.cells[i] = obstacle(rng);
+    return grid;
+}
+
+// Plain Dijkstra over (cell, heading) with the same cost model; -1 if
+// unreachable.
+int reference_cost(const TestGrid& grid, GridCoord start, GridCoord end) {
+    const GridCoord steps[] = {{0, 1}, {0, -1}, {-1, 0}, {1, 0}};
+    const int n = grid.size;
+    std::vector<int> best(static_cast<std::size_t>(n * n * 4), -1);
+    using Item = std::pair<int, int>; // cost, state
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    for (int d = 0; d < 4; ++d)
+        open.push({0, (start.y * n + start.x) * 4 + d});
+    while (!open.empty()) {
+        auto [cost, state] = open.top();
+        open.pop();
+        if (best[static_cast<std::size_t>(state)] >= 0)
+            continue;
+        best[static_cast<std::size_t>(state)] = cost;
+        const int cell = state / 4;
+        const GridCoord pos{cell % n, cell / n};
+        if (pos == end)
+            return cost;
+        for (int d = 0; d < 4; ++d) {
+            const GridCoord next{pos.x + steps[d].x, pos.y + steps[d].y};
+            if (!(next == end) && grid.blocked(next))
+                continue;
+            const int next_cost = cost + k_path_move_cost + (d != state % 4 ? k_path_turn_cost : 0);
+            open.push({next_cost, (next.y * n + next.x) * 4 + d});
+        }
+    }
+    return -1;
+}
+
+bool valid_path(const std::vector<GridCoord>& path, const TestGrid& grid, GridCoord start, GridCoord end) {
+    if (path.empty() || !(path.front() == start) || !(path.back() == end))
+        return false;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        if (std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y) != 1)
+            return false;
+        if (!(path[i] == end) && grid.blocked(path[i]))
+            return false;
+    }
+    return true;
+}
+
+// An editor-sized gate (20x16 cells, inputs at (0,4) and (0,12), output at
+// (20,8)) at `origin`; returns its output port.
+Entity add_gate(World& world, GridCoord origin, int unit_px) {
+    const Entity inst = world.create();
+    world.emplace<ModuleInst>(inst, Symbol{}, Entity{});
+    world.emplace<ModuleExtent>(inst, 20, 16);
+    world.emplace<ModulePixelPosition>(inst, static_cast<float>(origin.x * unit_px),
+                                       static_cast<float>(origin.y * unit_px));
+    Entity out;
+    for (const auto& [x, y] : {std::pair{0, 4}, std::pair{0, 12}, std::pair{20, 8}}) {
+        const Entity port = world.create();
+        world.emplace<Port>(port, Symbol{}, x == 0 ? PortDirection::In : PortDirection::Out, 1u, inst,
+                            Entity{});
+        world.emplace<PortOffset>(port, x, y);
+        world.emplace<PortGridPosition>(port, GridCoord{origin.x + x, origin.y + y});
+        out = port;
+    }
+    return out;
+}
+
+// A signal joining `ports`, without wires.
+Entity add_net(World& world, std::vector<Entity> ports) {
+    const Entity signal = world.create();
+    world.emplace<Signal>(signal, Symbol{}, 1u, Entity{}, std::move(ports));
+    return signal;
+}
+
+} // namespace
+
+TEST(router_finds_minimum_cost_paths) {
+    std::mt19937 rng(3);
+    OrthogonalRouter router;
+    for (int round = 0; round < 200; ++round) {
+        const TestGrid grid = random_grid(24, 0.3, rng);
+        std::uniform_int_distribution<int> coord(0, grid.size - 1);
+        const GridCoord start{coord(rng), coord(rng)};
+        const GridCoord end{coord(rng), coord(rng)};
+        if (grid.blocked(start) || grid.blocked(end) || start == end)
+            continue;
+
+        const int expected = reference_cost(grid, start, end);
+        const auto path = router.find_path(start, end, [&](GridCoord p) { return grid.blocked(p); });
+        if (expected < 0) {
+            ASSERT(path.empty());
+            continue;
+        }
+        ASSERT(valid_path(path, grid, start, end));
+        ASSERT_EQ(orthogonal_path_cost(path), expected);
+    }
+    return true;
+}
+
+TEST(router_grows_window_for_long_detours) {
+    // A wall at x = 10 from y = -200 to y = 200, open on both ends.
+    auto wall = [](GridCoord p) { return p.x == 10 && p.y >= -200 && p.y <= 200; };
+    const GridCoord start{0, 0};
+    const GridCoord end{20, 0};
+
+    PathSearchStats stats;
+    const auto path = find_orthogonal_path(start, end, wall, &stats);
+    ASSERT(!path.empty());
+    ASSERT_EQ(orthogonal_path_cost(path), 20 + 2 * 201 + 2 * k_path_turn_cost);
+    ASSERT(stats.expanded > 0);
+    return true;
+}
+
+TEST(router_finds_long_open_routes) {
+    // Endpoints whose first window is already larger than
+    // k_max_window_cells, on an empty canvas.
+    auto open = [](GridCoord) { return false; };
+    OrthogonalRouter router;
+    for (const RouteSearch kind : {RouteSearch::Cells, RouteSearch::JumpPoints}) {
+        const auto diagonal = router.find_path({0, 0}, {960, 960}, open, nullptr, kind);
+        ASSERT_EQ(orthogonal_path_cost(diagonal), 2 * 960 + k_path_turn_cost);
+        const auto straight = router.find_path({0, 0}, {20000, 0}, open, nullptr, kind);
+        ASSERT_EQ(orthogonal_path_cost(straight), 20000);
+    }
+    return true;
+}
+
+TEST(router_fails_fast_when_start_is_enclosed) {
+    auto box = [](GridCoord p) {
+        return (std::abs(p.x) == 2 && std::abs(p.y) <= 2) || (std::abs(p.y) == 2 && std::abs(p.x) <= 2);
+    };
+    PathSearchStats stats;
+    const auto path = find_orthogonal_path({0, 0}, {50, 50}, box, &stats);
+    ASSERT(path.empty());
+    ASSERT(stats.expanded < 100);
+    return true;
+}
+
+TEST(occupancy_bitmap_probes_cells) {
+    OccupancyBitmap bitmap;
+    bitmap.set({-1, 5});   // last column of a tile left of x = 0
+    bitmap.set({0, 5});    // first column of the next one
+    bitmap.set({63, -64}); // last column of a tile's first row
+    bitmap.set({1'000'000, -1'000'000});
+
+    ASSERT(bitmap.test({-1, 5}));
+    ASSERT(bitmap.test({0, 5}));
+    ASSERT(bitmap.test({63, -64}));
+    ASSERT(bitmap.test({1'000'000, -1'000'000}));
+    ASSERT(!bitmap.test({-2, 5}));
+    ASSERT(!bitmap.test({1, 5}));
+    ASSERT(!bitmap.test({0, 4}));
+    ASSERT(!bitmap.test({62, -64}));
+    ASSERT(!bitmap.test({63, -63}));
+    ASSERT(!bitmap.test({-1'000'000, 1'000'000}));
+    ASSERT_EQ(bitmap.tile_count(), std::size_t{4});
+
+    // A copy keeps its cells while the original is edited, and freeing
+    // the last cell of a tile frees the tile.
+    const OccupancyBitmap copy = bitmap;
+    bitmap.reset({1'000'000, -1'000'000});
+    bitmap.reset({-1, 5});
+    bitmap.set({2, 5});
+    ASSERT_EQ(bitmap.tile_count(), std::size_t{2});
+    ASSERT(!bitmap.test({-1, 5}) && bitmap.test({2, 5}));
+    ASSERT(copy.test({-1, 5}) && !copy.test({2, 5}));
+    ASSERT(copy.test({1'000'000, -1'000'000}));
+    ASSERT_EQ(copy.tile_count(), std::size_t{4});
+    return true;
+}
+
+TEST(router_bitmap_matches_predicate) {
+    std::mt19937 rng(8);
+    OrthogonalRouter router;
+    for (int round = 0; round < 100; ++round) {
+        const TestGrid grid = random_grid(24, 0.3, rng);
+        // The grid plus a blocked ring around it.
+        OccupancyBitmap bitmap;
+        for (int y = -1; y <= grid.size; ++y)
+            for (int x = -1; x <= grid.size; ++x)
+                if (grid.blocked({x, y}))
+                    bitmap.set({x, y});
+
+        std::uniform_int_distribution<int> coord(0, grid.size - 1);
+        const GridCoord start{coord(rng), coord(rng)};
+        const GridCoord end{coord(rng), coord(rng)};
+        if (grid.blocked(start) || grid.blocked(end) || start == end)
+            continue;
+
+        const auto expected = router.find_path(start, end, [&](GridCoord p) { return grid.blocked(p); });
+        const auto path = router.find_path(start, end, bitmap);
+        ASSERT_EQ(path.size(), expected.size());
+        if (!path.empty()) {
+            ASSERT(valid_path(path, grid, start, end));
+            ASSERT_EQ(orthogonal_path_cost(path), orthogonal_path_cost(expected));
+        }
+    }
+    return true;
+}
+
+TEST(jump_search_matches_cell_search_costs) {
+    std::mt19937 rng(21);
+    OrthogonalRouter router;
+    for (int round = 0; round < 200; ++round) {
+        const TestGrid grid = random_grid(24, round % 2 ? 0.15 : 0.35, rng);
+        std::uniform_int_distribution<int> coord(0, grid.size - 1);
+        const GridCoord start{coord(rng), coord(rng)};
+        const GridCoord end{coord(rng), coord(rng)};
+        if (grid.blocked(start) || grid.blocked(end) || start == end)
+            continue;
+
+        auto blocked = [&](GridCoord p) { return grid.blocked(p); };
+        const auto cells = router.find_path(start, end, blocked);
+        const auto jumps = router.find_path(start, end, blocked, nullptr, RouteSearch::JumpPoints);
+        ASSERT_EQ(jumps.empty(), cells.empty());
+        if (!cells.empty()) {
+            ASSERT(valid_path(jumps, grid, start, end));
+            ASSERT_EQ(orthogonal_path_cost(jumps), orthogonal_path_cost(cells));
+        }
+    }
+    return true;
+}
+
+TEST(jump_search_matches_cell_search_on_open_canvas) {
+    std::mt19937 rng(34);
+    OrthogonalRouter router;
+    for (int round = 0; round < 60; ++round) {
+        std::uniform_int_distribution<int> coord(-120, 120);
+        std::uniform_int_distribution<int> extent(2, 30);
+        OccupancyBitmap bitmap;
+        for (int r = 0; r < 25; ++r) {
+            const int x0 = coord(rng), y0 = coord(rng), w = extent(rng), h = extent(rng);
+            for (int y = y0; y < std::min(y0 + h, 150); ++y)
+                for (int x = x0; x < std::min(x0 + w, 150); ++x)
+                    bitmap.set({x, y});
+        }
+        const GridCoord start{coord(rng), coord(rng)};
+        const GridCoord end{coord(rng), coord(rng)};
+        if (bitmap.test(start) || bitmap.test(end) || start == end)
+            continue;
+
+        PathSearchStats cell_stats;
+        PathSearchStats jump_stats;
+        const auto cells = router.find_path(start, end, bitmap, &cell_stats);
+        const auto jumps = router.find_path(start, end, bitmap, &jump_stats, RouteSearch::JumpPoints);
+        ASSERT_EQ(jumps.empty(), cells.empty());
+        if (!cells.empty()) {
+            ASSERT(jumps.front() == start && jumps.back() == end);
+            ASSERT_EQ(orthogonal_path_cost(jumps), orthogonal_path_cost(cells));
+        }
+    }
+    return true;
+}
+
+TEST(jump_search_expands_few_nodes_on_long_routes) {
+    auto open = [](GridCoord) { return false; };
+    PathSearchStats cell_stats;
+    PathSearchStats jump_stats;
+    const auto cells = find_orthogonal_path({0, 0}, {400, 300}, open, &cell_stats);
+    OrthogonalRouter router;
+    const auto jumps = router.find_path({0, 0}, {400, 300}, open, &jump_stats, RouteSearch::JumpPoints);
+    ASSERT_EQ(orthogonal_path_cost(jumps), orthogonal_path_cost(cells));
+    ASSERT(jump_stats.expanded * 10 <= cell_stats.expanded);
+    return true;
+}
+
+TEST(tile_map_counts_footprints_per_tile) {
+    RoutingTileMap tiles(16);
+    ASSERT(tiles.tile_of({-1, -16}) == (GridCoord{-1, -1}));
+    ASSERT(tiles.tile_of({-17, 15}) == (GridCoord{-2, 0}));
+
+    const GridRect rect{{-4, -4}, {19, 3}};
+    tiles.add_blocked(rect);
+    tiles.add_wire_cell({5, 5});
+    ASSERT_EQ(tiles.blocked_cells({-1, -1}), 16);
+    ASSERT_EQ(tiles.blocked_cells({0, -1}), 64);
+    ASSERT_EQ(tiles.blocked_cells({1, -1}), 16);
+    ASSERT_EQ(tiles.blocked_cells({0, 0}), 64);
+    ASSERT_EQ(tiles.blocked_cells({2, 0}), 0);
+    ASSERT_EQ(tiles.wire_cells({0, 0}), 1);
+
+    tiles.add_blocked(rect, -1);
+    tiles.add_wire_cell({5, 5}, -1);
+    ASSERT(tiles == RoutingTileMap(16));
+    return true;
+}
+
+TEST(tile_map_corridor_avoids_full_tiles) {
+    RoutingTileMap tiles(16);
+    // A wall of full tiles at tile column 2, rows -3 to 3.
+    tiles.add_blocked({{32, -48}, {47, 63}});
+    const auto corridor = tiles.find_corridor({0, 0}, {80, 0});
+    ASSERT(!corridor.empty());
+    ASSERT(corridor.front() == (GridCoord{0, 0}));
+    ASSERT(corridor.back() == (GridCoord{5, 0}));
+    for (std::size_t i = 0; i < corridor.size(); ++i) {
+        ASSERT(tiles.passable(corridor[i]));
+        if (i > 0)
+            ASSERT_EQ(std::abs(corridor[i].x - corridor[i - 1].x) + std::abs(corridor[i].y - corridor[i - 1].y), 1);
+    }
+    // Around the wall: up or down past row 3, and back.
+    ASSERT(corridor.size() >= 6 + 2 * 4);
+    return true;
+}
+
+TEST(tile_map_corridor_between_far_tiles) {
+    RoutingTileMap tiles(16);
+    // Footprints a million cells apart, with a wall beside the start.
+    tiles.add_blocked({{-8, -8}, {8, 8}});
+    tiles.add_blocked({{1'000'000, 1'000'000}, {1'000'020, 1'000'016}});
+    tiles.add_blocked({{32, -48}, {47, 63}});
+    const auto corridor = tiles.find_corridor({0, 0}, {1'000'000, 1'000'000});
+    ASSERT(!corridor.empty());
+    ASSERT(corridor.back() == tiles.tile_of({1'000'000, 1'000'000}));
+    // 62 500 tiles each way: a shortest chain, the wall is on the way.
+    ASSERT_EQ(corridor.size(), std::size_t{2 * 62'500 + 1});
+    return true;
+}
+
+TEST(layout_tile_map_follows_moved_modules) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    std::vector<Entity> outputs;
+    for (int i = 0; i < 16; ++i)
+        outputs.push_back(add_gate(world, {(i % 4) * 32, (i / 4) * 24}, unit));
+    world.emplace<Wire>(world.create(), Entity{}, outputs[0], Entity{},
+                        std::vector<GridCoord>{{21, 8}, {22, 8}, {23, 8}});
+    LayoutSystem layout(world, grid);
+
+    // Drag gate 5 by its output port, far enough to change tiles.
+    const Entity port = outputs[5];
+    const Entity gate = world.get<Port>(port)->owner;
+    world.get<PortGridPosition>(port)->position = {200 + 20, -37 + 8};
+    layout.update_module_from_anchor(port, gate);
+    ASSERT(world.get<ModulePixelPosition>(gate)->x == 2000.0f);
+
+    const LayoutSystem rebuilt(world, grid);
+    ASSERT(layout.tile_map() == rebuilt.tile_map());
+    ASSERT(layout.is_cell_blocked({205, -30}));
+    ASSERT(!layout.is_cell_blocked({32 + 5, 24 + 5}));
+    return true;
+}
+
+TEST(layout_index_updates_match_rebuild) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    // B's padding ring runs over A's output port and right padding column.
+    add_gate(world, {0, 0}, unit);
+    const Entity b_out = add_gate(world, {21, 0}, unit);
+    const Entity c_out = add_gate(world, {0, 40}, unit);
+    auto wire = [&](GridCoord from, GridCoord to) {
+        std::vector<GridCoord> points;
+        for (GridCoord p = from; p != to; p = {p.x + (to.x > p.x) - (to.x < p.x), p.y + (to.y > p.y) - (to.y < p.y)})
+            points.push_back(p);
+        points.push_back(to);
+        const Entity e = world.create();
+        world.emplace<Wire>(e, Entity{}, Entity{}, Entity{}, std::move(points));
+        return e;
+    };
+    const Entity crossing = wire({-3, 30}, {60, 30});
+    wire({50, -3}, {50, 70});
+    LayoutSystem layout(world, grid);
+
+    const GridRect region{{-5, -5}, {130, 90}};
+    auto cells = [&](auto&& probe) {
+        std::vector<bool> out;
+        for (std::int32_t y = region.min.y; y <= region.max.y; ++y)
+            for (std::int32_t x = region.min.x; x <= region.max.x; ++x)
+                out.push_back(probe(GridCoord{x, y}));
+        return out;
+    };
+    const auto snapshot = layout.occupancy_snapshot();
+    const auto snapshot_cells = cells(*snapshot);
+    const std::uint64_t version = layout.index_version();
+    ASSERT(!layout.is_cell_blocked({20, 8}));  // A's port under B's padding
+    ASSERT(layout.is_cell_blocked({20, 7}));
+
+    // Drag B away, add a wire, delete the crossing wire and gate C.
+    world.get<PortGridPosition>(b_out)->position = {100 + 20, 60 + 8};
+    layout.update_module_from_anchor(b_out, world.get<Port>(b_out)->owner);
+    layout.index_entity(wire({-3, 34}, {40, 34}));
+    layout.unindex_entity(crossing);
+    world.destroy(crossing);
+    const Entity c = world.get<Port>(c_out)->owner;
+    layout.unindex_entity(c);
+    auto owned = world.related<&Port::owner>(c);
+    for (Entity port : std::vector<Entity>(owned.begin(), owned.end()))
+        world.destroy(port);
+    world.destroy(c);
+    ASSERT(layout.index_version() > version);
+
+    const LayoutSystem rebuilt(world, grid);
+    for (const auto& [module, wires] : {std::pair{true, true}, std::pair{true, false}, std::pair{false, true}}) {
+        ASSERT(cells([&](GridCoord p) { return layout.is_cell_blocked(p, module, wires); }) ==
+               cells([&](GridCoord p) { return rebuilt.is_cell_blocked(p, module, wires); }));
+    }
+    ASSERT(cells(*layout.occupancy_snapshot()) == cells(*rebuilt.occupancy_snapshot()));
+    ASSERT(layout.tile_map() == rebuilt.tile_map());
+    ASSERT(!layout.is_cell_blocked({20, 8}) && !layout.is_cell_blocked({21, 8}));
+    ASSERT(cells(*snapshot) == snapshot_cells);
+    return true;
+}
+
+TEST(layout_queries_see_overlapping_entities) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    // B's padding ring runs over A's output port at (20, 8).
+    const Entity a_out = add_gate(world, {0, 0}, unit);
+    add_gate(world, {21, 0}, unit);
+    const Entity a = world.get<Port>(a_out)->owner;
+    auto wire = [&](std::vector<GridCoord> points) {
+        const Entity e = world.create();
+        world.emplace<Wire>(e, Entity{}, Entity{}, Entity{}, std::move(points));
+        return e;
+    };
+    std::vector<GridCoord> row, column;
+    for (std::int32_t i = 0; i <= 10; ++i) {
+        row.push_back({i, 30});
+        column.push_back({5, 25 + i});
+    }
+    const Entity across = wire(row);
+    const Entity down = wire(column);
+    const Entity along = wire({{0, 30}, {1, 30}, {2, 30}}); // on top of `across`
+    LayoutSystem layout(world, grid);
+
+    ASSERT(layout.module_at({5, 5}) == a);
+    ASSERT(!layout.module_at({20, 8}).valid()); // padding only
+    ASSERT(layout.port_at({20, 8}) == a_out);
+    ASSERT(!layout.port_at({5, 5}).valid());
+
+    ASSERT_EQ(layout.wires_at({5, 30}).size(), std::size_t{2});
+    ASSERT_EQ(layout.wires_at({1, 30}).size(), std::size_t{2}); // overlapping
+    std::uint8_t links[2] = {};
+    layout.for_each_occupant({5, 30}, [&](const LayoutSystem::Occupant& o) {
+        if (o.layer == LayoutSystem::Layer::Wire)
+            links[o.entity == down] |= o.links;
+    });
+    ASSERT_EQ(links[0], std::uint8_t{LayoutSystem::k_link_left | LayoutSystem::k_link_right});
+    ASSERT_EQ(links[1], std::uint8_t{LayoutSystem::k_link_up | LayoutSystem::k_link_down});
+
+    ASSERT_EQ(layout.entities_in({{-10, -10}, {50, 20}}, LayoutSystem::Layer::Module).size(), std::size_t{2});
+    ASSERT_EQ(layout.entities_in({{-10, -10}, {50, 20}}, LayoutSystem::Layer::Port).size(), std::size_t{6});
+    ASSERT_EQ(layout.entities_in({{0, 29}, {3, 31}}, LayoutSystem::Layer::Wire).size(), std::size_t{2});
+    ASSERT(layout.entities_in({{100, 100}, {200, 200}}, LayoutSystem::Layer::Wire).empty());
+
+    // Taking `across` out leaves the wires it overlapped.
+    layout.unindex_entity(across);
+    ASSERT(layout.wires_at({5, 30}) == std::vector<Entity>{down});
+    ASSERT(layout.wires_at({1, 30}) == std::vector<Entity>{along});
+    ASSERT(layout.is_cell_blocked({1, 30}));
+    ASSERT(!layout.is_cell_blocked({8, 30}));
+    return true;
+}
+
+TEST(layout_rebuild_picks_up_replaced_world) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    add_gate(world, {0, 0}, unit);
+    LayoutSystem layout(world, grid);
+
+    World loaded;
+    const Entity out = add_gate(loaded, {100, 100}, unit);
+    world = std::move(loaded); // as File > Open does
+    layout.rebuild_spatial_index();
+
+    ASSERT(!layout.module_at({5, 5}).valid());
+    ASSERT(layout.module_at({105, 105}) == world.get<Port>(out)->owner);
+    // Moving a module walks its ports through related<&Port::owner>.
+    world.get<PortGridPosition>(out)->position = {200 + 20, 100 + 8};
+    layout.update_module_from_anchor(out, world.get<Port>(out)->owner);
+    ASSERT(layout.port_at({220, 108}) == out);
+    return true;
+}
+
+TEST(layout_handles_modules_far_apart) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    const Entity near = add_gate(world, {0, 0}, unit);
+    const Entity far = add_gate(world, {1'000'000, 1'000'000}, unit);
+    LayoutSystem layout(world, grid);
+    const auto snapshot = layout.occupancy_snapshot();
+    ASSERT(snapshot->tile_count() <= 8);
+
+    // Drag the far gate further out while the snapshot is held.
+    world.get<PortGridPosition>(far)->position = {-1'000'000 + 20, 1'000'000 + 8};
+    layout.update_module_from_anchor(far, world.get<Port>(far)->owner);
+    ASSERT(layout.is_cell_blocked({-1'000'000 + 5, 1'000'000 + 5}));
+    ASSERT(!layout.is_cell_blocked({1'000'000 + 5, 1'000'000 + 5}));
+    ASSERT(snapshot->test({1'000'000 + 5, 1'000'000 + 5}));
+    ASSERT(layout.occupancy_snapshot()->tile_count() <= 8);
+
+    const GridCoord start = world.get<PortGridPosition>(near)->position;
+    ASSERT_EQ(orthogonal_path_cost(layout.route_wire(start, {start.x + 10, start.y})), 10);
+    return true;
+}
+
+TEST(layout_hierarchical_route_is_valid) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    std::vector<Entity> outputs;
+    for (int i = 0; i < 144; ++i)
+        outputs.push_back(add_gate(world, {(i % 12) * 32, (i / 12) * 24}, unit));
+    LayoutSystem layout(world, grid);
+
+    const GridCoord start = world.get<PortGridPosition>(outputs[0])->position;
+    const GridCoord end = world.get<PortGridPosition>(outputs.back())->position;
+    PathSearchStats stats;
+    const auto path = layout.route_wire_hierarchical(start, end, &stats);
+    ASSERT(!path.empty());
+    ASSERT(path.front() == start && path.back() == end);
+    std::unordered_set<GridCoord> visited{start};
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        ASSERT_EQ(std::abs(path[i].x - path[i - 1].x) + std::abs(path[i].y - path[i - 1].y), 1);
+        ASSERT(path[i] == end || !layout.is_cell_blocked(path[i]));
+        ASSERT(visited.insert(path[i]).second);
+    }
+
+    // Same endpoints routed in one go cost no less than the minimum.
+    const auto direct = layout.route_wire(start, end);
+    ASSERT(orthogonal_path_cost(path) >= orthogonal_path_cost(direct));
+    return true;
+}
+
+TEST(route_field_matches_router_costs) {
+    std::mt19937 rng(55);
+    OrthogonalRouter router;
+    RouteField field;
+    for (int round = 0; round < 20; ++round) {
+        const TestGrid grid = random_grid(32, 0.25, rng);
+        auto blocked = [&](GridCoord p) { return grid.blocked(p); };
+        std::uniform_int_distribution<int> coord(0, grid.size - 1);
+        const GridCoord start{coord(rng), coord(rng)};
+        if (grid.blocked(start))
+            continue;
+        field.reset(start);
+        for (int query = 0; query < 30; ++query) {
+            const GridCoord end{coord(rng), coord(rng)};
+            const auto expected = router.find_path(start, end, blocked);
+            const auto path = field.path_to(end, blocked);
+            ASSERT_EQ(path.empty(), expected.empty());
+            if (expected.empty())
+                continue;
+            ASSERT(end == start || valid_path(path, grid, start, end));
+            ASSERT_EQ(orthogonal_path_cost(path), orthogonal_path_cost(expected));
+
+            PathSearchStats again;
+            ASSERT(field.path_to(end, blocked, &again) == path);
+            ASSERT_EQ(again.expanded, std::size_t{0});
+        }
+    }
+    return true;
+}
+
+TEST(layout_preview_route_follows_index_changes) {
+    constexpr int unit = 10;
+    World world;
+    graphics::Grid grid(unit);
+    add_gate(world, {0, 0}, unit);
+    LayoutSystem layout(world, grid);
+
+    const GridCoord start{20, 8};
+    const auto before = layout.preview_route(start, {60, 8});
+    ASSERT_EQ(orthogonal_path_cost(before), 40);
+
+    // A vertical wire across the straight route, then a rebuild.
+    std::vector<GridCoord> points;
+    for (int y = -20; y <= 40; ++y)
+        points.push_back({40, y});
+    world.emplace<Wire>(world.create(), Entity{}, Entity{}, Entity{}, std::move(points));
+    layout.rebuild_spatial_index();
+
+    const auto after = layout.preview_route(start, {60, 8});
+    ASSERT_EQ(orthogonal_path_cost(after), orthogonal_path_cost(layout.route_wire(start, {60, 8})));
+    ASSERT(std::ranges::none_of(after, [](GridCoord p) { return p.x == 40 && p.y >= -20 && p.y <= 40; }));
+    return true;
+}
+
+TEST(preview_router_serves_latest_request) {
+    auto obstacles = std::make_shared<OccupancyBitmap>();
+    for (int i = -2; i <= 2; ++i) {
+        obstacles->set({100 + i, 98});
+        obstacles->set({100 + i, 102});
+        obstacles->set({98, 100 + i});
+        obstacles->set({102, 100 + i});
+    }
+    for (int y = -5; y <= 5; ++y)
+        obstacles->set({20, y});
+
+    PreviewRouter preview;
+    ASSERT(!preview.latest());
+    preview.request({0, 0}, {100, 100}, obstacles, 1); // sealed off
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // let the worker get into it
+    ASSERT(!preview.latest()); // still searching
+    for (int x = 1; x <= 40; ++x)
+        preview.request({0, 0}, {x, 0}, obstacles, 1);
+    preview.wait_idle();
+
+    const auto result = preview.latest();
+    ASSERT(result.has_value());
+    ASSERT(result->end == (GridCoord{40, 0}));
+    ASSERT_EQ(result->version, std::uint64_t{1});
+    OrthogonalRouter router;
+    ASSERT_EQ(orthogonal_path_cost(result->path),
+              orthogonal_path_cost(router.find_path({0, 0}, {40, 0}, *obstacles)));
+    // Run to its limit, the sealed-off search alone would expand
+    // RouteField::k_max_expanded states.
+    ASSERT(preview.stats().expanded < RouteField::k_max_expanded / 2);
+    return true;
+}
+
+TEST(weighted_path_avoids_costly_cells) {
+    // Two lanes from (0,0) to (20,0) around a block: over y = 3 or under
+    // y = -3, equally long.
+    auto block = [](GridCoord p) { return p.x >= 2 && p.x <= 18 && std::abs(p.y) <= 2; };
+    OrthogonalRouter router;
+    const auto plain = router.find_path({0, 0}, {20, 0}, block);
+    const int over = plain[plain.size() / 2].y > 0 ? 1 : -1;
+    auto toll = [&](GridCoord, GridCoord to, bool) { return to.y * over > 0 ? 5 : 0; };
+    const auto weighted = router.find_weighted_path({0, 0}, {20, 0}, block, toll);
+    ASSERT_EQ(orthogonal_path_cost(weighted), orthogonal_path_cost(plain));
+    ASSERT(std::ranges::none_of(weighted, [&](GridCoord p) { return p.y * over > 0; }));
+    return true;
+}
+
+TEST(autoroute_negotiates_shared_edges) {
+    // Two 40-cell walls with a one-cell channel between them at y = 11. Net
+    // 1 runs along the channel's row; net 2 saves a little by running
+    // through it too, but its detour around the walls is cheaper than net
+    // 1's, so net 2 has to give way (crossing net 1 is fine).
+    auto build = [](World& world) {
+        constexpr float unit = 10.0f;
+        for (const float y : {0.0f, 13.0f}) {
+            const Entity wall = world.create();
+            world.emplace<ModuleInst>(wall, Symbol{}, Entity{});
+            world.emplace<ModuleExtent>(wall, 40, 10);
+            world.emplace<ModulePixelPosition>(wall, 0.0f, y * unit);
+        }
+        auto pin = [&](GridCoord p) {
+            const Entity port = world.create();
+            world.emplace<Port>(port, Symbol{}, PortDirection::In, 1u, Entity{}, Entity{});
+            world.emplace<PortGridPosition>(port, p);
+            return port;
+        };
+        add_net(world, {pin({-5, 11}), pin({45, 11})});
+        add_net(world, {pin({-4, 5}), pin({44, 17})});
+    };
+
+    AutorouteReport reports[2];
+    std::vector<std::vector<GridCoord>> wires[2];
+    const std::size_t threads[2] = {1, 4};
+    for (int run = 0; run < 2; ++run) {
+        World world;
+        graphics::Grid grid(10);
+        build(world);
+        LayoutSystem layout(world, grid);
+        ThreadPool pool(threads[run]);
+        reports[run] = autoroute(world, layout, pool);
+        world.view<Wire>().each([&](Entity, const Wire& wire) { wires[run].push_back(wire.points); });
+
+        ASSERT_EQ(reports[run].nets, std::size_t{2});
+        ASSERT_EQ(reports[run].routed_nets, std::size_t{2});
+        ASSERT_EQ(reports[run].wires, std::size_t{2});
+        ASSERT_EQ(reports[run].overflow_cells, std::size_t{0});
+        ASSERT(reports[run].iterations > 1);
+        // Wires may cross, but never run along the same edge (keyed by its
+        // lower-left cell).
+        std::unordered_set<GridCoord> edges[2]; // horizontal, vertical
+        std::int64_t length = 0;
+        for (const auto& points : wires[run]) {
+            length += static_cast<std::int64_t>(points.size()) - 1;
+            for (std::size_t i = 1; i < points.size(); ++i) {
+                const GridCoord a = points[i - 1], b = points[i];
+                const GridCoord low{std::min(a.x, b.x), std::min(a.y, b.y)};
+                ASSERT(edges[a.x == b.x].insert(low).second);
+            }
+        }
+        ASSERT_EQ(reports[run].wirelength, length);
+        for (const auto& points : wires[run]) {
+            const bool in_channel = std::ranges::find(points, GridCoord{20, 11}) != points.end();
+            ASSERT_EQ(in_channel, points.front() == (GridCoord{-5, 11})); // net 1 kept it
+        }
+        // The new wires are obstacles now.
+        ASSERT(layout.is_cell_blocked({20, 11}));
+    }
+    ASSERT(wires[0] == wires[1]);
+    ASSERT_EQ(reports[0].bends, reports[1].bends);
+    return true;
+}
@@ -3,6 +3,8 @@
 #include <components/components.hpp>
 #include <systems/simulation.hpp>
 
+#include <thread>
+
 using namespace netra;
 
 namespace {
@@ -21,16 +23,16 @@ TestGate create_two_input_gate(World& world, const std::string& gate_name) {
     TestGate g;
     
     g.def = world.create();
-    world.emplace<ModuleDef>(g.def, gate_name, true);
+    world.emplace<ModuleDef>(g.def, world.intern(gate_name), true);
     
     g.inst = world.create();
-    world.emplace<ModuleInst>(g.inst, "u1", g.def);
+    world.emplace<ModuleInst>(g.inst, world.intern("u1"), g.def);
     
     // Input A
     Entity port_a = world.create();
-    world.emplace<Port>(port_a, "A", PortDirection::In, 1u, g.inst, Entity{});
+    world.emplace<Port>(port_a, world.intern("A"), PortDirection::In, 1u, g.inst, Entity{});
     Entity sig_a = world.create();
-    world.emplace<Signal>(sig_a, "sig_a", 1u, Entity{}, std::vector<Entity>{port_a});
+    world.emplace<Signal>(sig_a, world.intern("sig_a"), 1u, Entity{}, std::vector<Entity>{port_a});
     world.emplace<BitValue>(sig_a, 1u);
     world.get<Port>(port_a)->connected_signal = sig_a;
     g.input_ports.push_back(port_a);
@@ -38,9 +40,9 @@ TestGate create_two_input_gate(World& world, const std::string& gate_name) {
     
     // Input B
     Entity port_b = world.create();
-    world.emplace<Port>(port_b, "B", PortDirection::In, 1u, g.inst, Entity{});
+    world.emplace<Port>(port_b, world.intern("B"), PortDirection::In, 1u, g.inst, Entity{});
     Entity sig_b = world.create();
-    world.emplace<Signal>(sig_b, "sig_b", 1u, Entity{}, std::vector<Entity>{port_b});
+    world.emplace<Signal>(sig_b, world.intern("sig_b"), 1u, Entity{}, std::vector<Entity>{port_b});
     world.emplace<BitValue>(sig_b, 1u);
     world.get<Port>(port_b)->connected_signal = sig_b;
     g.input_ports.push_back(port_b);
@@ -48,9 +50,9 @@ TestGate create_two_input_gate(World& world, const std::string& gate_name) {
     
     // Output Y
     g.output_port = world.create();
-    world.emplace<Port>(g.output_port, "Y", PortDirection::Out, 1u, g.inst, Entity{});
+    world.emplace<Port>(g.output_port, world.intern("Y"), PortDirection::Out, 1u, g.inst, Entity{});
     g.output_signal = world.create();
-    world.emplace<Signal>(g.output_signal, "sig_y", 1u, Entity{}, std::vector<Entity>{g.output_port});
+    world.emplace<Signal>(g.output_signal, world.intern("sig_y"), 1u, Entity{}, std::vector<Entity>{g.output_port});
     world.get<Port>(g.output_port)->connected_signal = g.output_signal;
     
     return g;
@@ -176,22 +178,22 @@ TEST(simulation_not_gate) {
     World world;
     
     Entity def = world.create();
-    world.emplace<ModuleDef>(def, "NOT", true);
+    world.emplace<ModuleDef>(def, world.intern("NOT"), true);
     
     Entity inst = world.create();
-    world.emplace<ModuleInst>(inst, "inv1", def);
+    world.emplace<ModuleInst>(inst, world.intern("inv1"), def);
     
     Entity port_a = world.create();
-    world.emplace<Port>(port_a, "A", PortDirection::In, 1u, inst, Entity{});
+    world.emplace<Port>(port_a, world.intern("A"), PortDirection::In, 1u, inst, Entity{});
     Entity sig_a = world.create();
-    world.emplace<Signal>(sig_a, "sig_a", 1u, Entity{}, std::vector<Entity>{port_a});
+    world.emplace<Signal>(sig_a, world.intern("sig_a"), 1u, Entity{}, std::vector<Entity>{port_a});
     world.emplace<BitValue>(sig_a, 1u);
     world.get<Port>(port_a)->connected_signal = sig_a;
     
     Entity port_y = world.create();
-    world.emplace<Port>(port_y, "Y", PortDirection::Out, 1u, inst, Entity{});
+    world.emplace<Port>(port_y, world.intern("Y"), PortDirection::Out, 1u, inst, Entity{});
     Entity sig_y = world.create();
-    world.emplace<Signal>(sig_y, "sig_y", 1u, Entity{}, std::vector<Entity>{port_y});
+    world.emplace<Signal>(sig_y, world.intern("sig_y"), 1u, Entity{}, std::vector<Entity>{port_y});
     world.get<Port>(port_y)->connected_signal = sig_y;
     
     Simulation sim(world);
@@ -207,3 +209,88 @@ TEST(simulation_not_gate) {
     
     return true;
 }
+
+TEST(simulation_on_forked_world_is_isolated) {
+    World world;
+    auto gate = create_two_input_gate(world, "AND");
+    set_inputs(world, gate, true, false);
+
+    World fork = world.clone();
+    set_inputs(fork, gate, true, true);
+
+    std::thread fork_thread([&fork] {
+        Simulation sim(fork);
+        primitives::register_basic_gates(sim);
+        sim.step();
+    });
+    Simulation sim(world);
+    primitives::register_basic_gates(sim);
+    sim.step();
+    fork_thread.join();
+
+    ASSERT_EQ(get_output(world, gate), false);
+    ASSERT_EQ(get_output(fork, gate), true);
+
+    // Structural edits on the fork stay on the fork.
+    fork.destroy(gate.inst);
+    ASSERT(world.alive(gate.inst));
+    ASSERT_EQ(world.related<&Port::owner>(gate.inst).size(), 3u);
+    ASSERT_EQ(fork.entity_count() + 1, world.entity_count());
+
+    return true;
+}
+
+TEST(simulation_dispatches_cached_opcode) {
+    World world;
+    auto gate = create_two_input_gate(world, "AND");
+    set_inputs(world, gate, true, false);
+
+    Simulation sim(world);
+    primitives::register_basic_gates(sim);
+    sim.step();
+    ASSERT_EQ(get_output(world, gate), false);
+    ASSERT(world.get<PrimitiveOp>(gate.def)->type == GateType::AND);
+
+    world.get<ModuleDef>(gate.def)->name = world.intern("OR");
+    sim.step();
+    ASSERT_EQ(get_output(world, gate), true);
+    ASSERT(world.get<PrimitiveOp>(gate.def)->type == GateType::OR);
+
+    sim.register_primitive("OR", [](const std::vector<BitValue>&, std::vector<BitValue>& out) {
+        out[0] = BitValue(1);
+    });
+    sim.step();
+    ASSERT_EQ(get_output(world, gate), false);
+    return true;
+}
+
+TEST(gate_names_round_trip) {
+    for (std::size_t g = 0; g < static_cast<std::size_t>(GateType::INVALID); ++g) {
+        const auto type = static_cast<GateType>(g);
+        ASSERT(gate_type_of(gate_name(type)) == type);
+    }
+    ASSERT(gate_name(GateType::NAND) == "NAND");
+    ASSERT(gate_type_of("and") == GateType::INVALID);
+    return true;
+}
+
+TEST(simulation_folds_wide_gates) {
+    World world;
+    auto gate = create_two_input_gate(world, "AND");
+    Entity port_c = world.create();
+    Entity sig_c = world.create();
+    world.emplace<Port>(port_c, world.intern("C"), PortDirection::In, 1u, gate.inst, sig_c);
+    world.emplace<Signal>(sig_c, world.intern("sig_c"), 1u, Entity{}, std::vector<Entity>{port_c});
+    world.emplace<BitValue>(sig_c, 1u);
+
+    Simulation sim(world);
+    primitives::register_basic_gates(sim);
+    set_inputs(world, gate, true, true);
+    sim.step();
+    ASSERT_EQ(get_output(world, gate), false);
+
+    world.get<BitValue>(sig_c)->set_bit(0, true);
+    sim.step();
+    ASSERT_EQ(get_output(world, gate), true);
+    return true;
+}